@@ -27,128 +27,211 @@
 #include "CVariant.h"
 #include "COrientedVariant.h"
 #include "CUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "CTaskScheduler.h"
+
+EVariantMatch CBaseVariantProvider::MergeVariantStatus(EVariantMatch a_currentStatus, EVariantMatch a_status)
+{
+    if(a_currentStatus == eCOMPLEX_SKIPPED)
+        return a_currentStatus;
+    
+    if(a_status == eGENOTYPE_MATCH)
+        return a_status;
+    else if(a_status == eALLELE_MATCH && a_currentStatus != eGENOTYPE_MATCH)
+        return a_status;
+    else if(a_status == eNO_MATCH && a_currentStatus == eNOT_ASSESSED)
+        return a_status;
+    else
+        return a_currentStatus;
+}
 
 void CBaseVariantProvider::SetVariantStatus(const std::vector<const CVariant*>& a_rVariantList, EVariantMatch a_status) const
 {
     for(const CVariant* pVar : a_rVariantList)
-    {
-        if(pVar->m_variantStatus == eCOMPLEX_SKIPPED)
-            continue;
-        
-        if(a_status == eGENOTYPE_MATCH)
-            pVar->m_variantStatus = a_status;
-        else if(a_status == eALLELE_MATCH && pVar->m_variantStatus != eGENOTYPE_MATCH)
-            pVar->m_variantStatus = a_status;
-        else if(a_status == eNO_MATCH && pVar-> m_variantStatus == eNOT_ASSESSED)
-            pVar->m_variantStatus = a_status;
-        else
-            continue;
-    }
+        pVar->m_variantStatus = MergeVariantStatus(pVar->m_variantStatus, a_status);
 }
 
 void CBaseVariantProvider::SetVariantStatus(const std::vector<const core::COrientedVariant*>& a_rVariantList, EVariantMatch a_status) const
 {
     for(const core::COrientedVariant* pOVar : a_rVariantList)
+        pOVar->GetVariant().m_variantStatus = MergeVariantStatus(pOVar->GetVariant().m_variantStatus, a_status);
+}
+
+bool CBaseVariantProvider::ReadContig(std::string a_chrId, SContig& a_rContig)
+{
+    return m_referenceFasta.FetchNewChromosome(a_chrId, a_rContig);
+}
+
+void CBaseVariantProvider::PrefetchContigs(const std::vector<std::string>& a_rChrNames, int a_nWindowSizeMB) const
+{
+    if(a_nWindowSizeMB <= 0)
+        return;
+    
+    long long windowSize = static_cast<long long>(a_nWindowSizeMB) * 1024 * 1024;
+    long long requestedSize = 0;
+    std::vector<const std::string*> requestedNames;
+    
+    for(unsigned int k = 0; k < a_rChrNames.size(); k++)
     {
-        if(pOVar->GetVariant().m_variantStatus == eCOMPLEX_SKIPPED)
+        //A chromosome may appear several times in the queue (eg. both comparisons of a trio)
+        bool bIsRequested = false;
+        for(const std::string* pName : requestedNames)
+            bIsRequested = bIsRequested || *pName == a_rChrNames[k];
+        if(bIsRequested)
             continue;
         
-        if(a_status == eGENOTYPE_MATCH)
-            pOVar->GetVariant().m_variantStatus = a_status;
-        else if(a_status == eALLELE_MATCH && pOVar->GetVariant().m_variantStatus != eGENOTYPE_MATCH)
-            pOVar->GetVariant().m_variantStatus = a_status;
-        else if(a_status == eNO_MATCH && pOVar->GetVariant().m_variantStatus == eNOT_ASSESSED)
-            pOVar->GetVariant().m_variantStatus = a_status;
-        else
+        int contigLength = m_referenceFasta.GetCachedContigLength(a_rChrNames[k]);
+        
+        //Contig is not in the reference cache (or cache is not available). It will be read on demand
+        if(contigLength < 0)
             continue;
+        
+        //Current contig is always prefetched, the upcoming ones only if they fit into the window
+        if(k > 0 && requestedSize + contigLength > windowSize)
+            break;
+        
+        m_referenceFasta.PrefetchChromosome(a_rChrNames[k]);
+        requestedNames.push_back(&a_rChrNames[k]);
+        requestedSize += contigLength;
     }
 }
 
-bool CBaseVariantProvider::ReadContig(std::string a_chrId, SContig& a_rContig)
+
+void CBaseVariantProvider::FillVariantOrders(const std::vector<std::vector<CVariant>>& a_rVariantLists,
+                                             std::vector<std::vector<unsigned int>>& a_rOrders,
+                                             bool (*a_pCompare)(const CVariant*, const CVariant*))
 {
-    return m_referenceFasta.FetchNewChromosome(a_chrId, a_rContig);
+    a_rOrders = std::vector<std::vector<unsigned int>>(a_rVariantLists.size());
+    
+    for(unsigned int k = 0; k < a_rVariantLists.size(); k++)
+    {
+        const std::vector<CVariant>& variants = a_rVariantLists[k];
+        std::vector<unsigned int>& order = a_rOrders[k];
+        
+        order.resize(variants.size());
+        for(unsigned int m = 0; m < order.size(); m++)
+            order[m] = m;
+        
+        //Variant lists are sorted by position so the order is mostly the identity. Sort only if it is not
+        auto compareIndexes = [&](unsigned int a_nLeft, unsigned int a_nRight){ return a_pCompare(&variants[a_nLeft], &variants[a_nRight]); };
+        if(!std::is_sorted(order.begin(), order.end(), compareIndexes))
+            std::sort(order.begin(), order.end(), compareIndexes);
+    }
 }
 
-
 void CBaseVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVariantList, std::vector<std::vector<CVariant>>* a_pAllVarList, const SConfig& a_rConfig)
 {
     if(a_rVariantList.size() == 0)
         return;
     
+    std::chrono::steady_clock::time_point trimStart = std::chrono::steady_clock::now();
+    
+    //Variants are read in file order so each chromosome forms a contiguous run in the list
+    std::vector<std::pair<unsigned int, unsigned int>> chrRuns;
+    unsigned int runStart = 0;
+    for(unsigned int k = 1; k <= a_rVariantList.size(); k++)
+    {
+        if(k == a_rVariantList.size() || a_rVariantList[k].m_nChrId != a_rVariantList[runStart].m_nChrId)
+        {
+            chrRuns.push_back(std::make_pair(runStart, k));
+            runStart = k;
+        }
+    }
+    
+    //Each run only modifies its own variants and reads the variant list of its chromosome, so runs are processed in parallel
+    std::vector<double> runCosts;
+    for(const std::pair<unsigned int, unsigned int>& run : chrRuns)
+        runCosts.push_back(static_cast<double>(run.second - run.first));
+    
+    CTaskScheduler scheduler(runCosts, a_rConfig.m_nThreadCount);
+    
+    //Overlap index buffer of each worker
+    std::vector<std::vector<unsigned int>> overlapIndexes(scheduler.GetThreadCount());
+    scheduler.Run([&](int a_nRunIndex, int a_nWorkerId)
+    {
+        const std::vector<CVariant>& chrVarList = (*a_pAllVarList)[a_rVariantList[chrRuns[a_nRunIndex].first].m_nChrId];
+        FindOptimalTrimmingsOfChromosome(a_rVariantList, chrRuns[a_nRunIndex].first, chrRuns[a_nRunIndex].second, chrVarList, overlapIndexes[a_nWorkerId], a_rConfig);
+    });
+    
+    std::chrono::steady_clock::time_point trimEnd = std::chrono::steady_clock::now();
+    std::cerr << "Optimal trimming of " << a_rVariantList.size() << " variants completed in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(trimEnd - trimStart).count() << " ms" << std::endl;
+}
+
+void CBaseVariantProvider::FindOptimalTrimmingsOfChromosome(std::vector<CVariant>& a_rVariantList,
+                                                            unsigned int a_nBegin,
+                                                            unsigned int a_nEnd,
+                                                            const std::vector<CVariant>& a_rChrVarList,
+                                                            std::vector<unsigned int>& a_rOverlapIndexes,
+                                                            const SConfig& a_rConfig)
+{
+    //Sweep iterator of each allele over the (start sorted) variants of the chromosome
     unsigned int varItr[2];
     varItr[0] = 0;
     varItr[1] = 0;
     
-    int currentChrId = a_rVariantList[0].m_nChrId;
-    
-    for(unsigned int k = 0; k < a_rVariantList.size(); k++)
+    for(unsigned int k = a_nBegin; k < a_nEnd; k++)
     {
-        for(int i = 0; i < a_rVariantList[k].m_nZygotCount; i++)
+        CVariant& variant = a_rVariantList[k];
+        
+        for(int i = 0; i < variant.m_nZygotCount; i++)
         {
-            if(a_rVariantList[k].m_alleles[i].m_bIsIgnored || a_rVariantList[k].m_alleles[i].m_bIsTrimmed)
+            SAllele& allele = variant.m_alleles[i];
+            
+            if(allele.m_bIsIgnored || allele.m_bIsTrimmed)
                 continue;
             
             //The maximum possible trimming nucleotide count from start and end of each allele
             unsigned int canTrimStart, canTrimEnd;
-            a_rVariantList[k].GetMaxTrimStartEnd(i, canTrimStart, canTrimEnd);
+            variant.GetMaxTrimStartEnd(i, canTrimStart, canTrimEnd);
             
-            std::vector<CVariant> tmpoverlapVariants;
-            
-            if(currentChrId != a_rVariantList[k].m_nChrId)
-            {
-                varItr[0] = 0;
-                varItr[1] = 0;
-                currentChrId = a_rVariantList[k].m_nChrId;
-            }
-            
-            while(varItr[i] < (*a_pAllVarList)[currentChrId].size() && a_rVariantList[k].m_alleles[i].m_nStartPos > (*a_pAllVarList)[currentChrId][varItr[i]].m_nEndPos)
+            while(varItr[i] < a_rChrVarList.size() && allele.m_nStartPos > a_rChrVarList[varItr[i]].m_nEndPos)
                 varItr[i]++;
             
-            if(varItr[i] == (*a_pAllVarList)[currentChrId].size())
+            if(varItr[i] == a_rChrVarList.size())
                 continue;
             
-            unsigned int secondItr = varItr[i];
-            
-            while(secondItr < (*a_pAllVarList)[currentChrId].size() && a_rVariantList[k].m_alleles[i].m_nEndPos >= (*a_pAllVarList)[currentChrId][secondItr].m_nStartPos)
+            //Collect the indexes of overlapping variants (no variant copy is made)
+            a_rOverlapIndexes.clear();
+            for(unsigned int secondItr = varItr[i]; secondItr < a_rChrVarList.size() && allele.m_nEndPos >= a_rChrVarList[secondItr].m_nStartPos; secondItr++)
             {
-                if(CUtils::IsOverlap(a_rVariantList[k].m_alleles[i].m_nStartPos,
-                                     a_rVariantList[k].m_alleles[i].m_nEndPos,
-                                     (*a_pAllVarList)[currentChrId][secondItr].m_nStartPos,
-                                     (*a_pAllVarList)[currentChrId][secondItr].m_nEndPos))
-                    tmpoverlapVariants.push_back((*a_pAllVarList)[currentChrId][secondItr]);
-                secondItr++;
+                if(CUtils::IsOverlap(allele.m_nStartPos, allele.m_nEndPos, a_rChrVarList[secondItr].m_nStartPos, a_rChrVarList[secondItr].m_nEndPos))
+                    a_rOverlapIndexes.push_back(secondItr);
             }
             
             //Trim variants as standard if there is no overlap
-            if(tmpoverlapVariants.size() == 0)
-                a_rVariantList[k].TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
+            if(a_rOverlapIndexes.size() == 0)
+                variant.TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
             
             else
             {
-                for(unsigned int ovarItr = 0; ovarItr < tmpoverlapVariants.size(); ovarItr++)
+                for(unsigned int overlapIndex : a_rOverlapIndexes)
                 {
+                    const CVariant& overlapVariant = a_rChrVarList[overlapIndex];
+                    
                     //Check each allele of overlapping variant
-                    for(int tmpItr = 0; tmpItr < tmpoverlapVariants[ovarItr].m_nZygotCount; tmpItr++)
+                    for(int tmpItr = 0; tmpItr < overlapVariant.m_nZygotCount; tmpItr++)
                     {
+                        const SAllele& overlapAllele = overlapVariant.m_alleles[tmpItr];
+                        
                         //If the allele does not overlap, continue
-                        if(!CUtils::IsOverlap(a_rVariantList[k].m_alleles[i].m_nStartPos,
-                                              a_rVariantList[k].m_alleles[i].m_nEndPos,
-                                              tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nStartPos,
-                                              tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nEndPos))
+                        if(!CUtils::IsOverlap(allele.m_nStartPos, allele.m_nEndPos, overlapAllele.m_nStartPos, overlapAllele.m_nEndPos))
                             continue;
                         
-                        unsigned int overlapStart = std::max(a_rVariantList[k].m_alleles[i].m_nStartPos, tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nStartPos);
-                        unsigned int overlapEnd = std::min(a_rVariantList[k].m_alleles[i].m_nEndPos, tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nEndPos);
+                        unsigned int overlapStart = std::max(allele.m_nStartPos, overlapAllele.m_nStartPos);
+                        unsigned int overlapEnd = std::min(allele.m_nEndPos, overlapAllele.m_nEndPos);
                         
                         //Trim from beginning
-                        if(a_rVariantList[k].m_alleles[i].m_nStartPos == (int)overlapStart)
+                        if(allele.m_nStartPos == (int)overlapStart)
                         {
-                            if(a_rVariantList[k].m_alleles[i].m_nStartPos + (int)canTrimStart >= tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nEndPos)
+                            if(allele.m_nStartPos + (int)canTrimStart >= overlapAllele.m_nEndPos)
                             {
-                                int toClip = overlapEnd - a_rVariantList[k].m_alleles[i].m_nStartPos;
+                                int toClip = overlapEnd - allele.m_nStartPos;
                                 if(toClip > 0 && toClip <= (int)canTrimStart)
                                 {
-                                    a_rVariantList[k].TrimVariant(i, toClip, 0);
+                                    variant.TrimVariant(i, toClip, 0);
                                     canTrimStart -= toClip;
                                     continue;
                                 }
@@ -156,27 +239,27 @@ void CBaseVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVarian
                         }
                         
                         //Trim from beginning or end --
-                        else if(a_rVariantList[k].m_alleles[i].m_nEndPos > (int) overlapEnd)
+                        else if(allele.m_nEndPos > (int) overlapEnd)
                         {
                             //Try to trim from end
-                            if(a_rVariantList[k].m_alleles[i].m_nEndPos - (int)canTrimEnd <= tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nStartPos)
+                            if(allele.m_nEndPos - (int)canTrimEnd <= overlapAllele.m_nStartPos)
                             {
-                                int toClip = a_rVariantList[k].m_alleles[i].m_nEndPos - overlapStart;
+                                int toClip = allele.m_nEndPos - overlapStart;
                                 if(toClip > 0 && toClip <= (int)canTrimEnd)
                                 {
-                                    a_rVariantList[k].TrimVariant(i, 0, toClip);
+                                    variant.TrimVariant(i, 0, toClip);
                                     canTrimEnd -= toClip;
                                     continue;
                                 }
                             }
                             
                             //Try to trim from front
-                            if(a_rVariantList[k].m_alleles[i].m_nStartPos + (int)canTrimStart >= tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nEndPos)
+                            if(allele.m_nStartPos + (int)canTrimStart >= overlapAllele.m_nEndPos)
                             {
-                                int toClip = overlapEnd - a_rVariantList[k].m_alleles[i].m_nStartPos;
+                                int toClip = overlapEnd - allele.m_nStartPos;
                                 if(toClip > 0 && toClip <= (int)canTrimStart)
                                 {
-                                    a_rVariantList[k].TrimVariant(i, toClip, 0);
+                                    variant.TrimVariant(i, toClip, 0);
                                     canTrimStart -= toClip;
                                     continue;
                                 }
@@ -187,12 +270,12 @@ void CBaseVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVarian
                         //Trim from end
                         else
                         {
-                            if(a_rVariantList[k].m_alleles[i].m_nEndPos - (int)canTrimEnd < tmpoverlapVariants[ovarItr].m_alleles[tmpItr].m_nStartPos)
+                            if(allele.m_nEndPos - (int)canTrimEnd < overlapAllele.m_nStartPos)
                             {
-                                int toClip = a_rVariantList[k].m_alleles[i].m_nEndPos - overlapStart;
+                                int toClip = allele.m_nEndPos - overlapStart;
                                 if(toClip > 0 && toClip <= (int)canTrimEnd)
                                 {
-                                    a_rVariantList[k].TrimVariant(i, 0, toClip);
+                                    variant.TrimVariant(i, 0, toClip);
                                     canTrimEnd -= toClip;
                                     continue;
                                 }
@@ -201,10 +284,10 @@ void CBaseVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVarian
                     }
                 }
                 
-                if(!a_rVariantList[k].m_alleles[i].m_bIsTrimmed)
-                    a_rVariantList[k].TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
+                if(!allele.m_bIsTrimmed)
+                    variant.TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
                 else
-                    a_rVariantList[k].TrimVariant(i, canTrimStart, canTrimEnd);
+                    variant.TrimVariant(i, canTrimStart, canTrimEnd);
             }
         }
         
@@ -213,17 +296,17 @@ void CBaseVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVarian
         int minStart = INT_MAX;
         int maxEnd = -1;
         
-        for(int i =0; i < a_rVariantList[k].m_nAlleleCount; i++)
+        for(int i =0; i < variant.m_nAlleleCount; i++)
         {
-            if(!a_rVariantList[k].m_alleles[i].m_bIsIgnored)
+            if(!variant.m_alleles[i].m_bIsIgnored)
             {
-                maxEnd = std::max(maxEnd, static_cast<int>(a_rVariantList[k].m_alleles[i].m_nEndPos));
-                minStart = std::min(minStart, static_cast<int>(a_rVariantList[k].m_alleles[i].m_nStartPos));
+                maxEnd = std::max(maxEnd, static_cast<int>(variant.m_alleles[i].m_nEndPos));
+                minStart = std::min(minStart, static_cast<int>(variant.m_alleles[i].m_nStartPos));
             }
         }
         
-        a_rVariantList[k].m_nEndPos = maxEnd == -1 ? a_rVariantList[k].m_nOriginalPos : maxEnd;
-        a_rVariantList[k].m_nStartPos = minStart == INT_MAX ? a_rVariantList[k].m_nOriginalPos : minStart;
+        variant.m_nEndPos = maxEnd == -1 ? variant.m_nOriginalPos : maxEnd;
+        variant.m_nStartPos = minStart == INT_MAX ? variant.m_nOriginalPos : minStart;
         
     }
     
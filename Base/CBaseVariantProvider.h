@@ -43,6 +43,9 @@ class CBaseVariantProvider
     
 public:
     
+    ///Return the status after a_status is assigned to a variant with a_currentStatus (Genotype match > Allele match > No match. Skipped variants keep their status)
+    static EVariantMatch MergeVariantStatus(EVariantMatch a_currentStatus, EVariantMatch a_status);
+    
     ///Set the status of each variant in the given list
     void SetVariantStatus(const std::vector<const CVariant*>& a_rVariantList, EVariantMatch a_status) const;
     
@@ -52,11 +55,28 @@ public:
     ///Read contig given by the chromosome id
     bool ReadContig(std::string a_chrId, SContig& a_rContig);
     
+    ///Prefetch the reference of the first contig and the following ones while their total size fits into the prefetch window.
+    ///The window bounds a single call (one task); repeated names are counted once
+    void PrefetchContigs(const std::vector<std::string>& a_rChrNames, int a_nWindowSizeMB) const;
+    
 protected:
 
+    ///Fill the order of the variants of each chromosome according to the comparator. a_rOrders[chromosome][k] is the index of k'th variant in the variant list
+    static void FillVariantOrders(const std::vector<std::vector<CVariant>>& a_rVariantLists,
+                                  std::vector<std::vector<unsigned int>>& a_rOrders,
+                                  bool (*a_pCompare)(const CVariant*, const CVariant*));
+    
     ///Find the optimal Trimming for variant list that have more than 1 trimming options. (See Readme under 'core' folder)
     void FindOptimalTrimmings(std::vector<CVariant>& a_rVariantList, std::vector<std::vector<CVariant>>* a_pAllVarList, const SConfig& a_rConfig);
     
+    ///Find the optimal trimmings of variants in [a_nBegin, a_nEnd) which all belong to the chromosome of a_rChrVarList
+    void FindOptimalTrimmingsOfChromosome(std::vector<CVariant>& a_rVariantList,
+                                          unsigned int a_nBegin,
+                                          unsigned int a_nEnd,
+                                          const std::vector<CVariant>& a_rChrVarList,
+                                          std::vector<unsigned int>& a_rOverlapIndexes,
+                                          const SConfig& a_rConfig);
+    
     //REFERENCE FASTA
     CFastaParser m_referenceFasta;
 
@@ -28,9 +28,6 @@
 
 #include <string>
 
-//MAX NUMBER OF THREAD COUNT
-const int MAX_THREAD_COUNT = 25;
-
 //LEAST NUMBER OF VARIANT REQUIRED TO PROCESS THE CHROMOSOME
 const int LEAST_VARIANT_THRESHOLD = 2;
 
@@ -52,6 +49,12 @@ const int SMALL_VARIANT_SIZE = 5;
 //DEFAULT SIZE OF MEDIUM VARIANTS FOR MENDELIAN VIOLATION DETECTION
 const int MEDIUM_VARIANT_SIZE = 15;
 
+//DEFAULT SIZE OF THE REFERENCE PREFETCH WINDOW IN MB (Upcoming contigs of a thread are read ahead while the current one is processed)
+const int DEFAULT_PREFETCH_WINDOW_MB = 512;
+
+//DEFAULT BGZF COMPRESSION LEVEL OF THE COMPRESSED OUTPUTS (vcf.gz / bcf)
+const int DEFAULT_COMPRESSION_LEVEL = 6;
+
 //VBT VERSION AND YEAR TO BE COPIED OUTPUT VCFS
 const std::string VBT_VERSION = "v1.0 (2018)";
 
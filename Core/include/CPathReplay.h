@@ -57,6 +57,9 @@ class CPathReplay
         ///Sets maximum pathsize and maximum path iteration count
         void SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount);
     
+        ///Sets the status lists (indexed by variant id) where skipped variants are marked. If not set, the status of variant itself is updated
+        void SetStatusLists(std::vector<EVariantMatch>* a_pBaseStatusList, std::vector<EVariantMatch>* a_pCalledStatusList);
+    
         ///Clears variants belong to best path
         void Clear();
     
@@ -96,6 +99,9 @@ class CPathReplay
         ///Move the path to the specified position, ignoring any intervening variants. Returns the skipped variant count
         int SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_nMaxPos);
     
+        ///Marks the variant as complex skipped in the given status list (or at the variant if list is NULL)
+        void MarkComplexSkipped(const CVariant* a_pVariant, std::vector<EVariantMatch>* a_pStatusList) const;
+    
         ///Path list to store generated paths
         CPathSet m_pathList;
         
@@ -117,6 +123,10 @@ class CPathReplay
         std::vector<const COrientedVariant*>& m_aOrientedVariantListBase;
         std::vector<const COrientedVariant*>& m_aOrientedVariantListCalled;
     
+        //Status lists of base/called variants. Variants which are shared by concurrent replays should not be marked in place
+        std::vector<EVariantMatch>* m_pBaseStatusList;
+        std::vector<EVariantMatch>* m_pCalledStatusList;
+    
         ///Cutoff path size to fit in memory
         int m_nMaxPathSize;
         ///Cutoff iteration count without enqueing any variant to the pathlist
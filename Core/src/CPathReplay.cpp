@@ -44,6 +44,8 @@ CPathReplay::CPathReplay(std::vector<const CVariant*>& a_aVarListBase,
 {
     m_nMaxPathSize = DEFAULT_MAX_PATH_SIZE;
     m_nMaxIterationCount = DEFAULT_MAX_ITERATION_SIZE;
+    m_pBaseStatusList = NULL;
+    m_pCalledStatusList = NULL;
 }
 
 void CPathReplay::SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount)
@@ -52,6 +54,12 @@ void CPathReplay::SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIteration
     m_nMaxPathSize = a_nMaxPathSize;
 }
 
+void CPathReplay::SetStatusLists(std::vector<EVariantMatch>* a_pBaseStatusList, std::vector<EVariantMatch>* a_pCalledStatusList)
+{
+    m_pBaseStatusList = a_pBaseStatusList;
+    m_pCalledStatusList = a_pCalledStatusList;
+}
+
 
 CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
 {
@@ -389,7 +397,7 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     while(varIndex < (int)m_aVariantListBase.size() && (varIndex == -1  || m_aVariantListBase[varIndex]->GetStart() < a_nMaxPos))
     {
         if(a_rPath.m_baseSemiPath.GetIncludedVariantEndPosition() < m_aVariantListBase[(varIndex >= 0 ? varIndex : 0)]->m_nStartPos)
-           m_aVariantListBase[(varIndex >= 0 ? varIndex : 0)]->m_variantStatus = eCOMPLEX_SKIPPED;
+           MarkComplexSkipped(m_aVariantListBase[(varIndex >= 0 ? varIndex : 0)], m_pBaseStatusList);
         varIndex++;
         baseSkippedCount++;
     }
@@ -403,7 +411,7 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     while(varIndex < (int)m_aVariantListCalled.size() && (varIndex == -1  || m_aVariantListCalled[varIndex]->GetStart() < a_nMaxPos))
     {
         if(a_rPath.m_calledSemiPath.GetIncludedVariantEndPosition() < m_aVariantListCalled[(varIndex >= 0 ? varIndex : 0)]->m_nStartPos)
-            m_aVariantListCalled[(varIndex >= 0 ? varIndex : 0)]->m_variantStatus = eCOMPLEX_SKIPPED;
+            MarkComplexSkipped(m_aVariantListCalled[(varIndex >= 0 ? varIndex : 0)], m_pCalledStatusList);
         varIndex++;
         calledSkippedCount++;
     }
@@ -414,6 +422,14 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     return calledSkippedCount + baseSkippedCount;
 }
 
+void CPathReplay::MarkComplexSkipped(const CVariant* a_pVariant, std::vector<EVariantMatch>* a_pStatusList) const
+{
+    if(a_pStatusList != NULL)
+        (*a_pStatusList)[a_pVariant->m_nId] = eCOMPLEX_SKIPPED;
+    else
+        a_pVariant->m_variantStatus = eCOMPLEX_SKIPPED;
+}
+
 void CPathReplay::Clear()
 {
     m_pathList.Clear();
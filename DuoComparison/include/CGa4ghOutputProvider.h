@@ -58,6 +58,9 @@ public:
     ///Set the output vcf path
     void SetVcfPath(const std::string& a_rVcfPath);
     
+    ///Set the file format of the output vcf(s), compression level and number of compression threads
+    void SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount);
+    
     ///Set contigs [id, name and length] to write output header
     void SetContigList(const std::vector<SVcfContig>& a_rContigs);
     
@@ -72,11 +75,11 @@ private:
     //Fill the header of output vcf according to ga4gh standards
     void FillHeader();
     
-    //Add records of best path to the vcf file (Contain single chromosome)
-    void AddRecords(const core::CPath& a_rBestPath, SChrIdTuple a_rTuple);
+    //Serialize records of best path into the chunk (Contain single chromosome)
+    void AddRecords(const core::CPath& a_rBestPath, SChrIdTuple a_rTuple, SVcfChunk& a_rChunk);
 
     //Generate and two sample record with one of them is empty
-    void AddSingleSampleRecord(const SVariantSummary& a_rVariant, bool a_bIsBase);
+    void AddSingleSampleRecord(const SVariantSummary& a_rVariant, bool a_bIsBase, SVcfChunk& a_rChunk);
     
     //Return true if base and called variants can be merged
     bool CanMerge(const CVariant* a_pVariantBase, const CVariant* a_pVariantCalled) const;
@@ -118,6 +121,9 @@ private:
     //Contig id list to write output header
     std::vector<SVcfContig> m_contigs;
     
+    //Number of threads that serialize the chromosomes
+    int m_nThreadCount = 1;
+    
 };
 
 }
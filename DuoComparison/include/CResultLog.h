@@ -29,7 +29,7 @@
 #include <string>
 #include "Constants.h"
 #include <vector>
-#include "CSyncPoint.h"
+#include "CSyncIntervalFile.h"
 #include <fstream>
 
 namespace duocomparison
@@ -43,12 +43,12 @@ struct SLogEntry
     std::string m_chrName;
     int m_nBaseId;
     bool m_bIsNull = true;
-    int m_nTpCalled;
-    int m_nTpBase;
-    int m_nHalfTpCalled;
-    int m_nHalfTpBase;
-    int m_nFp;
-    int m_nFn;
+    int m_nTpCalled = 0;
+    int m_nTpBase = 0;
+    int m_nHalfTpCalled = 0;
+    int m_nHalfTpBase = 0;
+    int m_nFp = 0;
+    int m_nFn = 0;
 };
 
 /**
@@ -62,8 +62,12 @@ public:
     ///Sets the path of log file
     void SetLogPath(const std::string& a_rLogPath);
     
-    ///Records the result for given chromosome
-    void LogStatistic(const std::string& a_chromosomeName,
+    ///Allocates one entry per chromosome. Each chromosome is logged to its own entry so that threads do not need to lock
+    void SetChromosomeCount(int a_nChromosomeCount);
+    
+    ///Records the result for given chromosome to the entry of a_nChromosomeIndex
+    void LogStatistic(int a_nChromosomeIndex,
+                      const std::string& a_chromosomeName,
                       int a_nBaseId,
                       int a_nTpCalled,
                       int a_nTpBaseline,
@@ -78,21 +82,27 @@ public:
      */
     void WriteStatistics(int a_nMode);
     
-    ///Open SyncPoint File
-    void OpenSyncPointFile(const std::string& a_rFilePath);
+    ///Write the results table to the given stream (same layout as log.txt)
+    void WriteStatistics(int a_nMode, std::ostream& a_rStream);
+    
+    ///Open SyncPoint File. Intervals are written to <path>.sync in binary format and to <path>.txt if text export is enabled
+    void OpenSyncPointFile(const std::string& a_rFilePath, bool a_bIsTextExportEnabled);
     ///Close SyncPoint File
     void CloseSyncPointFile();
     
-    ///Write SyncPointList to a file
-    void WriteSyncPointList(const std::string& a_rChrName, const std::vector<core::CSyncPoint>& a_rSyncPointList);
+    ///Write SyncPointList of a chromosome to the file(s)
+    void WriteSyncPointList(const std::string& a_rChrName, const std::vector<SSyncInterval>& a_rIntervalList);
         
 private:
     
-    //Log entry array for ga4gh output [THE STANTARD OUTPUT]
+    //Log entry array for ga4gh output [THE STANTARD OUTPUT]. Indexed by chromosome tuple index
     std::vector<SLogEntry> m_aResultEntries;
         
     std::string m_aLogPath;
     
+    //Binary sync interval file and the optional text export
+    CSyncIntervalFile m_syncIntervalFile;
+    bool m_bIsSyncPointTextEnabled = false;
     std::ofstream m_syncPointFile;
     
 };
@@ -0,0 +1,81 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CRocLog.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_ROC_LOG_H_
+#define _C_ROC_LOG_H_
+
+#include <string>
+#include <vector>
+
+namespace duocomparison
+{
+
+/**
+ * @brief Variant counts of a single score value. Missing scores are stored with -infinity
+ */
+struct SRocBin
+{
+    float m_fScore;
+    int m_nTpCalled;
+    int m_nTpBase;
+    int m_nFp;
+};
+
+/**
+ * @brief Collects score binned TP/FP counts of each chromosome and writes the ROC table of all score thresholds
+ *
+ * A row with threshold t contains the variants whose score >= t. Called TPs and FPs use their own score. A baseline TP uses the
+ * minimum score of the called TPs in its sync region, so it is counted as FN as soon as any call that it is matched with is
+ * filtered. Best path is found once with all variants. Re-running the comparison with only the variants above t could find a
+ * different path, so the counts of a row may differ from a real thresholded run.
+ */
+class CRocLog
+{
+    
+public:
+    
+    ///Sorts the bins of a chromosome by descending score and merges the bins with the same score
+    static void CompressBins(std::vector<SRocBin>& a_rBins);
+    
+    ///Allocates the bins of each chromosome. Each chromosome is logged to its own slot so that threads do not need to lock
+    void SetChromosomeCount(int a_nChromosomeCount);
+    
+    ///Records the score bins and the number of unmatched baseline variants of a chromosome
+    void LogChromosome(int a_nChromosomeIndex, std::vector<SRocBin>& a_rBins, int a_nFalseNegative);
+    
+    ///Write the ROC table to the given path
+    void WriteRoc(const std::string& a_rRocPath, const std::string& a_rScoreField);
+    
+private:
+    
+    //Score bins of each chromosome
+    std::vector<std::vector<SRocBin>> m_aChromosomeBins;
+    
+    //Baseline variants which are not matched at any threshold for each chromosome
+    std::vector<int> m_aFalseNegatives;
+    
+};
+    
+}
+
+#endif // _C_ROC_LOG_H_
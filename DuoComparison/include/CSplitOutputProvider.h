@@ -29,6 +29,7 @@
 #include "CVcfWriter.h"
 #include "CVcfReader.h"
 #include "SChrIdTuple.h"
+#include "EVcfName.h"
 
 namespace core
 {
@@ -61,6 +62,12 @@ public:
     ///Set the output vcfs path FOLDER
     void SetVcfPath(const std::string& a_rVcfPath);
     
+    ///Set the file format of the output vcf(s), compression level and number of compression threads
+    void SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount);
+    
+    ///Write the original input records to the outputs instead of re-encoding them from the variants. All INFO/FORMAT fields of the input are preserved
+    void SetPassThrough(bool a_bIsPassThrough);
+    
     ///Set contigs [id, name and length] to write output header
     void SetContigList(const std::vector<SVcfContig>& a_rContigs);
     
@@ -70,23 +77,30 @@ public:
     
 private:
 
-    //Add the given variant list to the given writer vcf
-    void AddRecords(CVcfWriter* a_pWriter, const std::vector<const core::COrientedVariant*>& a_pOvarList);
-    void AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList);
+    //Return the variants at given indexes of the chromosome in the order of variant ids
+    std::vector<const CVariant*> GetVariantListInIdOrder(EVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_rVariantIndexes) const;
+    
+    //Serialize the given variant list into the chunk of the given writer. If a record reader is given, original records are copied as they are
+    void AddRecords(const CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList, SVcfChunk& a_rChunk, CVcfReader* a_pRecordReader);
     
-    //Convert CVariant/COrientedVariant to vcf record
-    void VariantToVcfRecord(const core::COrientedVariant* a_pOvar, SVcfRecord& a_rVcfRecord);
-    void VariantToVcfRecord(const CVariant* a_pVar, SVcfRecord& a_rVcfRecord);
+    //Serialize a single variant. Original record is used if it can be read from the record reader
+    void AddRecord(const CVcfWriter* a_pWriter, const CVariant& a_rVariant, SVcfChunk& a_rChunk, CVcfReader* a_pRecordReader);
     
     //Fill the header of given writers
     //@a_bIsBaseSide : if we take filter names from base vcf or called vcf
     void FillHeader(CVcfWriter *a_pWriter, bool a_bIsBaseSide);
     
-    //Generates the vcf files of each category
-    void GenerateTpBaseVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateTpCalledVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateFnVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateFpVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
+    //Serialize the records of the given chromosome of a single category. File indexes: 0-TPCalled 1-TPBase 2-FN 3-FP
+    void SerializeChromosome(int a_nFileIndex, const CVcfWriter* a_pWriter, const SChrIdTuple& a_rTuple, SVcfChunk& a_rChunk);
+    
+    //Number of output files
+    static const int SPLIT_FILE_COUNT = 4;
+    
+    //Number of threads that serialize the chromosomes
+    int m_nThreadCount;
+    
+    //If true, original input records are written to the outputs
+    bool m_bIsPassThrough;
     
     //Path of output folder where we place vcf files
     std::string m_vcfsFolder;
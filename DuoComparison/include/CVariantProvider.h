@@ -83,11 +83,23 @@ public:
     ///Read the header of Called vcf and return the filter names and descriptions
     void GetFilterInfo(EVcfName a_vcfType, std::vector<std::string>& a_rFilterNames, std::vector<std::string>& a_rFilterDescriptions);
 
+    ///Opens a new reader of the given vcf which selects the same sample. Used to read the original records of the variants (CVariant::m_nFileOffset)
+    bool OpenRecordReader(EVcfName a_uFrom, CVcfReader& a_rVcfReader) const;
+    
+    ///Creates a copy of the header of the given vcf which contains only the selected sample
+    bcf_hdr_t* CreateSampleHeader(EVcfName a_uFrom) const;
+    
     ///Return the access of not-asessed variants
     std::vector<const CVariant*> GetNotAssessedVariantList(EVcfName a_uFrom, int a_nChrNo);
 
+    ///Return the indexes of the variants of given chromosome in the order of variant ids. The order is computed at load time
+    const std::vector<unsigned int>& GetIdOrder(EVcfName a_uFrom, int a_nChrNo) const;
+    
+    ///Return the index of the variant in the variant list of its chromosome
+    int GetVariantIndex(EVcfName a_uFrom, const CVariant& a_rVariant) const;
+    
     ///Initialize Homozygous Oriented Variant Lists with given base and called variant set
-    void FillAlleleMatchVariantList(SChrIdTuple& a_rTuple,
+    void FillAlleleMatchVariantList(const SChrIdTuple& a_rTuple,
                                     std::vector<const CVariant*>& a_rBaseVariants,
                                     std::vector<const CVariant*>& a_rCalledVariants);
 
@@ -135,6 +147,10 @@ private:
     //List that store the called Oriented variant tuples (Allele match homozygous variants)
     std::vector<std::vector<core::COrientedVariant>> m_aCalledHomozygousOrientedVariantList;
 
+    //Indexes of base/called variants of each chromosome sorted by variant id
+    std::vector<std::vector<unsigned int>> m_aBaseIdOrder;
+    std::vector<std::vector<unsigned int>> m_aCalledIdOrder;
+    
     //List that stores baseline variants which are filtered out from comparison
     std::vector<std::vector<CVariant>> m_aBaseNotAssessedVariantList;
     //List that stores called variants which are filtered out from comparison
@@ -142,6 +158,9 @@ private:
 
     //Parameters come from command line arguments
     SConfig m_config;
+    
+    //Selected sample names of base and called vcf [Used as a part of variant cache key]
+    std::string m_aSampleNames[2];
 
     //Chromosome id tuples for each common chromosome
     std::vector<SChrIdTuple> m_aCommonChrTupleList;
@@ -26,12 +26,12 @@
 #ifndef C_VCF_ANALYZER_H
 #define C_VCF_ANALYZER_H
 
-#include <thread>
 #include "CPathReplay.h"
 #include "SConfig.h"
 #include "CVariantProvider.h"
 #include "CResultLog.h"
-#include <mutex>
+#include "CStratificationIndex.h"
+#include "CRocLog.h"
 
 namespace duocomparison
 {
@@ -62,18 +62,37 @@ private:
     //Prints the help menu at console
     void PrintHelp() const;
     
-    //Divide the jobs between different threads homogeneously for given number of thread count. Return the actual thread count
+    //Process the chromosomes with the work-stealing scheduler (largest estimated cost first). Return the actual thread count
     int AssignJobsToThreads(int a_nThreadCount);
         
-    //Function that process chromosome in bulk for SPLIT mode (process either genotype or allele match)
-    void ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool a_bIsGenotypeMatch);
+    //Function that process a chromosome for SPLIT mode (process either genotype or allele match)
+    void ProcessChromosomeSPLIT(const SChrIdTuple& a_rTuple, bool a_bIsGenotypeMatch);
 
-    //Function that process chromosome in bulk for GA4GH mode (process both genotype and allele matches)
-    void ThreadFunctionGA4GH(std::vector<SChrIdTuple> a_aTuples);
+    //Function that process a chromosome for GA4GH mode (process both genotype and allele matches)
+    void ProcessChromosomeGA4GH(const SChrIdTuple& a_rTuple);
 
-    //Calculate the syncronization point list for the given tuple
-    void CalculateSyncPointList(const SChrIdTuple& a_rTuple, std::vector<core::CSyncPoint>& a_rSyncPointList);
+    //Calculate the syncronization intervals (with the variant id ranges of both sides) for the given tuple
+    void CalculateSyncIntervals(const SChrIdTuple& a_rTuple, std::vector<SSyncInterval>& a_rIntervalList);
     
+    //Counts the TP/FP/FN variants of a chromosome per stratum and records them to the stratified loggers
+    void LogStratifiedStatistic(const SChrIdTuple& a_rTuple,
+                                const std::vector<const core::COrientedVariant*>& a_rTpCalled,
+                                const std::vector<const core::COrientedVariant*>& a_rTpBase,
+                                const std::vector<const core::COrientedVariant*>& a_rHalfTpCalled,
+                                const std::vector<const core::COrientedVariant*>& a_rHalfTpBase,
+                                const std::vector<const CVariant*>& a_rFp,
+                                const std::vector<const CVariant*>& a_rFn);
+    
+    //Writes the statistics table of each stratum to stratified_log.txt
+    void WriteStratifiedStatistics(int a_nMode);
+    
+    //Bins the TP/FP variants of a chromosome by their score and records them to the ROC logger
+    void LogRocStatistic(const SChrIdTuple& a_rTuple,
+                         const std::vector<const core::COrientedVariant*>& a_rTpCalled,
+                         const std::vector<const core::COrientedVariant*>& a_rTpBase,
+                         const std::vector<const CVariant*>& a_rFp,
+                         int a_nFalseNegative);
+
     //[TEST PURPOSE] Print given variants to an external file
     void PrintVariants(std::string a_outputDirectory, std::string a_FileName, const std::vector<const core::COrientedVariant*>& a_rOvarList) const;
     void PrintVariants(std::string a_outputDirectory, std::string a_FileName, const std::vector<const CVariant*>& a_rVarList) const;
@@ -85,6 +104,15 @@ private:
     //Object to write variant statistic into a file
     CResultLog m_resultLogger;
     
+    //Interval index of the stratification BED files
+    CStratificationIndex m_stratificationIndex;
+    
+    //Statistic loggers of each stratum (indexed by stratum id)
+    std::vector<CResultLog> m_aStratifiedLoggers;
+    
+    //Object to write score binned statistics into roc.tsv
+    CRocLog m_rocLogger;
+    
     //Variant provider instance
     CVariantProvider m_provider;
     
@@ -93,12 +121,6 @@ private:
     
     //Best Paths written by each thread to find Allele matches for each unique chromosome exists
     std::vector<core::CPath> m_aBestPathsAllele;
-    
-    //Thread pool we have for multitasking by per chromosome
-    std::thread *m_pThreadPool;
-    
-    //To prevent data race in multi-thread mode
-    std::mutex mtx;
 
 };
     
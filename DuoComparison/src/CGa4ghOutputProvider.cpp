@@ -29,6 +29,7 @@
 #include "CVariantIteratorGa4gh.h"
 #include "CVariantProvider.h"
 #include "Constants.h"
+#include "CParallelVcfSerializer.h"
 #include <iostream>
 #include <algorithm>
 #include <Utils/CUtils.h>
@@ -51,6 +52,12 @@ void CGa4ghOutputProvider::SetVcfPath(const std::string& a_rVcfPath)
     m_vcfPath = a_rVcfPath + "/Ga4ghOutput.vcf";
 }
 
+void CGa4ghOutputProvider::SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount)
+{
+    m_vcfWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
+    m_nThreadCount = a_nThreadCount;
+}
+
 void CGa4ghOutputProvider::SetContigList(const std::vector<SVcfContig>& a_rContigs)
 {
     m_contigs = a_rContigs;
@@ -62,11 +69,20 @@ void CGa4ghOutputProvider::GenerateGa4ghVcf(const std::vector<SChrIdTuple>& a_rC
     m_vcfWriter.CreateVcf(m_vcfPath.c_str());
     FillHeader();
     
-    for(SChrIdTuple tuple : a_rCommonChromosomes)
-    {
-        std::cout << "Processing Chromosome " << tuple.m_chrName << std::endl;
-        AddRecords(m_aBestPaths[tuple.m_nTupleIndex], tuple);
-    }
+    //Chromosomes are serialized concurrently and written in order
+    CParallelVcfSerializer::Run(static_cast<int>(a_rCommonChromosomes.size()),
+                                m_nThreadCount,
+                                [&](int a_nJob, SVcfChunk& a_rChunk)
+                                {
+                                    m_vcfWriter.InitChunk(a_rChunk);
+                                    AddRecords(m_aBestPaths[a_rCommonChromosomes[a_nJob].m_nTupleIndex], a_rCommonChromosomes[a_nJob], a_rChunk);
+                                    m_vcfWriter.FinalizeChunk(a_rChunk);
+                                },
+                                [&](int a_nJob, SVcfChunk& a_rChunk)
+                                {
+                                    std::cout << "Processing Chromosome " << a_rCommonChromosomes[a_nJob].m_chrName << std::endl;
+                                    m_vcfWriter.WriteChunk(a_rChunk);
+                                });
     
     m_vcfWriter.CloseVcf();
 }
@@ -101,7 +117,7 @@ void CGa4ghOutputProvider::FillHeader()
     m_vcfWriter.WriteHeaderToVcf();
 }
 
-void CGa4ghOutputProvider::AddSingleSampleRecord(const SVariantSummary &a_rVariant, bool a_bIsBase)
+void CGa4ghOutputProvider::AddSingleSampleRecord(const SVariantSummary &a_rVariant, bool a_bIsBase, SVcfChunk& a_rChunk)
 {
     SVcfRecord record;
     std::string falseTag = a_bIsBase ? "FN" : "FP";
@@ -116,10 +132,10 @@ void CGa4ghOutputProvider::AddSingleSampleRecord(const SVariantSummary &a_rVaria
     if(true == a_bIsBase)
         record.m_aSampleData.push_back(SPerSampleData());
     
-    m_vcfWriter.AddRecord(record);
+    m_vcfWriter.AddRecord(record, a_rChunk);
 }
 
-void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTuple a_rTuple)
+void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTuple a_rTuple, SVcfChunk& a_rChunk)
 {
     //Best Path excluded variants
     std::vector<const CVariant*> excludedVarsBase = m_pVariantProvider->GetVariantList(eBASE, a_rTuple.m_nBaseId, a_rBestPath.m_baseSemiPath.GetExcluded());
@@ -186,7 +202,7 @@ void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTupl
                         std::string matchBase = GetMatchStr(nextVarBaseList[i].m_pVariant->m_variantStatus);
                         std::string matchCalled = GetMatchStr(nextVarCalledList[j].m_pVariant->m_variantStatus);
                         MergeVariants(nextVarBaseList[i].m_pVariant, nextVarCalledList[j].m_pVariant, matchBase, matchCalled, decisionBase, decisionCalled, record);
-                        m_vcfWriter.AddRecord(record);
+                        m_vcfWriter.AddRecord(record, a_rChunk);
                         
                         nextVarBaseList.erase(nextVarBaseList.begin() + i);
                         nextVarCalledList.erase(nextVarCalledList.begin() + j);
@@ -199,14 +215,14 @@ void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTupl
 
             //If there are base variants exists which doesnt merge already
             for (SVariantSummary var : nextVarCalledList)
-                AddSingleSampleRecord(var, false);
+                AddSingleSampleRecord(var, false, a_rChunk);
             
             nextVarCalledList.clear();
             calledVariants.FillNext(nextVarCalledList);
             
             //If there are called variants exists which doesnt merge already
             for(SVariantSummary var : nextVarBaseList)
-                AddSingleSampleRecord(var, true);
+                AddSingleSampleRecord(var, true, a_rChunk);
             
             nextVarBaseList.clear();
             baseVariants.FillNext(nextVarBaseList);
@@ -215,7 +231,7 @@ void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTupl
         else if (basePosition > calledPosition)
         {
             for (SVariantSummary var : nextVarCalledList)
-                AddSingleSampleRecord(var, false);
+                AddSingleSampleRecord(var, false, a_rChunk);
             
             nextVarCalledList.clear();
             calledVariants.FillNext(nextVarCalledList);
@@ -224,7 +240,7 @@ void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTupl
         else
         {
             for(SVariantSummary var : nextVarBaseList)
-                AddSingleSampleRecord(var, true);
+                AddSingleSampleRecord(var, true, a_rChunk);
                 
             nextVarBaseList.clear();
             baseVariants.FillNext(nextVarBaseList);
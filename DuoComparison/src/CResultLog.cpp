@@ -35,10 +35,15 @@ void CResultLog::SetLogPath(const std::string& a_rLogFolder)
 }
 
 
+void CResultLog::SetChromosomeCount(int a_nChromosomeCount)
+{
+    m_aResultEntries = std::vector<SLogEntry>(a_nChromosomeCount);
+}
+
 //Records the result for given chromosome
-void CResultLog::LogStatistic(const std::string& a_chromosomeName, int a_nBaseId, int a_nTpCalled, int a_nTpBaseline, int a_nHalfTPCalled, int a_nHalfTPBaseline, int a_nFalsePositive, int a_nFalseNegative)
+void CResultLog::LogStatistic(int a_nChromosomeIndex, const std::string& a_chromosomeName, int a_nBaseId, int a_nTpCalled, int a_nTpBaseline, int a_nHalfTPCalled, int a_nHalfTPBaseline, int a_nFalsePositive, int a_nFalseNegative)
 {
-    SLogEntry entry;
+    SLogEntry& entry = m_aResultEntries[a_nChromosomeIndex];
     
     entry.m_nTpCalled = a_nTpCalled;
     entry.m_nTpBase = a_nTpBaseline;
@@ -49,17 +54,20 @@ void CResultLog::LogStatistic(const std::string& a_chromosomeName, int a_nBaseId
     entry.m_bIsNull = false;
     entry.m_chrName = a_chromosomeName;
     entry.m_nBaseId = a_nBaseId;
-    
-    m_aResultEntries.push_back(entry);
 }
 
 //Write the results in log.txt file
 void CResultLog::WriteStatistics(int a_nMode)
 {
-    //a_nMode :  0- Genotype Match (SPLIT) 1-Allele Match (SPLIT)  2- Both (GA4GH)
-    
     std::ofstream outputLog;
     outputLog.open(m_aLogPath);
+    WriteStatistics(a_nMode, outputLog);
+    outputLog.close();
+}
+
+void CResultLog::WriteStatistics(int a_nMode, std::ostream& outputLog)
+{
+    //a_nMode :  0- Genotype Match (SPLIT) 1-Allele Match (SPLIT)  2- Both (GA4GH)
     
     if(a_nMode != 1)
     {
@@ -162,26 +170,36 @@ void CResultLog::WriteStatistics(int a_nMode)
         outputLog << "\t" << Precision << "\t" << Recall << "\t" << Fmeasure << std::endl;
         
     }
-    
-    outputLog.close();
 }
 
 
-void CResultLog::OpenSyncPointFile(const std::string& a_rFilePath)
+void CResultLog::OpenSyncPointFile(const std::string& a_rFilePath, bool a_bIsTextExportEnabled)
 {
-    m_syncPointFile.open(a_rFilePath);
+    m_syncIntervalFile.Create(a_rFilePath + ".sync");
+    
+    m_bIsSyncPointTextEnabled = a_bIsTextExportEnabled;
+    if(m_bIsSyncPointTextEnabled)
+        m_syncPointFile.open(a_rFilePath + ".txt");
 }
 
 void CResultLog::CloseSyncPointFile()
 {
-    m_syncPointFile.close();
+    m_syncIntervalFile.Close();
+    
+    if(m_bIsSyncPointTextEnabled)
+        m_syncPointFile.close();
 }
 
 //Write SyncPointList to a file
-void CResultLog::WriteSyncPointList(const std::string& a_rChrName, const std::vector<core::CSyncPoint>& a_rSyncPointList)
+void CResultLog::WriteSyncPointList(const std::string& a_rChrName, const std::vector<SSyncInterval>& a_rIntervalList)
 {
-    for(core::CSyncPoint point : a_rSyncPointList)
-         m_syncPointFile << a_rChrName << " " << point.m_nStartPosition << " " << point.m_nEndPosition << std::endl;
+    m_syncIntervalFile.WriteContig(a_rChrName, a_rIntervalList);
+    
+    if(m_bIsSyncPointTextEnabled)
+    {
+        for(const SSyncInterval& interval : a_rIntervalList)
+            m_syncPointFile << a_rChrName << " " << interval.m_nStartPosition << " " << interval.m_nEndPosition << "\n";
+    }
 }
 
 
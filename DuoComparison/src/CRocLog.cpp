@@ -0,0 +1,115 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CRocLog.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CRocLog.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+using namespace duocomparison;
+
+void CRocLog::CompressBins(std::vector<SRocBin>& a_rBins)
+{
+    std::sort(a_rBins.begin(), a_rBins.end(), [](const SRocBin& l, const SRocBin& r){ return l.m_fScore > r.m_fScore; });
+    
+    unsigned int binCount = 0;
+    for(unsigned int k = 0; k < a_rBins.size(); k++)
+    {
+        if(binCount > 0 && a_rBins[binCount-1].m_fScore == a_rBins[k].m_fScore)
+        {
+            a_rBins[binCount-1].m_nTpCalled += a_rBins[k].m_nTpCalled;
+            a_rBins[binCount-1].m_nTpBase += a_rBins[k].m_nTpBase;
+            a_rBins[binCount-1].m_nFp += a_rBins[k].m_nFp;
+        }
+        else
+            a_rBins[binCount++] = a_rBins[k];
+    }
+    
+    a_rBins.resize(binCount);
+}
+
+void CRocLog::SetChromosomeCount(int a_nChromosomeCount)
+{
+    m_aChromosomeBins = std::vector<std::vector<SRocBin>>(a_nChromosomeCount);
+    m_aFalseNegatives = std::vector<int>(a_nChromosomeCount, 0);
+}
+
+void CRocLog::LogChromosome(int a_nChromosomeIndex, std::vector<SRocBin>& a_rBins, int a_nFalseNegative)
+{
+    m_aChromosomeBins[a_nChromosomeIndex].swap(a_rBins);
+    m_aFalseNegatives[a_nChromosomeIndex] = a_nFalseNegative;
+}
+
+void CRocLog::WriteRoc(const std::string& a_rRocPath, const std::string& a_rScoreField)
+{
+    //Merge the chromosome bins in chromosome order
+    std::vector<SRocBin> bins;
+    int falseNegativeTotal = 0;
+    for(unsigned int k = 0; k < m_aChromosomeBins.size(); k++)
+    {
+        bins.insert(bins.end(), m_aChromosomeBins[k].begin(), m_aChromosomeBins[k].end());
+        falseNegativeTotal += m_aFalseNegatives[k];
+    }
+    
+    CompressBins(bins);
+    
+    int TPbaseTotal = 0;
+    for(const SRocBin& bin : bins)
+        TPbaseTotal += bin.m_nTpBase;
+    
+    std::ofstream outputRoc;
+    outputRoc.open(a_rRocPath);
+    
+    outputRoc << "#score=" << a_rScoreField << std::endl;
+    outputRoc << "Threshold" << "\t" << "True-Pos-Called" << "\t" << "True-Pos-Baseline" << "\t" << "False-Pos" << "\t" << "False-Neg" << "\t" << "Precision" << "\t" << "Recall";
+    outputRoc << "\t" << "F-measure" << std::endl;
+    
+    int TPcalled = 0;
+    int TPbase = 0;
+    int FP = 0;
+    
+    //Rows are cumulative from the highest score. Variants without a score are only included in the last row (threshold '.')
+    for(const SRocBin& bin : bins)
+    {
+        TPcalled += bin.m_nTpCalled;
+        TPbase += bin.m_nTpBase;
+        FP += bin.m_nFp;
+        int FN = falseNegativeTotal + TPbaseTotal - TPbase;
+        
+        double Precision = TPcalled + FP == 0 ? 1.0 : static_cast<double>(TPcalled) / static_cast<double>(TPcalled + FP);
+        double Recall = TPbase + FN == 0 ? 0.0 : static_cast<double>(TPbase) / static_cast<double>(TPbase + FN);
+        double Fmeasure = Precision + Recall == 0.0 ? 0.0 : (2.0 * Precision * Recall) / (Precision + Recall);
+        
+        if(std::isinf(bin.m_fScore) && bin.m_fScore < 0)
+            outputRoc << ".";
+        else
+            outputRoc << bin.m_fScore;
+        
+        outputRoc << "\t" << TPcalled << "\t" << TPbase << "\t" << FP << "\t" << FN;
+        outputRoc.precision(4);
+        outputRoc << "\t" << Precision << "\t" << Recall << "\t" << Fmeasure << std::endl;
+        outputRoc.precision(6);
+    }
+    
+    outputRoc.close();
+}
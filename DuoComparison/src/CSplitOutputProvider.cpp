@@ -27,14 +27,17 @@
 #include "CPath.h"
 #include "CVariantProvider.h"
 #include "Constants.h"
+#include "CParallelVcfSerializer.h"
 #include <algorithm>
+#include <iostream>
 
 
 using namespace duocomparison;
 
 CSplitOutputProvider::CSplitOutputProvider()
 {
-
+    m_nThreadCount = 1;
+    m_bIsPassThrough = false;
 }
 
 void CSplitOutputProvider::SetVariantProvider(CVariantProvider* a_pProvider)
@@ -52,152 +55,155 @@ void CSplitOutputProvider::SetVcfPath(const std::string& a_rVcfPath)
     m_vcfsFolder = a_rVcfPath;
 }
 
-void CSplitOutputProvider::SetContigList(const std::vector<SVcfContig>& a_rContigs)
+void CSplitOutputProvider::SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount)
 {
-    m_contigs = a_rContigs;
+    m_TPBaseWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
+    m_TPCalledWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
+    m_FPWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
+    m_FNWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
+    m_nThreadCount = a_nThreadCount;
 }
 
-void CSplitOutputProvider::GenerateSplitVcfs(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::SetPassThrough(bool a_bIsPassThrough)
 {
-    GenerateTpCalledVcf(a_rCommonChromosomes);
-    GenerateTpBaseVcf(a_rCommonChromosomes);
-    GenerateFnVcf(a_rCommonChromosomes);
-    GenerateFpVcf(a_rCommonChromosomes);
+    m_bIsPassThrough = a_bIsPassThrough;
 }
 
-void CSplitOutputProvider::GenerateTpBaseVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::SetContigList(const std::vector<SVcfContig>& a_rContigs)
 {
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-    
-    std::string filePath = m_vcfsFolder + "/TPBase.vcf";
-    m_TPBaseWriter.CreateVcf(filePath.c_str());
-    
-    //Fill the header section
-    FillHeader(&m_TPBaseWriter, true);
-    
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
-    {
-        const std::vector<const core::COrientedVariant*> ovarList = m_aBestPaths[tuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        std::vector<const core::COrientedVariant*> sortedOvarList(ovarList);
-        std::sort(sortedOvarList.begin(), sortedOvarList.end(), [](const core::COrientedVariant* ovar1, const core::COrientedVariant* ovar2){return ovar1->GetVariant().m_nId < ovar2->GetVariant().m_nId;});
-        AddRecords(&m_TPBaseWriter, sortedOvarList);
-    }
-    
-    m_TPBaseWriter.CloseVcf();
+    m_contigs = a_rContigs;
 }
 
-void CSplitOutputProvider::GenerateTpCalledVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::GenerateSplitVcfs(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
 {
     std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
     std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
     
-    std::string filePath = m_vcfsFolder + "/TPCalled.vcf";
-    m_TPCalledWriter.CreateVcf(filePath.c_str());
+    CVcfWriter* writers[SPLIT_FILE_COUNT] = {&m_TPCalledWriter, &m_TPBaseWriter, &m_FNWriter, &m_FPWriter};
+    const char* fileNames[SPLIT_FILE_COUNT] = {"/TPCalled.vcf", "/TPBase.vcf", "/FN.vcf", "/FP.vcf"};
+    const bool isBaseSide[SPLIT_FILE_COUNT] = {false, true, true, false};
     
-    //Fill the header section
-    FillHeader(&m_TPCalledWriter, false);
+    //Create the files and fill the header sections
+    for(int k = 0; k < SPLIT_FILE_COUNT; k++)
+    {
+        std::string filePath = m_vcfsFolder + fileNames[k];
+        writers[k]->CreateVcf(filePath.c_str());
+        FillHeader(writers[k], isBaseSide[k]);
+    }
     
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
+    int chrCount = static_cast<int>(commonChromosomesOrdered.size());
+    if(chrCount == 0)
     {
-        const std::vector<const core::COrientedVariant*> ovarList = m_aBestPaths[tuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
-        std::vector<const core::COrientedVariant*> sortedOvarList(ovarList);
-        std::sort(sortedOvarList.begin(), sortedOvarList.end(), [](const core::COrientedVariant* ovar1, const core::COrientedVariant* ovar2){return ovar1->GetVariant().m_nId < ovar2->GetVariant().m_nId;});
-        AddRecords(&m_TPCalledWriter, sortedOvarList);
+        for(int k = 0; k < SPLIT_FILE_COUNT; k++)
+            writers[k]->CloseVcf();
+        return;
     }
     
-    m_TPCalledWriter.CloseVcf();
+    //Each (file, chromosome) pair is serialized concurrently and written in file and chromosome order
+    CParallelVcfSerializer::Run(SPLIT_FILE_COUNT * chrCount,
+                                m_nThreadCount,
+                                [&](int a_nJob, SVcfChunk& a_rChunk)
+                                {
+                                    SerializeChromosome(a_nJob / chrCount, writers[a_nJob / chrCount], commonChromosomesOrdered[a_nJob % chrCount], a_rChunk);
+                                },
+                                [&](int a_nJob, SVcfChunk& a_rChunk)
+                                {
+                                    writers[a_nJob / chrCount]->WriteChunk(a_rChunk);
+                                    
+                                    //Last chromosome of the file is written
+                                    if(a_nJob % chrCount == chrCount - 1)
+                                        writers[a_nJob / chrCount]->CloseVcf();
+                                });
 }
 
-void CSplitOutputProvider::GenerateFnVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::SerializeChromosome(int a_nFileIndex, const CVcfWriter* a_pWriter, const SChrIdTuple& a_rTuple, SVcfChunk& a_rChunk)
 {
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-
-    std::string filePath = m_vcfsFolder + "/FN.vcf";
-    m_FNWriter.CreateVcf(filePath.c_str());
+    a_pWriter->InitChunk(a_rChunk);
     
-    //Fill the header section
-    FillHeader(&m_FNWriter, true);
+    //Each chunk reads the original records through its own reader since chunks are serialized concurrently
+    CVcfReader recordReader;
+    CVcfReader* pRecordReader = NULL;
+    if(m_bIsPassThrough)
+    {
+        if(m_pProvider->OpenRecordReader((a_nFileIndex == 1 || a_nFileIndex == 2) ? eBASE : eCALLED, recordReader))
+            pRecordReader = &recordReader;
+        else
+            std::cerr << "Unable to open the input vcf to read original records. Records will be re-encoded" << std::endl;
+    }
     
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
+    //[0: TPCalled, 1: TPBase, 2: FN, 3: FP]
+    EVcfName vcfName = (a_nFileIndex == 1 || a_nFileIndex == 2) ? eBASE : eCALLED;
+    int chrNo = vcfName == eBASE ? a_rTuple.m_nBaseId : a_rTuple.m_nCalledId;
+    const core::CSemiPath& semiPath = vcfName == eBASE ? m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath : m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath;
+    
+    //TPCalled and TPBase : Included variants of the best path. FN and FP : Excluded variants of the best path
+    std::vector<int> variantIndexes;
+    if(a_nFileIndex == 0 || a_nFileIndex == 1)
     {
-        const std::vector<const CVariant*> varList = m_pProvider->GetVariantList(eBASE, tuple.m_nBaseId, m_aBestPaths[tuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> sortedVarList(varList);
-        std::sort(sortedVarList.begin(), sortedVarList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
-        AddRecords(&m_FNWriter, sortedVarList);
+        for(const core::COrientedVariant* pOvar : semiPath.GetIncludedVariants())
+            variantIndexes.push_back(m_pProvider->GetVariantIndex(vcfName, pOvar->GetVariant()));
     }
+    else
+        variantIndexes = semiPath.GetExcluded();
+    
+    AddRecords(a_pWriter, GetVariantListInIdOrder(vcfName, chrNo, variantIndexes), a_rChunk, pRecordReader);
     
-    m_FNWriter.CloseVcf();
+    a_pWriter->FinalizeChunk(a_rChunk);
 }
 
-void CSplitOutputProvider::GenerateFpVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+std::vector<const CVariant*> CSplitOutputProvider::GetVariantListInIdOrder(EVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_rVariantIndexes) const
 {
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-
-    std::string filePath = m_vcfsFolder + "/FP.vcf";
-    m_FPWriter.CreateVcf(filePath.c_str());
+    const std::vector<unsigned int>& idOrder = m_pProvider->GetIdOrder(a_uFrom, a_nChrNo);
     
-    //Fill the header section
-    FillHeader(&m_FPWriter, false);
+    //Mark the requested variants and collect them by walking the precomputed id order instead of sorting
+    std::vector<bool> isRequested(idOrder.size(), false);
+    for(int index : a_rVariantIndexes)
+        isRequested[index] = true;
     
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
+    std::vector<int> orderedIndexes;
+    orderedIndexes.reserve(a_rVariantIndexes.size());
+    for(unsigned int index : idOrder)
     {
-        const std::vector<const CVariant*> varList = m_pProvider->GetVariantList(eCALLED, tuple.m_nCalledId, m_aBestPaths[tuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
-        std::vector<const CVariant*> sortedVarList(varList);
-        std::sort(sortedVarList.begin(), sortedVarList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
-        AddRecords(&m_FPWriter, sortedVarList);
+        if(isRequested[index])
+            orderedIndexes.push_back(static_cast<int>(index));
     }
     
-    m_FPWriter.CloseVcf();
+    return m_pProvider->GetVariantList(a_uFrom, a_nChrNo, orderedIndexes);
 }
 
-void CSplitOutputProvider::VariantToVcfRecord(const CVariant* a_pVariant, SVcfRecord& a_rOutputRec)
+void CSplitOutputProvider::AddRecords(const CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList, SVcfChunk& a_rChunk, CVcfReader* a_pRecordReader)
 {
-    //Fill basic variant data
-    a_rOutputRec.m_chrName = a_pVariant->m_chrName;
-    a_rOutputRec.m_nPosition = a_pVariant->m_nOriginalPos;
-    a_rOutputRec.m_alleles = a_pVariant->m_allelesStr;
-    a_rOutputRec.m_aFilterString = a_pVariant->m_filterString;
-    
-    //Fill genotype of sample data
-    SPerSampleData data;
-    data.m_bIsPhased = a_pVariant->m_bIsPhased;
-    data.m_nHaplotypeCount = a_pVariant->m_nZygotCount;
-    data.m_bIsNoCallVariant = a_pVariant->m_bIsNoCall;
-    for(int k = 0; k < data.m_nHaplotypeCount; k++)
-        data.m_aGenotype[k] = a_pVariant->m_genotype[k];
-    
-    a_rOutputRec.m_aSampleData.push_back(data);
+    for(const CVariant* pVar : a_pVarList)
+        AddRecord(a_pWriter, *pVar, a_rChunk, a_pRecordReader);
 }
 
-void CSplitOutputProvider::AddRecords(CVcfWriter* a_pWriter, const std::vector<const core::COrientedVariant*>& a_pOvarList)
+void CSplitOutputProvider::AddRecord(const CVcfWriter* a_pWriter, const CVariant& a_rVariant, SVcfChunk& a_rChunk, CVcfReader* a_pRecordReader)
 {
-    for(const core::COrientedVariant* pOvar : a_pOvarList)
-    {
-        SVcfRecord record;
-        VariantToVcfRecord(&pOvar->GetVariant(), record);
-        a_pWriter->AddRecord(record);
-    }
+    //Variants which are read through BED region iterators have no file offset. They are encoded from the variant
+    if(a_pRecordReader != NULL && a_pRecordReader->ReadRecordAt(a_rVariant.m_nFileOffset))
+        a_pWriter->AddRawRecord(a_pRecordReader->GetRecordPointer(), a_rChunk);
+    else
+        a_pWriter->AddRecord(a_rVariant, a_rChunk);
 }
 
-void CSplitOutputProvider::AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList)
+void CSplitOutputProvider::FillHeader(CVcfWriter *a_pWriter, bool a_bIsBaseSide)
 {
-    for(const CVariant* pVar : a_pVarList)
+    //Original records are written with the header of the input vcf
+    if(m_bIsPassThrough)
     {
-        SVcfRecord record;
-        VariantToVcfRecord(pVar, record);
-        a_pWriter->AddRecord(record);
+        bcf_hdr_t* pHeader = m_pProvider->CreateSampleHeader(a_bIsBaseSide ? eBASE : eCALLED);
+        if(pHeader != NULL)
+        {
+            a_pWriter->SetRawHeader(pHeader);
+            a_pWriter->AddHeaderLine("##source= VBT Variant Comparison Tool " + VBT_VERSION);
+            a_pWriter->WriteHeaderToVcf();
+            return;
+        }
+        
+        std::cerr << "Unable to copy the header of the input vcf. Records will be re-encoded" << std::endl;
+        m_bIsPassThrough = false;
     }
-}
-
-void CSplitOutputProvider::FillHeader(CVcfWriter *a_pWriter, bool a_bIsBaseSide)
-{
+    
     //INIT VCF HEADER
     a_pWriter->InitHeader();
     a_pWriter->AddHeaderLine("##source= VBT Variant Comparison Tool " + VBT_VERSION);
@@ -26,10 +26,13 @@
 #include "CVariantProvider.h"
 #include "COrientedVariant.h"
 #include "CSimpleBEDParser.h"
+#include "CVariantCache.h"
 #include "Utils/CUtils.h"
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <cassert>
 
 using namespace duocomparison;
 
@@ -87,12 +90,16 @@ bool CVariantProvider::OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader)
     
     //SET SAMPLE NAME TO READ ONLY ONE SAMPLE FROM THE VCF
     if (true == bIsCustomSampleEnabled)
+    {
         bIsSuccess = a_rVcfReader.SelectSample(pSampleName);
+        m_aSampleNames[a_uFrom] = pSampleName;
+    }
     else
     {
         std::vector<std::string> sampleNames;
         a_rVcfReader.GetSampleNames(sampleNames);
         bIsSuccess = a_rVcfReader.SelectSample(sampleNames[0]);
+        m_aSampleNames[a_uFrom] = sampleNames[0];
     }
     
     if(!bIsSuccess)
@@ -104,6 +111,21 @@ bool CVariantProvider::OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader)
     return bIsSuccess;
 }
 
+bool CVariantProvider::OpenRecordReader(EVcfName a_uFrom, CVcfReader& a_rVcfReader) const
+{
+    const char* pFileName = a_uFrom == eBASE ? m_config.m_pBaseVcfFileName : m_config.m_pCalledVcfFileName;
+    
+    if(!a_rVcfReader.Open(pFileName))
+        return false;
+    
+    return a_rVcfReader.SelectSample(m_aSampleNames[a_uFrom]);
+}
+
+bcf_hdr_t* CVariantProvider::CreateSampleHeader(EVcfName a_uFrom) const
+{
+    return a_uFrom == eBASE ? m_baseVCF.CreateSampleHeader() : m_calledVCF.CreateSampleHeader();
+}
+
 bool CVariantProvider::InitializeReaders(const SConfig& a_rConfig)
 {
     bool bIsSuccess;
@@ -115,7 +137,7 @@ bool CVariantProvider::InitializeReaders(const SConfig& a_rConfig)
     OpenVcfFile(eCALLED, m_calledVCF);
     
     //Open FASTA file
-    bIsSuccess = m_referenceFasta.OpenFastaFile(a_rConfig.m_pFastaFileName);
+    bIsSuccess = m_referenceFasta.OpenFastaFile(a_rConfig.m_pFastaFileName, a_rConfig.m_bUseReferenceCache ? a_rConfig.m_pReferenceCacheDirectory : NULL);
     if(!bIsSuccess)
     {
         std::cerr << "FASTA file is unable to open!: " << a_rConfig.m_pFastaFileName << std::endl;
@@ -127,6 +149,10 @@ bool CVariantProvider::InitializeReaders(const SConfig& a_rConfig)
         //Fill variant lists from VCF files
         FillVariantLists();
         
+        //Compute the id order of variants which is used while writing the outputs
+        FillVariantOrders(m_aBaseVariantList, m_aBaseIdOrder, CUtils::CompareVariantsById);
+        FillVariantOrders(m_aCalledVariantList, m_aCalledIdOrder, CUtils::CompareVariantsById);
+        
         //Generate OrientedVariant list using the variant list
         FillOrientedVariantLists();
         
@@ -152,10 +178,41 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
     std::vector<std::vector<CVariant>>* pVariants = a_nSampleId == 0 ? &m_aBaseVariantList : &m_aCalledVariantList;
     
     
+    std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+    
+    //Try to load the processed variants from the cache (INFO columns are not cached)
+    CVariantCache cache;
+    std::string cachePath;
+    std::string cacheKey;
+    bool bIsCacheEnabled = a_rConfig.m_bUseVariantCache && !a_rConfig.m_bIsReadINFO;
+    if(bIsCacheEnabled)
+    {
+        const char* pFileName = sampleName == eBASE ? a_rConfig.m_pBaseVcfFileName : a_rConfig.m_pCalledVcfFileName;
+        cachePath = CVariantCache::GetCachePath(a_rConfig.m_pVariantCacheDirectory, pFileName, m_aSampleNames[sampleName]);
+        cacheKey = CVariantCache::GenerateKey(pFileName, m_aSampleNames[sampleName], a_rConfig);
+        
+        if(cache.Load(cachePath, cacheKey, *pVariants, *pNonAssessedVariants)
+           && pVariants->size() == pReader->GetContigs().size()
+           && pNonAssessedVariants->size() == pReader->GetContigs().size())
+        {
+            std::cout << "Loaded " << sampleNameStr << " variants from cache " << cachePath << std::endl;
+            return;
+        }
+        
+        //Discard partially loaded lists
+        *pVariants = std::vector<std::vector<CVariant>>(pReader->GetContigs().size());
+        *pNonAssessedVariants = std::vector<std::vector<CVariant>>(pReader->GetContigs().size());
+    }
+    
+    //Seek directly to BED regions if the input is indexed. Otherwise whole file is scanned and filtered below
+    if(a_rConfig.m_bInitializeFromBed && pReader->SetRegions(bedParser))
+        std::cout << "Reading only BED regions of " << sampleNameStr << " vcf using its index" << std::endl;
+    
     CVariant variant;
     int id = 0;
     std::string preChrId = "";
     unsigned int regionIterator = 0;
+    const std::vector<SBedRegion>* pRegions = &bedParser.GetRegions(preChrId);
     
     std::vector<CVariant> multiTrimmableVarList;
     
@@ -164,11 +221,12 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
         if(preChrId != variant.m_chrName)
         {
             //We update the remaining contig count in BED file
-            if(bedParser.m_regionMap[preChrId].size() > 0)
+            if(pRegions->size() > 0)
                 remainingBedContigCount--;
             
             regionIterator = 0;
             preChrId = variant.m_chrName;
+            pRegions = &bedParser.GetRegions(preChrId);
             std::cout << "Processing chromosome " << preChrId << " of " << sampleNameStr  << " vcf" << std::endl;
         }
         
@@ -178,24 +236,16 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
             if(remainingBedContigCount == 0)
                 break;
 
-            //No Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
-                continue;
-            
             //Skip to next region
-            while(regionIterator < bedParser.m_regionMap[variant.m_chrName].size()
-                  &&
-                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nEndPos)
-            {
+            while(regionIterator < pRegions->size() && variant.m_nOriginalPos >= (*pRegions)[regionIterator].m_nEndPos)
                 regionIterator++;
-            }
             
             //No remaining Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == pRegions->size())
                 continue;
 
             //Variant Could not pass from BED region
-            if(bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
+            if((*pRegions)[regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
                 continue;
         }
         
@@ -229,6 +279,13 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
         std::sort((*pNonAssessedVariants)[k].begin(), (*pNonAssessedVariants)[k].end(), CUtils::CompareVariants);
         std::sort((*pVariants)[k].begin(), (*pVariants)[k].end(), CUtils::CompareVariants);
     }
+    
+    if(bIsCacheEnabled)
+        cache.Save(cachePath, cacheKey, *pVariants, *pNonAssessedVariants);
+    
+    std::chrono::steady_clock::time_point loadEnd = std::chrono::steady_clock::now();
+    std::cerr << "Loaded " << sampleNameStr << " " << (pReader->IsBcf() ? "BCF" : "VCF") << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count() << " ms" << std::endl;
 }
 
 
@@ -269,7 +326,7 @@ void CVariantProvider::FillOrientedVariantLists()
     }
 }
 
-void CVariantProvider::FillAlleleMatchVariantList(SChrIdTuple& a_tuple, std::vector<const CVariant*>& a_rBaseVariants, std::vector<const CVariant*>& a_rCalledVariants)
+void CVariantProvider::FillAlleleMatchVariantList(const SChrIdTuple& a_tuple, std::vector<const CVariant*>& a_rBaseVariants, std::vector<const CVariant*>& a_rCalledVariants)
 {
     //Initialize HomozygousOrientedVariantLists
     if(false == m_bIsHomozygousOvarListInitialized)
@@ -292,6 +349,20 @@ void CVariantProvider::FillAlleleMatchVariantList(SChrIdTuple& a_tuple, std::vec
     }
 }
 
+const std::vector<unsigned int>& CVariantProvider::GetIdOrder(EVcfName a_uFrom, int a_nChrNo) const
+{
+    return a_uFrom == eBASE ? m_aBaseIdOrder[a_nChrNo] : m_aCalledIdOrder[a_nChrNo];
+}
+
+int CVariantProvider::GetVariantIndex(EVcfName a_uFrom, const CVariant& a_rVariant) const
+{
+    const std::vector<CVariant>& variants = a_uFrom == eBASE ? m_aBaseVariantList[a_rVariant.m_nChrId] : m_aCalledVariantList[a_rVariant.m_nChrId];
+    
+    //Variants (and the oriented variants) refer to the elements of the contiguous variant list of the chromosome
+    assert(!variants.empty() && &a_rVariant >= &variants[0] && &a_rVariant < &variants[0] + variants.size());
+    return static_cast<int>(&a_rVariant - &variants[0]);
+}
+
 std::vector<const CVariant*> CVariantProvider::GetVariantList(EVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_VariantIndexes)
 {
     std::vector<const CVariant*> result;
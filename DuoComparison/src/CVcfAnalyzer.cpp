@@ -29,7 +29,10 @@
 #include <algorithm>
 #include "CGa4ghOutputProvider.h"
 #include "CSplitOutputProvider.h"
+#include "CTaskScheduler.h"
 #include <fstream>
+#include <cmath>
+#include <limits>
 
 using namespace duocomparison;
 
@@ -56,6 +59,13 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     if(!isSuccess)
         return;
     
+    if(m_config.m_bIsStratificationEnabled)
+    {
+        if(!m_stratificationIndex.Init(m_config.m_pStratificationFile))
+            return;
+        m_aStratifiedLoggers = std::vector<CResultLog>(m_stratificationIndex.GetStratumCount());
+    }
+    
     duration = std::difftime(std::time(0) ,start);
     std::cout << "Vcf and fasta Parser read completed in " << duration << " secs" << std::endl;
     
@@ -70,8 +80,10 @@ void CVcfAnalyzer::Run(int argc, char** argv)
         std::cerr << "Generating Outputs [SPLIT MODE]..." << std::endl;
         CSplitOutputProvider outputprovider;
         outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
+        outputprovider.SetOutputFormat(m_config.m_outputFormat, m_config.m_nCompressionLevel, m_config.m_nThreadCount);
         outputprovider.SetVariantProvider(&m_provider);
         outputprovider.SetBestPaths(m_aBestPaths);
+        outputprovider.SetPassThrough(m_config.m_bIsPassThrough);
         outputprovider.SetContigList(m_provider.GetContigs());
         outputprovider.GenerateSplitVcfs(m_provider.GetChromosomeIdTuples());
     }
@@ -81,6 +93,7 @@ void CVcfAnalyzer::Run(int argc, char** argv)
         std::cerr << "Generating Outputs [GA4GH MODE]..." << std::endl;
         CGa4ghOutputProvider outputprovider;
         outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
+        outputprovider.SetOutputFormat(m_config.m_outputFormat, m_config.m_nCompressionLevel, m_config.m_nThreadCount);
         outputprovider.SetVariantProvider(&m_provider);
         outputprovider.SetBestPaths(m_aBestPaths, m_aBestPathsAllele);
         outputprovider.SetContigList(m_provider.GetContigs());
@@ -90,12 +103,12 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     if(true == m_config.m_bGenerateSyncPoints)
     {
         std::vector<SChrIdTuple> chromosomeListToProcess = m_provider.GetChromosomeIdTuples();
-        m_resultLogger.OpenSyncPointFile(std::string(m_config.m_pOutputDirectory) + "/SyncPointList.txt");
+        m_resultLogger.OpenSyncPointFile(std::string(m_config.m_pOutputDirectory) + "/SyncPointList", m_config.m_bIsSyncPointTextEnabled);
         for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
         {
-            std::vector<core::CSyncPoint> syncPointList;
-            CalculateSyncPointList(chromosomeListToProcess[k], syncPointList);
-            m_resultLogger.WriteSyncPointList(chromosomeListToProcess[k].m_chrName, syncPointList);
+            std::vector<SSyncInterval> intervalList;
+            CalculateSyncIntervals(chromosomeListToProcess[k], intervalList);
+            m_resultLogger.WriteSyncPointList(chromosomeListToProcess[k].m_chrName, intervalList);
         }
         m_resultLogger.CloseSyncPointFile();
     }
@@ -104,6 +117,12 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     int logMode = (0 == strcmp(m_config.m_pOutputMode, "SPLIT") ? 0 : 2) + (m_config.m_bIsGenotypeMatch ? 0 : 1);
     m_resultLogger.WriteStatistics(logMode);
     
+    if(m_config.m_bIsStratificationEnabled)
+        WriteStratifiedStatistics(logMode);
+    
+    if(m_config.m_bIsRocEnabled)
+        m_rocLogger.WriteRoc(std::string(m_config.m_pOutputDirectory) + "/roc.tsv", m_config.m_pRocScoreField);
+    
     duration = std::difftime(std::time(0), start1);
     std::cout << "Processing Chromosomes completed in " << duration << " secs" << std::endl;
     duration = std::difftime(std::time(0), start);
@@ -119,301 +138,383 @@ int CVcfAnalyzer::AssignJobsToThreads(int a_nThreadCount)
     m_aBestPaths = std::vector<core::CPath>(chromosomeListToProcess.size());
     m_aBestPathsAllele = std::vector<core::CPath>(chromosomeListToProcess.size());
     
-    int exactThreadCount = std::min(a_nThreadCount, (int)chromosomeListToProcess.size());
-        
-    //Allocate threads
-    m_pThreadPool = new std::thread[exactThreadCount];
-    
-    int threadPoolIt = 0;
-    std::vector<SChrIdTuple> *chromosomeLists = new std::vector<SChrIdTuple>[exactThreadCount];
+    //Each chromosome is logged to its own entry, threads do not share any statistic data
+    m_resultLogger.SetChromosomeCount(static_cast<int>(chromosomeListToProcess.size()));
+    for(CResultLog& stratifiedLogger : m_aStratifiedLoggers)
+        stratifiedLogger.SetChromosomeCount(static_cast<int>(chromosomeListToProcess.size()));
+    m_rocLogger.SetChromosomeCount(static_cast<int>(chromosomeListToProcess.size()));
     
-    //Divide tasks into threads
-    for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
+    //Estimated cost of each chromosome. Denser chromosomes have longer sync regions and are replayed slower
+    std::vector<double> taskCosts;
+    for(const SChrIdTuple& tuple : chromosomeListToProcess)
     {
-        chromosomeLists[threadPoolIt].push_back(chromosomeListToProcess[k]);
-        threadPoolIt = (threadPoolIt+1) % exactThreadCount;
+        std::vector<const CVariant*> varListBase = m_provider.GetVariantList(eBASE, tuple.m_nBaseId);
+        std::vector<const CVariant*> varListCalled = m_provider.GetVariantList(eCALLED, tuple.m_nCalledId);
+        int spanStart = INT_MAX;
+        int spanEnd = 0;
+        for(const std::vector<const CVariant*>* pVarList : {&varListBase, &varListCalled})
+        {
+            if(pVarList->empty())
+                continue;
+            spanStart = std::min(spanStart, pVarList->front()->m_nStartPos);
+            spanEnd = std::max(spanEnd, pVarList->back()->m_nEndPos);
+        }
+        taskCosts.push_back(CTaskScheduler::EstimateCost(static_cast<int>(varListBase.size() + varListCalled.size()), spanEnd - spanStart));
     }
     
-    //Assign divided task to the threads
-    for(int k = 0; k < exactThreadCount; k++)
+    CTaskScheduler scheduler(taskCosts, a_nThreadCount);
+    
+    scheduler.Run([&](int a_nTask, int a_nWorkerId)
     {
+        //Read ahead the reference of current and upcoming contigs of this worker while this one is replayed
+        std::vector<std::string> chrNames(1, chromosomeListToProcess[a_nTask].m_chrName);
+        for(int task : scheduler.GetQueuedTasks(a_nWorkerId))
+            chrNames.push_back(chromosomeListToProcess[task].m_chrName);
+        m_provider.PrefetchContigs(chrNames, m_config.m_nPrefetchWindowSize);
+        
         if(0 == strcmp("SPLIT", m_config.m_pOutputMode))
-            m_pThreadPool[k] = std::thread(&CVcfAnalyzer::ThreadFunctionSPLIT, this, chromosomeLists[k], m_config.m_bIsGenotypeMatch);
+            ProcessChromosomeSPLIT(chromosomeListToProcess[a_nTask], m_config.m_bIsGenotypeMatch);
         else
-            m_pThreadPool[k] = std::thread(&CVcfAnalyzer::ThreadFunctionGA4GH, this, chromosomeLists[k]);
-    }
-    
-    for(int k = 0; k < exactThreadCount; k++)
-        m_pThreadPool[k].join();
-
-    //Clear allocated memory
-    delete[] chromosomeLists;
-    delete[] m_pThreadPool;
+            ProcessChromosomeGA4GH(chromosomeListToProcess[a_nTask]);
+    });
 
-    return exactThreadCount;
+    return scheduler.GetThreadCount();
 }
 
 
-void CVcfAnalyzer::ThreadFunctionGA4GH(std::vector<SChrIdTuple> a_aTuples)
+void CVcfAnalyzer::ProcessChromosomeGA4GH(const SChrIdTuple& a_rTuple)
 {
-    for(unsigned int k = 0; k < a_aTuples.size(); k++)
+    std::vector<const CVariant*> varListBase = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId);
+    std::vector<const CVariant*> varListCalled = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId);
+    std::vector<const core::COrientedVariant*> ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_rTuple.m_nBaseId, true);
+    std::vector<const core::COrientedVariant*> ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_rTuple.m_nCalledId, true);
+    
+    core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+    pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
+    SContig ctg;
+    bool IsContigAvailable = m_provider.ReadContig(a_rTuple.m_chrName, ctg);
+    if(false == IsContigAvailable)
     {
-        std::vector<const CVariant*> varListBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId);
-        std::vector<const CVariant*> varListCalled = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId);
-        std::vector<const core::COrientedVariant*> ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, true);
-        std::vector<const core::COrientedVariant*> ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, true);
-        
-        core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
-        pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
-        SContig ctg;
-        mtx.lock();
-        bool IsContigAvailable = m_provider.ReadContig(a_aTuples[k].m_chrName, ctg);
-        if(false == IsContigAvailable)
-        {
-            std::cerr << "Contig " << a_aTuples[k].m_chrName << " is not available in given FASTA file!" << std::endl;
-            mtx.unlock();
-            continue;
-        }
-        mtx.unlock();
-        
-        //Check if the FASTA file covers all variants in VCF file
-        if(ctg.m_nRefLength < varListBase[varListBase.size()-1]->m_nEndPos || ctg.m_nRefLength < varListCalled[varListCalled.size()-1]->m_nEndPos)
-        {
-            std::cerr << "Not all variants are in the Range of FASTA reference! Skipping Contig: " << ctg.m_chromosomeName << std::endl;
-            continue;
-        }
-        
-        //Find Best Path [GENOTYPE MATCH]
-        m_aBestPaths[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg,true);
-        
-        //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Fill oriented variants for allele match
-        m_provider.FillAlleleMatchVariantList(a_aTuples[k], excludedVarsBase, excludedVarsCall);
-        
-        //Clear old variant pointers
-        ovarListBase.clear();
-        ovarListCalled.clear();
-        varListBase.clear();
-        varListCalled.clear();
-        
-        //Set new variant pointers for allele match comparison
-        varListBase = excludedVarsBase;
-        varListCalled = excludedVarsCall;
-        ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, false);
-        ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, false);
-        pathReplay.Clear();
-        
-        //Find Best Path [ALLELE MATCH]
-        m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg, false);
-        
-        //No Match variants
-        std::vector<const CVariant*> excludedVarsBase2 = m_provider.GetVariantList(excludedVarsBase,
-                                                                                   m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall2 = m_provider.GetVariantList(excludedVarsCall,
-                                                                                   m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Allele Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase2 = m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall2 = m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
-        
-        mtx.lock();
-        m_resultLogger.LogStatistic(a_aTuples[k].m_chrName,
-                                    a_aTuples[k].m_nBaseId,
-                                    static_cast<int>(includedVarsCall.size()),
-                                    static_cast<int>(includedVarsBase.size()),
-                                    static_cast<int>(includedVarsCall2.size()),
-                                    static_cast<int>(includedVarsBase2.size()),
-                                    static_cast<int>(excludedVarsCall2.size()),
-                                    static_cast<int>(excludedVarsBase2.size()));
-        mtx.unlock();
-        
-        m_provider.SetVariantStatus(excludedVarsBase2, eNO_MATCH);
-        m_provider.SetVariantStatus(excludedVarsCall2, eNO_MATCH);
-        m_provider.SetVariantStatus(includedVarsCall,  eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(includedVarsBase,  eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(includedVarsCall2, eALLELE_MATCH);
-        m_provider.SetVariantStatus(includedVarsBase2, eALLELE_MATCH);
-        
-        if(!ctg.Clean())
-        {
-            std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
-        }
-        
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FP_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsCall);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_BASE_") + std::to_string(a_nChrArr[k] +1) + std::string(".txt")  , includedVarsBase);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_CALLED_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , includedVarsCall);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FN_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsBase);
+        std::cerr << "Contig " << a_rTuple.m_chrName << " is not available in given FASTA file!" << std::endl;
+        return;
     }
+    
+    //Check if the FASTA file covers all variants in VCF file
+    if(ctg.m_nRefLength < varListBase[varListBase.size()-1]->m_nEndPos || ctg.m_nRefLength < varListCalled[varListCalled.size()-1]->m_nEndPos)
+    {
+        std::cerr << "Not all variants are in the Range of FASTA reference! Skipping Contig: " << ctg.m_chromosomeName << std::endl;
+        return;
+    }
+    
+    //Find Best Path [GENOTYPE MATCH]
+    m_aBestPaths[a_rTuple.m_nTupleIndex] = pathReplay.FindBestPath(ctg,true);
+    
+    //Genotype Match variants
+    const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+    
+    //Variants that will be passed for allele match check
+    std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
+    
+    //Fill oriented variants for allele match
+    m_provider.FillAlleleMatchVariantList(a_rTuple, excludedVarsBase, excludedVarsCall);
+    
+    //Clear old variant pointers
+    ovarListBase.clear();
+    ovarListCalled.clear();
+    varListBase.clear();
+    varListCalled.clear();
+    
+    //Set new variant pointers for allele match comparison
+    varListBase = excludedVarsBase;
+    varListCalled = excludedVarsCall;
+    ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_rTuple.m_nBaseId, false);
+    ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_rTuple.m_nCalledId, false);
+    pathReplay.Clear();
+    
+    //Find Best Path [ALLELE MATCH]
+    m_aBestPathsAllele[a_rTuple.m_nTupleIndex] = pathReplay.FindBestPath(ctg, false);
+    
+    //No Match variants
+    std::vector<const CVariant*> excludedVarsBase2 = m_provider.GetVariantList(excludedVarsBase,
+                                                                               m_aBestPathsAllele[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> excludedVarsCall2 = m_provider.GetVariantList(excludedVarsCall,
+                                                                               m_aBestPathsAllele[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
+    
+    //Allele Match variants
+    const std::vector<const core::COrientedVariant*>& includedVarsBase2 = m_aBestPathsAllele[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& includedVarsCall2 = m_aBestPathsAllele[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+    
+    m_resultLogger.LogStatistic(a_rTuple.m_nTupleIndex,
+                                a_rTuple.m_chrName,
+                                a_rTuple.m_nBaseId,
+                                static_cast<int>(includedVarsCall.size()),
+                                static_cast<int>(includedVarsBase.size()),
+                                static_cast<int>(includedVarsCall2.size()),
+                                static_cast<int>(includedVarsBase2.size()),
+                                static_cast<int>(excludedVarsCall2.size()),
+                                static_cast<int>(excludedVarsBase2.size()));
+    
+    if(m_config.m_bIsStratificationEnabled)
+        LogStratifiedStatistic(a_rTuple, includedVarsCall, includedVarsBase, includedVarsCall2, includedVarsBase2, excludedVarsCall2, excludedVarsBase2);
+    
+    //ROC is generated for genotype match, allele matches are counted as FP/FN as in the genotype table of log.txt
+    if(m_config.m_bIsRocEnabled)
+        LogRocStatistic(a_rTuple, includedVarsCall, includedVarsBase, excludedVarsCall, static_cast<int>(excludedVarsBase.size()));
+    
+    m_provider.SetVariantStatus(excludedVarsBase2, eNO_MATCH);
+    m_provider.SetVariantStatus(excludedVarsCall2, eNO_MATCH);
+    m_provider.SetVariantStatus(includedVarsCall,  eGENOTYPE_MATCH);
+    m_provider.SetVariantStatus(includedVarsBase,  eGENOTYPE_MATCH);
+    m_provider.SetVariantStatus(includedVarsCall2, eALLELE_MATCH);
+    m_provider.SetVariantStatus(includedVarsBase2, eALLELE_MATCH);
+    
+    if(!ctg.Clean())
+    {
+        std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
+    }
+    
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FP_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsCall);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_BASE_") + std::to_string(a_nChrArr[k] +1) + std::string(".txt")  , includedVarsBase);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_CALLED_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , includedVarsCall);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FN_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsBase);
 }
 
-void CVcfAnalyzer::ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool a_bIsGenotypeMatch)
+void CVcfAnalyzer::ProcessChromosomeSPLIT(const SChrIdTuple& a_rTuple, bool a_bIsGenotypeMatch)
 {
-    for(unsigned int k = 0; k < a_aTuples.size(); k++)
+    std::vector<const CVariant*> varListBase = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId);
+    std::vector<const CVariant*> varListCalled = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId);
+    
+    std::vector<const core::COrientedVariant*> ovarListBase;
+    std::vector<const core::COrientedVariant*> ovarListCalled;
+    
+    if(!a_bIsGenotypeMatch)
     {
-        std::vector<const CVariant*> varListBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId);
-        std::vector<const CVariant*> varListCalled = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId);
-        
-        std::vector<const core::COrientedVariant*> ovarListBase;
-        std::vector<const core::COrientedVariant*> ovarListCalled;
-        
-        if(!a_bIsGenotypeMatch)
-        {
-            //Fill oriented variants for allele match
-            m_provider.FillAlleleMatchVariantList(a_aTuples[k], varListBase, varListCalled);
-        }
-        
-        ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, a_bIsGenotypeMatch);
-        ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, a_bIsGenotypeMatch);
-        
-        core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
-        pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
-        
-        SContig ctg;
-        mtx.lock();
-        bool IsContigAvailable = m_provider.ReadContig(a_aTuples[k].m_chrName, ctg);
-        if(false == IsContigAvailable)
-        {
-            std::cerr << "Contig " << a_aTuples[k].m_chrName << " is not available in given FASTA file!" << std::endl;
-            mtx.unlock();
-            continue;
-        }
-        mtx.unlock();
-        
-        //Check if the FASTA file covers all variants in VCF file
-        if(ctg.m_nRefLength < varListBase[varListBase.size()-1]->m_nEndPos || ctg.m_nRefLength < varListCalled[varListCalled.size()-1]->m_nEndPos)
-        {
-            std::cerr << "Not all variants are in the Range of FASTA reference! Skipping Contig: " << ctg.m_chromosomeName << std::endl;
-        }
-        
-        m_aBestPaths[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg,a_bIsGenotypeMatch);
-        
-        //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
-        
-        mtx.lock();
-        m_resultLogger.LogStatistic(a_aTuples[k].m_chrName,
-                                    a_aTuples[k].m_nBaseId,
-                                    static_cast<int>(includedVarsCall.size()),
-                                    static_cast<int>(includedVarsBase.size()),
-                                    static_cast<int>(0),
-                                    static_cast<int>(0),
-                                    static_cast<int>(excludedVarsCall.size()),
-                                    static_cast<int>(excludedVarsBase.size()));
-        mtx.unlock();
-        
-        EVariantMatch match = a_bIsGenotypeMatch ? eGENOTYPE_MATCH : eALLELE_MATCH;
-        m_provider.SetVariantStatus(excludedVarsBase, eNO_MATCH);
-        m_provider.SetVariantStatus(excludedVarsCall, eNO_MATCH);
-        m_provider.SetVariantStatus(includedVarsCall,  match);
-        m_provider.SetVariantStatus(includedVarsBase,  match);
-        
-        if(!ctg.Clean())
-        {
-            std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
-        }
-        
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FP_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsCall);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_BASE_") + std::to_string(a_nChrArr[k] +1) + std::string(".txt")  , includedVarsBase);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_CALLED_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , includedVarsCall);
-        //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FN_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsBase);
+        //Fill oriented variants for allele match
+        m_provider.FillAlleleMatchVariantList(a_rTuple, varListBase, varListCalled);
+    }
+    
+    ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_rTuple.m_nBaseId, a_bIsGenotypeMatch);
+    ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_rTuple.m_nCalledId, a_bIsGenotypeMatch);
+    
+    core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+    pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
+    
+    SContig ctg;
+    bool IsContigAvailable = m_provider.ReadContig(a_rTuple.m_chrName, ctg);
+    if(false == IsContigAvailable)
+    {
+        std::cerr << "Contig " << a_rTuple.m_chrName << " is not available in given FASTA file!" << std::endl;
+        return;
+    }
+    
+    //Check if the FASTA file covers all variants in VCF file
+    if(ctg.m_nRefLength < varListBase[varListBase.size()-1]->m_nEndPos || ctg.m_nRefLength < varListCalled[varListCalled.size()-1]->m_nEndPos)
+    {
+        std::cerr << "Not all variants are in the Range of FASTA reference! Skipping Contig: " << ctg.m_chromosomeName << std::endl;
+    }
+    
+    m_aBestPaths[a_rTuple.m_nTupleIndex] = pathReplay.FindBestPath(ctg,a_bIsGenotypeMatch);
+    
+    //Genotype Match variants
+    const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+    
+    //Variants that will be passed for allele match check
+    std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
+    
+    m_resultLogger.LogStatistic(a_rTuple.m_nTupleIndex,
+                                a_rTuple.m_chrName,
+                                a_rTuple.m_nBaseId,
+                                static_cast<int>(includedVarsCall.size()),
+                                static_cast<int>(includedVarsBase.size()),
+                                static_cast<int>(0),
+                                static_cast<int>(0),
+                                static_cast<int>(excludedVarsCall.size()),
+                                static_cast<int>(excludedVarsBase.size()));
+    
+    if(m_config.m_bIsStratificationEnabled)
+        LogStratifiedStatistic(a_rTuple, includedVarsCall, includedVarsBase, {}, {}, excludedVarsCall, excludedVarsBase);
+    
+    if(m_config.m_bIsRocEnabled)
+        LogRocStatistic(a_rTuple, includedVarsCall, includedVarsBase, excludedVarsCall, static_cast<int>(excludedVarsBase.size()));
+    
+    EVariantMatch match = a_bIsGenotypeMatch ? eGENOTYPE_MATCH : eALLELE_MATCH;
+    m_provider.SetVariantStatus(excludedVarsBase, eNO_MATCH);
+    m_provider.SetVariantStatus(excludedVarsCall, eNO_MATCH);
+    m_provider.SetVariantStatus(includedVarsCall,  match);
+    m_provider.SetVariantStatus(includedVarsBase,  match);
+    
+    if(!ctg.Clean())
+    {
+        std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
     }
+    
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FP_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsCall);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_BASE_") + std::to_string(a_nChrArr[k] +1) + std::string(".txt")  , includedVarsBase);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("TP_CALLED_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , includedVarsCall);
+    //PrintVariants(std::string(m_config.m_pOutputDirectory), std::string("FN_") + std::to_string(a_nChrArr[k] + 1) + std::string(".txt")  , excludedVarsBase);
 }
 
-void CVcfAnalyzer::CalculateSyncPointList(const SChrIdTuple& a_rTuple, std::vector<core::CSyncPoint>& a_rSyncPointList)
+void CVcfAnalyzer::CalculateSyncIntervals(const SChrIdTuple& a_rTuple, std::vector<SSyncInterval>& a_rIntervalList)
 {
-    std::vector<const core::COrientedVariant*> pBaseIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-    std::vector<const core::COrientedVariant*> pCalledIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();;
+    const std::vector<const core::COrientedVariant*>& pBaseIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& pCalledIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
     
     std::vector<const CVariant*> pBaseExcluded = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
     std::vector<const CVariant*> pCalledExcluded = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
     
-    core::CPath *pPath = &m_aBestPaths[a_rTuple.m_nTupleIndex];
+    const std::vector<int>& syncPoints = m_aBestPaths[a_rTuple.m_nTupleIndex].m_aSyncPointList;
     
     unsigned int baseIncludedItr = 0;
     unsigned int baseExcludedItr = 0;
     unsigned int calledIncludedItr = 0;
     unsigned int calledExcludedItr = 0;
-
-    for(unsigned int k = 0; k < pPath->m_aSyncPointList.size(); k++)
+    
+    //Extends the id range of a side with the given variant id
+    auto addId = [](int32_t& a_rFirstId, int32_t& a_rLastId, int a_nId)
     {
-        core::CSyncPoint ssPoint;
-        ssPoint.m_nStartPosition = k > 0 ? pPath->m_aSyncPointList[k-1] : 0;
-        ssPoint.m_nEndPosition = pPath->m_aSyncPointList[k];
-        ssPoint.m_nIndex = (int)k;
-        
-        while(baseIncludedItr < pBaseIncluded.size() && pBaseIncluded[baseIncludedItr]->GetStartPos() <= pPath->m_aSyncPointList[k])
+        if(a_rFirstId == -1 || a_nId < a_rFirstId)
+            a_rFirstId = a_nId;
+        if(a_nId > a_rLastId)
+            a_rLastId = a_nId;
+    };
+    
+    //Last interval contains the remaining variants
+    for(unsigned int k = 0; k <= syncPoints.size(); k++)
+    {
+        SSyncInterval interval;
+        if(k < syncPoints.size())
         {
-            const core::COrientedVariant* pOvar = pBaseIncluded[baseIncludedItr];
-            ssPoint.m_baseVariantsIncluded.push_back(pOvar);
-            baseIncludedItr++;
+            interval.m_nStartPosition = k > 0 ? syncPoints[k-1] : 0;
+            interval.m_nEndPosition = syncPoints[k];
         }
-        
-        while(calledIncludedItr < pCalledIncluded.size() && pCalledIncluded[calledIncludedItr]->GetStartPos() <= pPath->m_aSyncPointList[k])
+        else
         {
-            const core::COrientedVariant* pOvar = pCalledIncluded[calledIncludedItr];
-            ssPoint.m_calledVariantsIncluded.push_back(pOvar);
-            calledIncludedItr++;
+            interval.m_nStartPosition = syncPoints.empty() ? 0 : syncPoints[k-1];
+            interval.m_nEndPosition = INT_MAX;
         }
+        interval.m_nBaseFirstId = interval.m_nBaseLastId = -1;
+        interval.m_nCalledFirstId = interval.m_nCalledLastId = -1;
         
-        while(baseExcludedItr < pBaseExcluded.size() && pBaseExcluded[baseExcludedItr]->m_nStartPos <= pPath->m_aSyncPointList[k])
-        {
-            ssPoint.m_baseVariantsExcluded.push_back(pBaseExcluded[baseExcludedItr]);
-            baseExcludedItr++;
-        }
+        while(baseIncludedItr < pBaseIncluded.size() && pBaseIncluded[baseIncludedItr]->GetStartPos() <= interval.m_nEndPosition)
+            addId(interval.m_nBaseFirstId, interval.m_nBaseLastId, pBaseIncluded[baseIncludedItr++]->GetVariant().m_nId);
         
-        while(calledExcludedItr < pCalledExcluded.size() && pCalledExcluded[calledExcludedItr]->m_nStartPos <= pPath->m_aSyncPointList[k])
-        {
-            ssPoint.m_calledVariantsExcluded.push_back(pCalledExcluded[calledExcludedItr]);
-            calledExcludedItr++;
-        }
+        while(calledIncludedItr < pCalledIncluded.size() && pCalledIncluded[calledIncludedItr]->GetStartPos() <= interval.m_nEndPosition)
+            addId(interval.m_nCalledFirstId, interval.m_nCalledLastId, pCalledIncluded[calledIncludedItr++]->GetVariant().m_nId);
+        
+        while(baseExcludedItr < pBaseExcluded.size() && pBaseExcluded[baseExcludedItr]->m_nStartPos <= interval.m_nEndPosition)
+            addId(interval.m_nBaseFirstId, interval.m_nBaseLastId, pBaseExcluded[baseExcludedItr++]->m_nId);
+        
+        while(calledExcludedItr < pCalledExcluded.size() && pCalledExcluded[calledExcludedItr]->m_nStartPos <= interval.m_nEndPosition)
+            addId(interval.m_nCalledFirstId, interval.m_nCalledLastId, pCalledExcluded[calledExcludedItr++]->m_nId);
         
-        a_rSyncPointList.push_back(ssPoint);
+        a_rIntervalList.push_back(interval);
     }
+}
+
+
+void CVcfAnalyzer::LogStratifiedStatistic(const SChrIdTuple& a_rTuple,
+                                          const std::vector<const core::COrientedVariant*>& a_rTpCalled,
+                                          const std::vector<const core::COrientedVariant*>& a_rTpBase,
+                                          const std::vector<const core::COrientedVariant*>& a_rHalfTpCalled,
+                                          const std::vector<const core::COrientedVariant*>& a_rHalfTpBase,
+                                          const std::vector<const CVariant*>& a_rFp,
+                                          const std::vector<const CVariant*>& a_rFn)
+{
+    const int stratumCount = m_stratificationIndex.GetStratumCount();
     
-    //Add Remaining variants to the last syncPoint
-    core::CSyncPoint sPoint;
-    sPoint.m_nStartPosition = pPath->m_aSyncPointList[pPath->m_aSyncPointList.size()-1];
-    sPoint.m_nEndPosition = INT_MAX;
-    sPoint.m_nIndex = static_cast<int>(pPath->m_aSyncPointList.size()-1);
+    //Counts of each stratum: TPcalled, TPbase, HalfTPcalled, HalfTPbase, FP, FN
+    std::vector<int> counts(stratumCount * 6, 0);
     
-    while(baseIncludedItr < pBaseIncluded.size() && pBaseIncluded[baseIncludedItr]->GetStartPos() <= sPoint.m_nEndPosition)
+    const SStratifiedContig* pContig = m_stratificationIndex.GetContig(a_rTuple.m_chrName);
+    
+    //A variant belongs to a stratum if its original (0-based) position is inside one of the stratum regions
+    auto countVariant = [&](const CVariant& a_rVariant, int a_nColumn)
     {
-        sPoint.m_baseVariantsIncluded.push_back(pBaseIncluded[baseIncludedItr]);
-        baseIncludedItr++;
-    }
-    while(calledIncludedItr < pCalledIncluded.size() && pCalledIncluded[calledIncludedItr]->GetStartPos() <= sPoint.m_nEndPosition)
+        const int* pBegin;
+        const int* pEnd;
+        CStratificationIndex::GetStrata(*pContig, a_rVariant.m_nOriginalPos, pBegin, pEnd);
+        for(const int* pStratum = pBegin; pStratum != pEnd; pStratum++)
+            counts[*pStratum * 6 + a_nColumn]++;
+    };
+    
+    if(pContig != NULL)
     {
-        sPoint.m_calledVariantsIncluded.push_back(pCalledIncluded[calledIncludedItr]);
-        calledIncludedItr++;
+        for(const core::COrientedVariant* pOvar : a_rTpCalled)
+            countVariant(pOvar->GetVariant(), 0);
+        for(const core::COrientedVariant* pOvar : a_rTpBase)
+            countVariant(pOvar->GetVariant(), 1);
+        for(const core::COrientedVariant* pOvar : a_rHalfTpCalled)
+            countVariant(pOvar->GetVariant(), 2);
+        for(const core::COrientedVariant* pOvar : a_rHalfTpBase)
+            countVariant(pOvar->GetVariant(), 3);
+        for(const CVariant* pVar : a_rFp)
+            countVariant(*pVar, 4);
+        for(const CVariant* pVar : a_rFn)
+            countVariant(*pVar, 5);
     }
     
-    while(baseExcludedItr < pBaseExcluded.size() && pBaseExcluded[baseExcludedItr]->m_nStartPos <= sPoint.m_nEndPosition)
+    for(int stratumId = 0; stratumId < stratumCount; stratumId++)
     {
-        sPoint.m_baseVariantsExcluded.push_back(pBaseExcluded[baseExcludedItr]);
-        baseExcludedItr++;
+        const int* pCount = &counts[stratumId * 6];
+        m_aStratifiedLoggers[stratumId].LogStatistic(a_rTuple.m_nTupleIndex, a_rTuple.m_chrName, a_rTuple.m_nBaseId, pCount[0], pCount[1], pCount[2], pCount[3], pCount[4], pCount[5]);
     }
+}
+
+void CVcfAnalyzer::LogRocStatistic(const SChrIdTuple& a_rTuple,
+                                   const std::vector<const core::COrientedVariant*>& a_rTpCalled,
+                                   const std::vector<const core::COrientedVariant*>& a_rTpBase,
+                                   const std::vector<const CVariant*>& a_rFp,
+                                   int a_nFalseNegative)
+{
+    const float missingScore = -std::numeric_limits<float>::infinity();
+    auto getScore = [missingScore](const CVariant& a_rVariant){ return std::isnan(a_rVariant.m_fScore) ? missingScore : a_rVariant.m_fScore; };
+    
+    //Sync region of a variant is the first region whose end is not smaller than the variant start (same as sync interval output)
+    const std::vector<int>& syncPoints = m_aBestPaths[a_rTuple.m_nTupleIndex].m_aSyncPointList;
+    auto getRegion = [&syncPoints](int a_nStartPos){ return std::lower_bound(syncPoints.begin(), syncPoints.end(), a_nStartPos) - syncPoints.begin(); };
+    
+    std::vector<SRocBin> bins;
+    bins.reserve(a_rTpCalled.size() + a_rTpBase.size() + a_rFp.size());
     
-    while(calledExcludedItr < pCalledExcluded.size() && pCalledExcluded[calledExcludedItr]->m_nStartPos <= sPoint.m_nEndPosition)
+    //Minimum called TP score of each sync region
+    std::vector<float> regionScores(syncPoints.size() + 1, std::numeric_limits<float>::infinity());
+    for(const core::COrientedVariant* pOvar : a_rTpCalled)
     {
-        sPoint.m_calledVariantsExcluded.push_back(pCalledExcluded[calledExcludedItr]);
-        calledExcludedItr++;
+        float score = getScore(pOvar->GetVariant());
+        float& regionScore = regionScores[getRegion(pOvar->GetStartPos())];
+        regionScore = std::min(regionScore, score);
+        bins.push_back({score, 1, 0, 0});
     }
-    a_rSyncPointList.push_back(sPoint);
     
+    for(const core::COrientedVariant* pOvar : a_rTpBase)
+        bins.push_back({regionScores[getRegion(pOvar->GetStartPos())], 0, 1, 0});
+    
+    for(const CVariant* pVar : a_rFp)
+        bins.push_back({getScore(*pVar), 0, 0, 1});
+    
+    CRocLog::CompressBins(bins);
+    
+    m_rocLogger.LogChromosome(a_rTuple.m_nTupleIndex, bins, a_nFalseNegative);
 }
 
+void CVcfAnalyzer::WriteStratifiedStatistics(int a_nMode)
+{
+    std::ofstream outputLog;
+    outputLog.open(std::string(m_config.m_pOutputDirectory) + "/stratified_log.txt");
+    
+    for(int stratumId = 0; stratumId < m_stratificationIndex.GetStratumCount(); stratumId++)
+    {
+        outputLog << "###### STRATUM: " << m_stratificationIndex.GetStratumName(stratumId) << " ######" << std::endl;
+        m_aStratifiedLoggers[stratumId].WriteStatistics(a_nMode, outputLog);
+        outputLog << std::endl << std::endl;
+    }
+    
+    outputLog.close();
+}
 
 void CVcfAnalyzer::PrintVariants(std::string a_outputDirectory, std::string a_FileName, const std::vector<const core::COrientedVariant*>& a_rOvarList) const
 {
@@ -467,6 +568,15 @@ bool CVcfAnalyzer::ReadParameters(int argc, char** argv)
     const char* PARAM_MAX_PATH_SIZE = "-max-path-size";
     const char* PARAM_MAX_ITERATION_COUNT = "-max-iteration-count";
     const char* PARAM_MAX_BP_LENGTH = "-max-bp-length";
+    const char* PARAM_VARIANT_CACHE = "-variant-cache";
+    const char* PARAM_REFERENCE_CACHE = "-reference-cache";
+    const char* PARAM_PREFETCH_WINDOW = "-prefetch-window";
+    const char* PARAM_OUTPUT_FORMAT = "-output-format";
+    const char* PARAM_COMPRESSION_LEVEL = "-compression-level";
+    const char* PARAM_PASS_THROUGH = "--pass-through";
+    const char* PARAM_SYNC_POINT_TEXT = "--sync-point-text";
+    const char* PARAM_STRATIFICATIONS = "-stratifications";
+    const char* PARAM_ROC = "-roc";
     
     bool bBaselineSet = false;
     bool bCalledSet = false;
@@ -592,7 +702,7 @@ bool CVcfAnalyzer::ReadParameters(int argc, char** argv)
         
         else if(0 == strcmp(argv[it], PARAM_THREAD_COUNT))
         {
-            m_config.m_nThreadCount = std::min(std::max(1, atoi(argv[it+1])), MAX_THREAD_COUNT);
+            m_config.m_nThreadCount = std::max(1, atoi(argv[it+1]));
             it+=2;
         }
         
@@ -626,6 +736,81 @@ bool CVcfAnalyzer::ReadParameters(int argc, char** argv)
             it+=2;
         }
         
+        else if(0 == strcmp(argv[it], PARAM_VARIANT_CACHE))
+        {
+            m_config.m_bUseVariantCache = true;
+            m_config.m_pVariantCacheDirectory = argv[it+1];
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_REFERENCE_CACHE))
+        {
+            m_config.m_bUseReferenceCache = true;
+            m_config.m_pReferenceCacheDirectory = argv[it+1];
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_PREFETCH_WINDOW))
+        {
+            m_config.m_nPrefetchWindowSize = std::max(0, atoi(argv[it+1]));
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_OUTPUT_FORMAT))
+        {
+            if(0 == strcmp(argv[it+1], "vcf.gz"))
+                m_config.m_outputFormat = eVCF_BGZF;
+            else if(0 == strcmp(argv[it+1], "bcf"))
+                m_config.m_outputFormat = eBCF;
+            else if(0 == strcmp(argv[it+1], "vcf"))
+                m_config.m_outputFormat = eVCF_TEXT;
+            else
+            {
+                std::cout << "Unknown output format: " << argv[it+1] << ". Output format is set to vcf" << std::endl;
+                m_config.m_outputFormat = eVCF_TEXT;
+            }
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_COMPRESSION_LEVEL))
+        {
+            m_config.m_nCompressionLevel = std::min(std::max(0, atoi(argv[it+1])), 9);
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_SYNC_POINT_TEXT))
+        {
+            m_config.m_bIsSyncPointTextEnabled = true;
+            it++;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_STRATIFICATIONS))
+        {
+            m_config.m_bIsStratificationEnabled = true;
+            m_config.m_pStratificationFile = argv[it+1];
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_ROC))
+        {
+            m_config.m_bIsRocEnabled = true;
+            m_config.m_pRocScoreField = argv[it+1];
+            
+            //Unknown score fields are rejected instead of falling back to QUAL
+            if(0 != strcmp(argv[it+1], "QUAL") && 0 != strncmp(argv[it+1], "INFO/", 5) && 0 != strncmp(argv[it+1], "FORMAT/", 7))
+            {
+                std::cerr << "Invalid score field " << argv[it+1] << ". Score field should be QUAL, INFO/<TAG> or FORMAT/<TAG>" << std::endl;
+                return false;
+            }
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_PASS_THROUGH))
+        {
+            m_config.m_bIsPassThrough = true;
+            it++;
+        }
+        
         else
             it++; //break;
     }
@@ -660,9 +845,18 @@ void CVcfAnalyzer::PrintHelp() const
     std::cout << "-sample-base <sample_name>   [Optional.Read only the given sample in base VCF. Default value is the first sample.]" << std::endl;
     std::cout << "-sample-called <sample_name> [Optional.Read only the given sample in called VCF. Default value is the first sample.]" << std::endl;
     std::cout << "--disable-ref-overlap        [Optional.Disable reference overlapping. Does not trim alleles]" << std::endl;
-    std::cout << "--generate-sync-point        [Optional.Prints the sync point list of two vcf file. Default value is false.]" << std::endl;
+    std::cout << "--generate-sync-point        [Optional.Writes the sync point intervals of two vcf file to SyncPointList.sync (binary). Default value is false.]" << std::endl;
+    std::cout << "--sync-point-text            [Optional.Also exports the sync point intervals as text to SyncPointList.txt]" << std::endl;
     std::cout << "--trim-endings-first         [Optional.If set, starts trimming variants from ending base pairs. Default is from beginning]" << std::endl;
     std::cout << "-thread-count                [Optional.Specify the number of threads that program will use. Default value is 2]" << std::endl;
+    std::cout << "-variant-cache <cache_dir>   [Optional.Store parsed/trimmed variants of each vcf in cache_dir and reuse them in later runs with the same input and parameters]" << std::endl;
+    std::cout << "-reference-cache <cache_dir> [Optional.Store the reference as a memory mapped cache file in cache_dir which is shared by all threads and later runs. Default is reading contigs from FASTA]" << std::endl;
+    std::cout << "-prefetch-window <size_mb>   [Optional.Read ahead the reference of upcoming contigs of each thread up to given size in MB. Requires -reference-cache. 0 disables prefetching. Default value is 512]" << std::endl;
+    std::cout << "-output-format <format>      [Optional.File format of the output vcfs. Possible values: vcf, vcf.gz (bgzipped + tabix index), bcf (+ csi index). Default value is vcf]" << std::endl;
+    std::cout << "-compression-level [0-9]     [Optional.Compression level of vcf.gz/bcf outputs. Default value is 6]" << std::endl;
+    std::cout << "-stratifications <tsv_path>  [Optional.Writes TP/FP/FN statistics per stratum to stratified_log.txt. Each line of the tsv is <stratum_name><TAB><bed_path>]" << std::endl;
+    std::cout << "-roc <score_field>           [Optional.Writes TP/FP/FN counts of all score thresholds to roc.tsv. Score field is QUAL, INFO/<TAG> or FORMAT/<TAG>]" << std::endl;
+    std::cout << "--pass-through               [Optional.SPLIT mode writes the original input records with all INFO/FORMAT fields instead of re-encoding GT only records]" << std::endl;
     std::cout << "-max-bp-length               [*Optional.Specify the maximum base pair length of variant to process. Default value is 1000]" << std::endl;
     std::cout << "-max-path-size <size>        [*Optional.Specify the maximum size of path that core algorithm can store inside. Default value is 150,000]" << std::endl;
     std::cout << "-max-iteration-count <count> [*Optional.Specify the maximum iteration count that core algorithm can decide to include/exclude variant. Default value is 10,000,000]" << std::endl;
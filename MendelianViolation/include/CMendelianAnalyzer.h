@@ -35,7 +35,7 @@
 #include "CMendelianDecider.h"
 #include "ENoCallMode.h"
 #include <thread>
-#include <mutex>
+#include <atomic>
 
 namespace mendelian
 {
@@ -61,15 +61,54 @@ public:
      */
     int run(int argc, char** argv);
     
+    ///Initializes the analyzer for a family of the decoded joint vcf (mendelian batch mode). Samples and comparisons are loaded/allocated by the caller
+    ///and they can be shared with other families. Output files are named by the prefix of the configs
+    bool InitializeFamily(const SConfig& a_rFatherChildConfig,
+                          const SConfig& a_rMotherChildConfig,
+                          ENoCallMode a_noCallMode,
+                          const CJointVcfStore& a_rJointVcf,
+                          const SMendelianSampleVariants* a_pMother,
+                          const SMendelianSampleVariants* a_pFather,
+                          const SMendelianSampleVariants* a_pChild,
+                          SParentChildComparison* a_pFatherChild,
+                          SParentChildComparison* a_pMotherChild);
+    
+    ///Returns the estimated costs of parent-child comparison tasks of all common chromosomes [task 2k: father-child, task 2k+1: mother-child of chromosome k]
+    std::vector<double> PrepareComparisonTasks();
+    
+    ///Returns the common chromosome of given comparison task
+    const SChrIdTriplet& GetTaskChromosome(int a_nTask);
+    
+    ///Runs a comparison task returned by PrepareComparisonTasks. The chromosome is decided by the worker which completes its last comparison. References of a_rQueuedTasks are prefetched
+    void RunComparisonTask(int a_nTask, const std::vector<int>& a_rQueuedTasks);
+    
+    ///Runs the parent-child comparison of a task returned by PrepareComparisonTasks without deciding its chromosome. References of given upcoming contigs are prefetched
+    void RunComparison(int a_nTask, const std::vector<std::string>& a_rUpcomingChrNames);
+    
+    ///Marks the comparison of given task as completed. The chromosome is decided if both of its comparisons are completed
+    void CompleteComparison(int a_nTask);
+    
+    ///Completes the trio vcf (chromosomes are written as they are decided) and writes the logs once all comparison tasks are completed
+    void WriteResults();
+    
 private:
     
     ///Read the parameters if the execution mode is mendelian. If all mandatory parameters are set, return true.
     bool ReadParameters(int argc, char** argv);
     
-    ///A Function to process mendelian violation pipeline for given chromosome id
-    void ProcessChromosome(const std::vector<SChrIdTriplet>& a_rChromosomeIds);
+    ///Sets up the trio writer and decider after the variants are read
+    void InitializeOutput();
+    
+    ///Runs the best path algorithm (genotype + allele match) between father-child or mother-child for given chromosome
+    void ProcessChromosome(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild);
+    
+    ///Merges the parent-child comparisons of given chromosome into mendelian decisions and passes them to the trio writer. Called once both comparisons are completed
+    void DecideChromosome(const SChrIdTriplet& a_rTriplet);
+    
+    ///Sends TP/FP/FN values of the best paths of father-child or mother-child comparison to the log entry of the chromosome
+    void LogBestPathStatistic(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild);
         
-    ///Divide the jobs between different threads homogeneously for given number of thread count. Return the actual thread count
+    ///Process the parent-child comparisons of each chromosome with the work-stealing scheduler (largest estimated cost first). Each chromosome is decided as soon as its comparisons are completed. Return the actual thread count
     int AssignJobsToThreads(int a_nThreadCount);
     
     ///Prints the help menu at console
@@ -96,16 +135,8 @@ private:
     ///Result log for mendelian comparison
     CMendelianResultLog m_resultLog;
     
-    //Best Paths written by each thread for each unique chromosome exists [Between father and child]
-    std::vector<core::CPath> m_aBestPathsFatherChildGT;
-    std::vector<core::CPath> m_aBestPathsFatherChildAM;
-    
-    //Best Paths written by each thread for each unique chromosome exists [Between mother and child]
-    std::vector<core::CPath> m_aBestPathsMotherChildGT;
-    std::vector<core::CPath> m_aBestPathsMotherChildAM;
-    
-    //To prevent data race in multi-thread mode
-    std::mutex mtx;
+    //Number of parent-child comparisons of each chromosome which are not completed yet
+    std::vector<std::atomic<int>> m_aRemainingComparisons;
 
 };
 
@@ -0,0 +1,124 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CMendelianBatchAnalyzer.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_MENDELIAN_BATCH_ANALYZER_H_
+#define _C_MENDELIAN_BATCH_ANALYZER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "SConfig.h"
+#include "ENoCallMode.h"
+#include "CJointVcfStore.h"
+#include "CSimplePEDParser.h"
+#include "CMendelianVariantProvider.h"
+
+namespace mendelian
+{
+
+/**
+ * @brief Mendelian violation detection of all trios of a cohort that are called into a single multi-sample vcf
+ *
+ * The joint vcf is decoded once and genotypes are fanned out to per-sample lists. Trios of the pedigree form a DAG of parent-child
+ * comparisons: variants of each sample are generated once and shared by all trios it belongs to (e.g. parents of siblings or a sample
+ * which is both a child and a parent), and each unique parent-child pair is compared once with its best paths and variant status shared
+ * by every trio which requires it. Families are processed in batches: all comparisons and decisions of the batch run on one shared worker
+ * pool, then trio vcf and reports of each family are written. Samples and comparisons are released once no unprocessed trio requires them.
+ */
+class CMendelianBatchAnalyzer
+{
+    
+public:
+    
+    /**
+     * @brief Executes the mendelian batch analyzer
+     * @param argc Total argument count entered via command line during execution
+     * @param argv List of arguments entered via command line during execution
+     */
+    int run(int argc, char** argv);
+    
+private:
+    
+    ///Read the parameters if the execution mode is mendelian-batch. If all mandatory parameters are set, return true.
+    bool ReadParameters(int argc, char** argv);
+    
+    ///Processes the families [a_nStart, a_nEnd) of the trio list on the shared worker pool and writes their outputs
+    void ProcessFamilyBatch(int a_nStart, int a_nEnd);
+    
+    ///Generates the variants of the samples of given families which are not loaded yet on the worker pool
+    void LoadSamples(int a_nStart, int a_nEnd);
+    
+    ///Returns the comparison between given parent and child samples. The comparison is allocated if it is not found
+    SParentChildComparison* GetComparison(int a_nParentIndex, int a_nChildIndex);
+    
+    ///Prints the help menu at console
+    void PrintHelp() const;
+    
+    ///Config shared by all families. Vcf paths and output prefix are set per family
+    SConfig m_config;
+    
+    ///No call mode of the variant
+    ENoCallMode m_noCallMode = ENoCallMode::eExplicitNoCall;
+    
+    ///Number of families that are kept in memory and processed together
+    int m_nFamilyBatchSize = 0;
+    
+    ///Decoded joint vcf
+    CJointVcfStore m_jointVcf;
+    
+    ///Trios found in the pedigree whose members are in the joint vcf
+    std::vector<SFamilyTrio> m_aTrios;
+    
+    ///Output prefix of each trio (configs point to these strings)
+    std::vector<std::string> m_aOutputPrefixes;
+    
+    ///Name of each sample of the joint vcf [joint sample index]
+    std::vector<std::string> m_aSampleNames;
+    
+    ///Number of unprocessed trios that each sample of joint vcf belongs to. Variants of a sample are released when it reaches 0
+    std::vector<int> m_aSampleUseCounts;
+    
+    ///Variants of the samples, loaded once for all trios that they belong to [joint sample index]
+    std::vector<std::unique_ptr<SMendelianSampleVariants>> m_aSamples;
+    
+    ///Parent-child comparison of the pedigree which is shared by all trios that contain the pair
+    struct SPedigreeComparison
+    {
+        SParentChildComparison m_comparison;
+        ///Chromosomes whose best paths are already computed [child chromosome id]
+        std::vector<char> m_aIsCompared;
+        ///Number of unprocessed trios that require the comparison
+        int m_nUseCount = 0;
+    };
+    
+    ///Unique parent-child comparisons of the pedigree [(parent sample index, child sample index)]
+    std::map<std::pair<int, int>, std::unique_ptr<SPedigreeComparison>> m_comparisons;
+    
+    ///Generates the variants of the samples from the joint vcf
+    CMendelianVariantProvider m_sampleLoader;
+};
+
+}
+
+#endif // _C_MENDELIAN_BATCH_ANALYZER_H_
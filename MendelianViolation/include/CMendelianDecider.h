@@ -31,6 +31,7 @@
 #include "EMendelianDecision.h"
 #include "ENoCallMode.h"
 #include "CSyncPoint.h"
+#include "SVariantSpan.h"
 
 namespace mendelian
 {
@@ -45,27 +46,25 @@ namespace mendelian
  * CMendelianDecider gets the result of for parent-child comparison(both allele and genotype matches) as input
  * and performs the intersection operation of child variant sets obtained from mother-child side and father-child side.
  * It also have separate functions to deal with variants contains reference allele
+ * The decider only reads the best paths and variants, all intermediate state is local to the call. Different chromosomes can be decided concurrently.
+ * Intermediate sets of child variants are kept as arrays indexed by variant id so no pointer list is sorted or merged
  */
 class CMendelianDecider
 {
     
 public:
     
-    CMendelianDecider(std::vector<core::CPath>& a_aBestPathsFatherChildGT,
-                      std::vector<core::CPath>& a_aBestPathsFatherChildAM,
-                      std::vector<core::CPath>& a_aBestPathsMotherChildGT,
-                      std::vector<core::CPath>& a_aBestPathsMotherChildAM,
-                      CMendelianVariantProvider& a_rProvider,
-                      CMendelianResultLog& a_rResultLog);
+    ///Best paths of parent-child comparisons are read from the comparisons of the provider
+    CMendelianDecider(const CMendelianVariantProvider& a_rProvider, CMendelianResultLog& a_rResultLog);
     
     ///Sets the nocall mode selected
     void SetNocallMode(ENoCallMode a_nMode);
     
     ///A function that perform merge operations after best path algorith for mother-child and father-child are called
-    void MergeFunc(SChrIdTriplet& a_rTriplet,
+    void MergeFunc(const SChrIdTriplet& a_rTriplet,
                    std::vector<EMendelianDecision>& a_rMotherDecisions,
                    std::vector<EMendelianDecision>& a_rFatherDecisions,
-                   std::vector<EMendelianDecision>& a_rChildDecisions);
+                   std::vector<EMendelianDecision>& a_rChildDecisions) const;
     
     ///Return the decision lists of requested sample and chromosome
     std::vector<EMendelianDecision> GetDecisionList(EMendelianVcfName a_checkSide, const SChrIdTriplet& a_rTriplet) const;
@@ -76,64 +75,57 @@ private:
     ///Eliminates same allele match exception
     void EliminateSameAlleleMatch(CVariantIterator& a_rMotherChildVariants,
                                   CVariantIterator& a_rFatherChildVariants,
-                                  std::vector<const CVariant*>& a_rViolationVars,
-                                  std::vector<const CVariant*>& a_rMendelianCompliantVars,
-                                  std::vector<const CVariant*>& a_rCheck0atMotherSide,
-                                  std::vector<const CVariant*>& a_rCheck0atFatherSide);
+                                  std::vector<EMendelianDecision>& a_rChildDecisions,
+                                  std::vector<bool>& a_rCheck0atMotherSide,
+                                  std::vector<bool>& a_rCheck0atFatherSide) const;
     
-    //Fint the unique child variant list (write the list into the last parameter)
-    void FindUniqueChildVariantList(std::vector<const CVariant*> a_rChildVariants,
-                                    const std::vector<const CVariant*>& a_rViolationVars,
-                                    const std::vector<const CVariant*>& a_rCompliantVars,
-                                    std::vector<const CVariant*>& a_rChildUniqueList);
+    ///Mark child variants which are not decided by any of the parent-child comparisons as violation
+    void MarkUniqueChildVariants(std::vector<EMendelianDecision>& a_rChildDecisions) const;
     
     ///Return the syncpointlist for given comparison. Writes to the last parameter
-    void GetSyncPointList(SChrIdTriplet& a_rTriplet,
+    void GetSyncPointList(const SChrIdTriplet& a_rTriplet,
                           bool a_bIsFatherChild,
                           std::vector<core::CSyncPoint>& a_rSyncPointList,
-                          bool a_bIsGT = false);
+                          bool a_bIsGT = false) const;
     
     ///Check sync points which child excluded contains 0 Allele variant. If that 0 allele is playable for the parent, we mark variants as compliant, violation otherwise
-    void CheckFor0Path(SChrIdTriplet& a_rTriplet,
+    ///Child variants to check are marked by variant id in a_rCheck0Variants
+    void CheckFor0Path(const SChrIdTriplet& a_rTriplet,
                        bool a_bIsFatherChild,
-                       std::vector<const CVariant*>& a_rOvarList,
-                       std::vector<const CVariant*>& a_rViolationList,
-                       std::vector<const CVariant*>& a_rCompliantList,
+                       const std::vector<bool>& a_rCheck0Variants,
+                       std::vector<EMendelianDecision>& a_rChildDecisions,
                        std::vector<EMendelianDecision>& a_rParentDecisions,
-                       bool a_bIsUpdateDecisionList = true);
+                       bool a_bIsUpdateDecisionList = true) const;
         
-    ///Check each unique vars and seek for 0 path at the requested side and fills the a_rSideDecisionList
+    ///Check each parent variant excluded from both best paths and seek for 0 path at the requested side. Decisions are written to a_rParentSelfDecisions
     void CheckUniqueVars(EMendelianVcfName a_checkSide,
-                         SChrIdTriplet& a_rTriplet,
-                         const std::vector<const CVariant*>& a_rVariantList,
-                         std::vector<bool>& a_rSideDecisions,
-                         const std::vector<EMendelianDecision>& a_rParentSelfDecisions,
-                         const std::vector<EMendelianDecision>& a_rChildDecisions);
+                         const SChrIdTriplet& a_rTriplet,
+                         std::vector<EMendelianDecision>& a_rParentSelfDecisions,
+                         const std::vector<EMendelianDecision>& a_rChildDecisions) const;
     
     ///Check each parent variant and assign all unassigned parent variants as violation or consistent
     void AssignDecisionToParentVars(EMendelianVcfName a_checkSide,
-                                    SChrIdTriplet& a_rTriplet, std::vector<EMendelianDecision>& a_rParentDecisions);
+                                    const SChrIdTriplet& a_rTriplet, std::vector<EMendelianDecision>& a_rParentDecisions) const;
     
     ///Report short output table (Non 0/0 child variants only)
-    void ReportChildChromosomeData(SChrIdTriplet& a_rTriplet,
-                                   std::vector<const CVariant*>& a_rCompliants,
-                                   std::vector<const CVariant*>& a_rViolations);
+    void ReportChildChromosomeData(const SChrIdTriplet& a_rTriplet,
+                                   const SVariantSpan& a_rChildVariants,
+                                   const std::vector<EMendelianDecision>& a_rChildDecisions) const;
+    
+    ///Return the variant at given index of the excluded list of a best path. Allele match path indexes the excluded list of genotype match path (a_pExcludedAM is NULL for genotype match)
+    static const CVariant* GetExcludedVariant(const std::vector<CVariant>& a_rVariants,
+                                              const std::vector<int>& a_rExcludedGT,
+                                              const std::vector<int>* a_pExcludedAM,
+                                              unsigned int a_nIndex);
     
     ///No-call mode selected by user (Default is explicit)
     ENoCallMode m_nocallMode;
     
-    //Best Paths (with Genotype Match) written by each thread for each unique chromosome exists [Between father and child]
-    std::vector<core::CPath>& m_aBestPathsFatherChildGT;
-    //Best Paths (with Allele Match) written by each thread for each unique chromosome exists [Between father and child]
-    std::vector<core::CPath>& m_aBestPathsFatherChildAM;
-    
-    //Best Paths (with Genotype Match) written by each thread for each unique chromosome exists [Between mother and child]
-    std::vector<core::CPath>& m_aBestPathsMotherChildGT;
-    //Best Paths (with Allele Match) written by each thread for each unique chromosome exists [Between mother and child]
-    std::vector<core::CPath>& m_aBestPathsMotherChildAM;
+    ///Return the best path (genotype or allele match) of father-child or mother-child comparison of given chromosome
+    const core::CPath& GetBestPath(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild, bool a_bIsGT) const;
     
     ///Variant provider for parent-child comparison
-    CMendelianVariantProvider& m_provider;
+    const CMendelianVariantProvider& m_provider;
     
     ///Result log for mendelian comparison
     CMendelianResultLog& m_resultLog;
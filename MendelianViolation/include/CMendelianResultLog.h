@@ -41,10 +41,10 @@ namespace mendelian
 struct SMendelianBestPathLogEntry
 {
     bool m_bIsNull = true;
-    int m_nTpCalled;
-    int m_nTpBase;
-    int m_nFP;
-    int m_nFn;
+    int m_nTpCalled = 0;
+    int m_nTpBase = 0;
+    int m_nFP = 0;
+    int m_nFn = 0;
     std::string m_chrName;
 };
 
@@ -56,6 +56,9 @@ struct SMendelianDetailedLogEntry
 {
     void clear();
     
+    ///Add the counts of the given entry
+    void Merge(const SMendelianDetailedLogEntry& a_rEntry);
+    
     //0 -> compliant 1 -> violation 2 -> no call parent 3-> no call child
     int m_nSNP[4];
     int m_nInsertSmall[4];
@@ -75,10 +78,10 @@ struct SMendelianDetailedLogEntry
  */
 struct SMendelianShortLogEntry
 {
-    int m_nSNPcompliant;
-    int m_nSNPviolation;
-    int m_nINDELcompliant;
-    int m_nINDELviolation;
+    int m_nSNPcompliant = 0;
+    int m_nSNPviolation = 0;
+    int m_nINDELcompliant = 0;
+    int m_nINDELviolation = 0;
     std::string m_chrName;
 };
 
@@ -90,6 +93,9 @@ struct SMendelianDetailedLogGenotypes
 {
     void clear();
     
+    ///Add the counts of the given table
+    void Merge(const SMendelianDetailedLogGenotypes& a_rGenotypes);
+    
     //For 10 variant categories, 27 different genotype possibilities for compliant and violation(27 + MultiAllelic)
     //Write order is 9 x SUM(mother genotype) + 3 x SUM(father genotype) + SUM(child genotype)
     //Eg. if genotypes are M:0/1 F:1/1 C:0/0, the index is 9 x (0+1) + 3 x (1+1) + (0+0) = 15
@@ -111,6 +117,9 @@ public:
     void SetLogDirectory(std::string a_rLogDirectory);
     
     
+    ///Allocates one best path/short log entry per chromosome. Each chromosome is logged to its own entry so that threads do not need to lock
+    void SetChromosomeCount(int a_nChromosomeCount);
+    
     ///For given chromosome it reports the result of best path algorithm for parent-child
     void LogBestPathStatistic(bool a_bIsFatherChild,
                               SChrIdTriplet a_triplet,
@@ -120,7 +129,7 @@ public:
                               int a_nFalseNegative);
     
     ///For given chromosome it reports the short result table (SNP and INDEL counts for non 0/0 variants)
-    void LogShortReport(std::string& a_rChrName,
+    void LogShortReport(const SChrIdTriplet& a_rTriplet,
                         int a_nSNPcompliant,
                         int a_nSNPviolation,
                         int a_nINDELcompliant,
@@ -170,9 +179,9 @@ private:
     void WriteGenotypeRowSum(std::ofstream* a_pOutput, const std::string& a_name, bool a_bIsCompliantTable);
 
 
-    ///Stores best Path algorithm results (TP/FP/FN of comparisons)
+    ///Stores best Path algorithm results (TP/FP/FN of comparisons). Indexed by triplet index
     std::vector<SMendelianBestPathLogEntry> m_aMotherChildLogEntries;
-    ///Stores best Path algorithm results (TP/FP/FN of comparisons)
+    ///Stores best Path algorithm results (TP/FP/FN of comparisons). Indexed by triplet index
     std::vector<SMendelianBestPathLogEntry> m_aFatherChildLogEntries;
 
     ///Detailed log entry for each chromosome
@@ -181,7 +190,7 @@ private:
     ///Detailed log genotype TOTAL possibility array for each variant category
     SMendelianDetailedLogGenotypes m_DetailedLogGenotypes;
     
-    ///Short log entry for each chromosome
+    ///Short log entry for each chromosome. Indexed by triplet index
     std::vector<SMendelianShortLogEntry> m_aShortLogEntries;
     
     ///File directory where the result logs will be stored
@@ -36,33 +36,41 @@
 #include "ENoCallMode.h"
 #include "CMendelianResultLog.h"
 #include "SChrIdTriplet.h"
+#include "SVariantSpan.h"
+#include <mutex>
 
 namespace mendelian
 {
 
+class CMendelianVariantProvider;
+
 /**
  * @brief Generates output trio vcf annotated with mendelian decisions using vcfs of family members
  *
+ * Each chromosome is merged into its own compressed chunk as soon as its decisions are available. Chromosomes can be added concurrently
+ * and in any order. Chunks are written in contig order by the thread which completes the next chromosome to be written, so the output
+ * is written while the remaining chromosomes are still compared
  */
 class CMendelianTrioMerger
 {
     
 public:
     
-    ///Generates the trio vcf by merging parent-child variants into single 3-sample vcf file
-    void GenerateTrioVcf(std::vector<SChrIdTriplet>& a_rCommonChromosomes);
+    ///Creates the trio vcf and writes its header. Chromosomes of the output are written in the order of a_rCommonChromosomes
+    void OpenTrioVcf(const std::vector<SChrIdTriplet>& a_rCommonChromosomes);
+    
+    ///Merges parent-child variants of the chromosome into the trio vcf using the decisions of each sample (indexed by variant id).
+    ///Can be called concurrently for different chromosomes. The chunk is written when all previous chromosomes are written
+    void AddChromosome(const SChrIdTriplet& a_rTriplet,
+                       const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                       const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                       const std::vector<EMendelianDecision>& a_rChildDecisions);
     
-    ///Set contigs to write output header. Also initializes size of decision and variant arrays according to number of common chromosomes
-    void SetContigList(const std::vector<SVcfContig>& a_rContigs,
-                       int a_nCommonContigCount,
-                       int a_nChildVarListSize,
-                       int a_nFatherVarListSize,
-                       int a_nMotherVarListSize);
+    ///Writes the remaining chromosomes, sends the detailed logs to the result log and closes the trio vcf
+    void CloseTrioVcf();
     
-    ///Set variants and their decisions for marking MendelianDecision info columns
-    void SetDecisionsAndVariants(SChrIdTriplet& a_rTriplet, EMendelianVcfName a_vcfName,
-                                 const std::vector<EMendelianDecision>& a_rDecisionList,
-                                 const std::vector<const CVariant*>& a_rVarList);
+    ///Set contigs to write output header
+    void SetContigList(const std::vector<SVcfContig>& a_rContigs);
 
     ///Set No Call mode to decide if no calls will be printed as ./. or 0/0s
     void SetNoCallMode(ENoCallMode a_mode);
@@ -70,9 +78,15 @@ public:
     ///Set the full path of output trio vcf
     void SetTrioPath(const std::string& a_nTrioPath);
     
+    ///Set the file format of the output vcf(s), compression level and number of compression threads
+    void SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount);
+    
     ///Set the access of result log from mendelian vcf analyzer to for detailed logs
     void SetResultLogPointer(CMendelianResultLog* a_pResultLog);
     
+    ///Set the access of variant provider to read the comparison status of variants
+    void SetVariantProviderPointer(const CMendelianVariantProvider* a_pProvider);
+    
     ///Set the filename of child to access INFOs. If this function is called, then all info columns will be copied to the generated trio records
     void SetInfoReadParameters(const std::string& a_rChildInputPath,
                                const std::string& a_rFatherInputPath,
@@ -80,13 +94,25 @@ public:
     
 private:
 
-    ///Merge 3 variant set into one trio.vcf that mendelian decisions are marked
-    void AddRecords(SChrIdTriplet& a_rTriplet);
-    
-    ///Write VCF records to the VCF file and fill the log tables
+    ///Merge 3 variant set of a chromosome into the chunk of trio.vcf that mendelian decisions are marked. Records are written as each overlap group is completed
+    void AddRecords(const SChrIdTriplet& a_rTriplet,
+                    const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                    const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                    const std::vector<EMendelianDecision>& a_rChildDecisions,
+                    SVcfChunk& a_rChunk,
+                    SMendelianDetailedLogEntry& a_rLogEntry,
+                    SMendelianDetailedLogGenotypes& a_rLogGenotypes);
+    
+    ///Mark the chunk of given chromosome as ready and write all ready chunks in contig order unless another thread is already writing
+    void CommitChunk(int a_nChromosomeIndex);
+    
+    ///Write VCF records to the chunk and fill the given log tables
     void WriteRecords(const std::vector<SVcfRecord>& recordList,
                             const std::vector<EVariantCategory>& recordCategoryList,
-                            const std::vector<EMendelianDecision>& recordDecisionList);
+                            const std::vector<EMendelianDecision>& recordDecisionList,
+                            SVcfChunk& a_rChunk,
+                            SMendelianDetailedLogEntry& a_rLogEntry,
+                            SMendelianDetailedLogGenotypes& a_rLogGenotypes);
 
     ///Fill the header part of the trio vcf
     void FillHeader();
@@ -111,10 +137,12 @@ private:
     EMendelianDecision GetMendelianDecision(const CVariant* a_pVarMother,
                                             const CVariant* a_pVarFather,
                                             const CVariant* a_pVarChild,
-                                            SChrIdTriplet& a_rTriplet);
+                                            const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                                            const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                                            const std::vector<EMendelianDecision>& a_rChildDecisions);
     
-    ///Register a line of merged vcf to the detailed report table [updates m_logEntry]
-    void RegisterMergedLine(EMendelianDecision a_decision, EVariantCategory a_category);
+    ///Register a line of merged vcf to the given detailed report table
+    void RegisterMergedLine(EMendelianDecision a_decision, EVariantCategory a_category, SMendelianDetailedLogEntry& a_rLogEntry);
     
     ///Register the genotype of merged vcf to genotype table [updates m_logGenotypes]
     void RegisterGenotype(const CVariant* a_pMother,
@@ -123,10 +151,10 @@ private:
                           EMendelianDecision a_initDecision,
                           EVariantCategory a_category);
     
-    ///Register the genotype of merged vcf record to genotype table [updates m_logGenotypes]
-    void RegisterGenotype(const SVcfRecord& a_rRecord, EVariantCategory a_uCategory, EMendelianDecision a_uDecision);
+    ///Register the genotype of merged vcf record to the given genotype table
+    void RegisterGenotype(const SVcfRecord& a_rRecord, EVariantCategory a_uCategory, EMendelianDecision a_uDecision, SMendelianDetailedLogGenotypes& a_rLogGenotypes);
     
-    ///For the given recordList unify the overlapping variant decisions
+    ///For the given recordList (records of a single overlap group or a whole chromosome) unify the overlapping variant decisions
     void ProcessRefOverlappedRegions(std::vector<SVcfRecord>&  a_rRecordList, std::vector<EMendelianDecision>& a_rRecordDecisionList);
     
     ///if the record at recordItr and temporaryItr are overlapping change the decision of record at temopraryItr
@@ -135,13 +163,23 @@ private:
     ///Vcf writer instance
     CVcfWriter m_vcfWriter;
     
-    std::vector<std::vector<EMendelianDecision>> m_aChildDecisions;
-    std::vector<std::vector<EMendelianDecision>> m_aFatherDecisions;
-    std::vector<std::vector<EMendelianDecision>> m_aMotherDecisions;
-
-    std::vector<std::vector<const CVariant*>> m_aChildVariants;
-    std::vector<std::vector<const CVariant*>> m_aFatherVariants;
-    std::vector<std::vector<const CVariant*>> m_aMotherVariants;
+    ///Chunks and log tables of the chromosomes which are merged but not written yet [indexed by triple index]
+    std::vector<SVcfChunk> m_aChunks;
+    std::vector<SMendelianDetailedLogEntry> m_aLogEntries;
+    std::vector<SMendelianDetailedLogGenotypes> m_aLogGenotypes;
+    std::vector<bool> m_aIsChunkReady;
+    
+    ///Names of the chromosomes in output order
+    std::vector<std::string> m_aChromosomeNames;
+    
+    //Index of the next chromosome to be written
+    int m_nNextChunkToWrite = 0;
+    
+    //If a thread is writing the ready chunks
+    bool m_bIsWriting = false;
+    
+    //Protects the chunk states above
+    std::mutex m_chunkMutex;
     
     ///No call mode selection of mendelian violation check (implicit, explicit or none)
     ENoCallMode m_noCallMode;
@@ -165,6 +203,8 @@ private:
     SMendelianDetailedLogGenotypes m_logGenotypes;
     
     CMendelianResultLog* m_pResultLog;
+    
+    const CMendelianVariantProvider* m_pProvider;
 };
 
 }
@@ -32,6 +32,10 @@
 #include "EMendelianVcfName.h"
 #include "SChrIdTriplet.h"
 #include "CBaseVariantProvider.h"
+#include "SVariantSpan.h"
+#include "SMendelianSampleVariants.h"
+#include "SParentChildComparison.h"
+#include "CJointVcfStore.h"
 
 namespace mendelian
 {
@@ -50,14 +54,39 @@ public:
     ///Initialize the vcf and fasta files for mendelian violation mode
     bool InitializeReaders(const SConfig &a_rFatherChildConfig, const SConfig& a_rMotherChildConfig);
     
+    ///Initialize the fasta file to read the samples of the decoded joint vcf (mendelian batch mode). Family members are set by SetFamily
+    bool InitializeFromJointVcf(const SConfig& a_rFatherChildConfig, const SConfig& a_rMotherChildConfig, const CJointVcfStore& a_rJointVcf);
+    
+    ///Generate the variants of given sample of the joint vcf with the sort orders and oriented variants of all chromosomes. Samples can be loaded concurrently
+    void LoadJointVcfSample(int a_nSampleIndex, const std::string& a_rSampleName, SMendelianSampleVariants& a_rSample);
+    
+    ///Set the family members and the comparisons between them. Samples and comparisons can be shared with the providers of other trios
+    void SetFamily(const SMendelianSampleVariants* a_pMother,
+                   const SMendelianSampleVariants* a_pFather,
+                   const SMendelianSampleVariants* a_pChild,
+                   SParentChildComparison* a_pFatherChild,
+                   SParentChildComparison* a_pMotherChild);
+    
+    ///Allocate the best paths and status lists of the comparison between given parent and child. All variants are eNOT_ASSESSED at the beginning
+    static void InitializeComparison(SParentChildComparison& a_rComparison, const SMendelianSampleVariants& a_rParent, const SMendelianSampleVariants& a_rChild);
+    
+    ///Return the results of father-child or mother-child comparison
+    SParentChildComparison& GetComparison(bool a_bIsFatherChild);
+    
+    ///Return the results of father-child or mother-child comparison
+    const SParentChildComparison& GetComparison(bool a_bIsFatherChild) const;
+    
     ///Return all the variants belongs to given chromosome
     std::vector<const CVariant*> GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo) const;
+    
+    ///Return the variants of given chromosome in load order without copying. Excluded indexes of the best paths refer to this list
+    const std::vector<CVariant>& GetVariants(EMendelianVcfName a_uFrom, int a_nChrNo) const;
 
-    ///Return all the variants belongs to given chromosome sorted by variant ids
-    std::vector<const CVariant*> GetSortedVariantListByID(EMendelianVcfName a_uFrom, int a_nChrNo) const;
+    ///Return all the variants belongs to given chromosome sorted by variant ids. The order is computed at load time
+    SVariantSpan GetSortedVariantListByID(EMendelianVcfName a_uFrom, int a_nChrNo) const;
     
-    ///Return all the variants belongs to given chromosome sorted by variant ids
-    std::vector<const CVariant*> GetSortedVariantListByIDandStartPos(EMendelianVcfName a_uFrom, int a_nChrNo) const;
+    ///Return all the variants belongs to given chromosome sorted by original position, start/end positions and variant ids. The order is computed at load time
+    SVariantSpan GetSortedVariantListByIDandStartPos(EMendelianVcfName a_uFrom, int a_nChrNo) const;
 
     ///Return all the variants belongs to given chromosome according to given index list
     std::vector<const CVariant*> GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_nIndexList) const;
@@ -91,32 +120,52 @@ public:
 
     //Returns the count of eNOT_ASSESSED variants for all chromosome belong to input VCF sample
     int GetSkippedVariantCount(EMendelianVcfName a_uFrom) const;
+    
+    ///Return the status list (indexed by variant id) of given sample for given chromosome. Child has separate lists for father-child and mother-child comparisons
+    std::vector<EVariantMatch>& GetVariantStatusList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsFatherChild);
+    
+    ///Return the status of the variant. For child variants, results of father-child and mother-child comparisons are combined
+    EVariantMatch GetVariantStatus(EMendelianVcfName a_uFrom, const CVariant* a_pVariant) const;
+    
+    using CBaseVariantProvider::SetVariantStatus;
+    
+    ///Set the status of each variant in the given list at the given status list
+    static void SetVariantStatus(std::vector<EVariantMatch>& a_rStatusList, const std::vector<const CVariant*>& a_rVariantList, EVariantMatch a_status);
+    
+    ///Set the status of each variant in the given list at the given status list
+    static void SetVariantStatus(std::vector<EVariantMatch>& a_rStatusList, const std::vector<const core::COrientedVariant*>& a_rVariantList, EVariantMatch a_status);
         
 private:
     
     //Open mother father and child vcf files and set their corresponding samples
     bool OpenVcfFiles();
     
+    //Decode the selected samples of a multi-sample trio vcf in a single pass if mother, father and child are read from the same vcf file
+    bool OpenTrioVcf();
+    
+    //Fill the variants of family members and prepare the lists used by the comparisons
+    void LoadVariants();
+    
+    //Return the reader that the contigs of given sample are read from (Joint vcf reader in batch mode)
+    const CVcfReader& GetVcfReader(EMendelianVcfName a_uFrom) const;
+    
     //Fill the common chromosome list
     void SetCommonChromosomes();
     
-    //Fill Variants for given sample Id
-    void FillVariantForSample(int a_nSampleId, SConfig& a_rConfig);
+    //Fill Variants of the sample read by given reader (or given sample of joint vcf if the reader is NULL)
+    void FillVariantForSample(SMendelianSampleVariants& a_rSample, CVcfReader* a_pReader, int a_nJointSampleIndex, const std::string& a_rSampleName, SConfig& a_rConfig);
     
     //Fill Variant sets for parent and child
     void FillVariants();
-        
-    //Fill Oriented variant sets for parent and child
-    void FillGenotypeMatchOrientedVariants(std::vector<SChrIdTriplet>& a_aCommonChromosomes);
-
-    //Fill Oriented variant sets for parent and child
-    void FillAlleleMatchOrientedVariants(std::vector<SChrIdTriplet>& a_aCommonChromosomes);
-        
-    //Find the optimal trimmings for given variant list
-    void FindOptimalTrimmings(std::vector<CVariant>& a_rVariantList, EMendelianVcfName a_uFrom);
     
-    //Merge trimmed variants with the original variant list
-    void AppendTrimmedVariants(std::vector<CVariant>& a_rVariantList, EMendelianVcfName a_uFrom);
+    //Compute the id and original position orders of variant lists of the sample
+    static void FillVariantOrders(SMendelianSampleVariants& a_rSample);
+    
+    //Allocate the oriented variant lists of the sample
+    static void InitializeOrientedVariants(SMendelianSampleVariants& a_rSample);
+    
+    //Fill genotype match and allele match oriented variants of given chromosome of the sample
+    static void FillOrientedVariants(SMendelianSampleVariants& a_rSample, int a_nChrId);
 
     
     //VCF FILES FOR COMPARISON
@@ -124,45 +173,30 @@ private:
     CVcfReader m_MotherVcf;
     CVcfReader m_ChildVcf;
     
+    //Decoded joint vcf that family members are read from in batch mode or if they are in the same vcf (NULL if vcf files are read directly)
+    const CJointVcfStore* m_pJointVcf = NULL;
+    
+    //Decoded trio vcf if mother, father and child are samples of the same vcf file
+    CJointVcfStore m_trioVcf;
+    
     //Config objects for variant provider
     SConfig m_motherChildConfig;
     SConfig m_fatherChildConfig;
     
-    //List that stores Father Variants in order
-    std::vector<std::vector<CVariant>> m_aFatherVariantList;
-    //List that stores Mother Variants in order
-    std::vector<std::vector<CVariant>> m_aMotherVariantList;
-    //List that stores Child Variants in order
-    std::vector<std::vector<CVariant>> m_aChildVariantList;
-    
-    //List that store the genotype match base Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aMotherOrientedVariantList;
-    //List that store the genotype match called Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aFatherOrientedVariantList;
-    //List that store the genotype match base Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aChildOrientedVariantList;
-
-    //List that store the allele match base Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aMotherAlleleMatchOrientedVariantList;
-    //List that store the allele match called Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aFatherAlleleMatchOrientedVariantList;
-    //List that store the allele match base Oriented variant tuples (In the order of genotype)
-    std::vector<std::vector<core::COrientedVariant>> m_aChildAlleleMatchOrientedVariantList;
-    
-    //Father variants which are filtered out from comparison
-    int m_nFatherNotAssessedVariantCount;
-    //Mother variants which are filtered out from comparison
-    int m_nMotherNotAssessedVariantCount;
-    //Child variants which are filtered out from comparison
-    int m_nChildNotAssessedVariantCount;
+    //Variants of family members which are loaded by this provider [EMendelianVcfName]
+    SMendelianSampleVariants m_aSamples[3];
+    //Variants of family members that are used by the comparisons. Points to m_aSamples or to the samples shared between trios [EMendelianVcfName]
+    const SMendelianSampleVariants* m_pSamples[3] = {NULL, NULL, NULL};
+    
+    //Father-child and mother-child comparisons of the family which are allocated by this provider
+    SParentChildComparison m_fatherChildComparison;
+    SParentChildComparison m_motherChildComparison;
+    //Comparisons used by the family. Points to the comparisons of this provider or to the comparisons shared between trios
+    SParentChildComparison* m_pFatherChildComparison = NULL;
+    SParentChildComparison* m_pMotherChildComparison = NULL;
     
     //Chromosomes that all three samples shares variant
     std::vector<SChrIdTriplet> m_aCommonChromosomes;
-    
-    //Variant counts contains asterisk which will are eliminated from comparison
-    int m_nMotherAsteriskCount;
-    int m_nFatherAsteriskCount;
-    int m_nChildAsteriskCount;
 };
 
 }
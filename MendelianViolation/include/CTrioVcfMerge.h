@@ -27,47 +27,58 @@
 #define _C_TRIO_VCF_MERGE_H_
 
 #include <vector>
-
-class CVariant;
+#include <queue>
+#include <utility>
+#include <functional>
+#include "SVariantSpan.h"
 
 namespace mendelian
 {
 
 /**
- * @brief Merges given three variant set belongs to the same chromosome
+ * @brief Merges given variant sets belongs to the same chromosome into multi-sample records
  *
+ * Sample spans should be sorted by original position. Lists are merged with a min-heap keyed by the original position of
+ * each sample's next variant, so the merge is not limited to three samples. Records are streamed one by one and the start of each
+ * reference overlap group is detected in the same sweep, so that callers only need to keep the records of the current group
  */
 class CTrioVcfMerge
 {
     
 public:
     
-    ///Constructor. Set the variant sets
-    CTrioVcfMerge(std::vector<const CVariant*>& a_rMotherVariants, std::vector<const CVariant*>& a_rFatherVariants, std::vector<const CVariant*>& a_rChildVariants);
-    
-    ///Return the next record variants. If a sample is 0/0 null pointer will be returned for that sample. false will be return when iterator comes to the end
-    bool GetNext(const CVariant** a_rMotherVar, const CVariant** a_rFatherVariant,  const CVariant** a_rChildVariant);
+    ///Constructor. Set the variant spans. Record variants are returned in the same sample order
+    CTrioVcfMerge(const std::vector<SVariantSpan>& a_rSampleVariants);
     
+    ///Return the next record variants. If a sample is 0/0 null pointer will be returned for that sample. a_rbIsNewGroup is set to true if the record does not overlap any of the previous records. false will be return when iterator comes to the end
+    bool GetNext(std::vector<const CVariant*>& a_rRecordVariants, bool& a_rbIsNewGroup);
     
 private:
     
-    ///If buffers are empty, refill buffers
+    //Pops all samples whose next variant is at the smallest original position from the heap and sets their buffer ranges
     bool RefillBuffers();
     
-    std::vector<const CVariant*> motherVariantBuffer;
-    std::vector<const CVariant*> fatherVariantBuffer;
-    std::vector<const CVariant*> childVariantBuffer;
-
-    //Keep track of the smallest original variant position at each iteration
-    int smallestVariantPosition;
+    //Updates the overlap group with the given record and returns true if the record starts a new group
+    bool UpdateOverlapGroup(const std::vector<const CVariant*>& a_rRecordVariants);
+    
+    //Variant spans to be merged
+    std::vector<SVariantSpan> m_aSampleVariants;
+    
+    //Sample iterators. Variants in [m_aBufferStart, m_aBufferEnd) are buffered and wait to be written to a record
+    std::vector<int> m_aBufferStart;
+    std::vector<int> m_aBufferEnd;
+    
+    //Samples that has variants in buffer at the current position
+    std::vector<int> m_aBufferedSamples;
+    
+    //Min-heap of <original position of the next variant, sample index> of the samples that are not consumed completely
+    std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int>>, std::greater<std::pair<int,int>>> m_sampleHeap;
     
-    //Reference to the variant set to be merged
-    std::vector<const CVariant*>& m_motherVariants;
-    std::vector<const CVariant*>& m_fatherVariants;
-    std::vector<const CVariant*>& m_childVariants;
+    //Rightmost end position of the records in the current overlap group
+    int m_nGroupEnd;
     
-    //Sample iterators
-    int motherItr, fatherItr, childItr;
+    //True until the first record is returned
+    bool m_bIsFirstRecord;
 };
 
 }
@@ -0,0 +1,63 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  SMendelianSampleVariants.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _S_MENDELIAN_SAMPLE_VARIANTS_H_
+#define _S_MENDELIAN_SAMPLE_VARIANTS_H_
+
+#include <vector>
+#include "CVariant.h"
+#include "COrientedVariant.h"
+
+namespace mendelian
+{
+
+/**
+ * @brief Variants of a family member and the lists generated from them for the comparisons
+ *
+ * A sample is only read once it is loaded. In mendelian batch mode each sample is loaded once and shared by the providers of all trios
+ * that it belongs to, either as a parent or as a child. Oriented variants point to the variant lists so the object should not be copied
+ */
+struct SMendelianSampleVariants
+{
+    ///Variants of each chromosome in order [chromosome][variant]
+    std::vector<std::vector<CVariant>> m_aVariantList;
+    
+    ///Genotype match oriented variant tuples (In the order of genotype) [chromosome][2 * variant + orientation]
+    std::vector<std::vector<core::COrientedVariant>> m_aOrientedVariantList;
+    ///Allele match oriented variant tuples (In the order of genotype) [chromosome][2 * variant + allele]
+    std::vector<std::vector<core::COrientedVariant>> m_aAlleleMatchOrientedVariantList;
+    
+    ///Indexes of variants sorted by variant id [chromosome][k]
+    std::vector<std::vector<unsigned int>> m_aIdOrder;
+    ///Indexes of variants sorted by original position [chromosome][k]
+    std::vector<std::vector<unsigned int>> m_aOriginalPosOrder;
+    
+    ///Variants which are filtered out from comparison
+    int m_nNotAssessedVariantCount = 0;
+    ///Variants that contain asterisk which are eliminated from comparison
+    int m_nAsteriskCount = 0;
+};
+
+}
+
+#endif // _S_MENDELIAN_SAMPLE_VARIANTS_H_
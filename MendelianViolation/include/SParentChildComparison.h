@@ -0,0 +1,55 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  SParentChildComparison.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _S_PARENT_CHILD_COMPARISON_H_
+#define _S_PARENT_CHILD_COMPARISON_H_
+
+#include <vector>
+#include "CPath.h"
+#include "EVariantMatch.h"
+
+namespace mendelian
+{
+
+/**
+ * @brief Results of the comparison between a parent and a child
+ *
+ * Each chromosome is written by a single comparison task and read by the decision of the trios which contain the parent-child pair.
+ * In mendelian batch mode a pair is compared once and its results are shared by all trios that require it
+ */
+struct SParentChildComparison
+{
+    ///Best paths of genotype match [child chromosome id]
+    std::vector<core::CPath> m_aBestPathsGT;
+    ///Best paths of allele match [child chromosome id]
+    std::vector<core::CPath> m_aBestPathsAM;
+    
+    ///Status of parent variants [parent chromosome id][variant id]
+    std::vector<std::vector<EVariantMatch>> m_aParentVariantStatus;
+    ///Status of child variants [child chromosome id][variant id]
+    std::vector<std::vector<EVariantMatch>> m_aChildVariantStatus;
+};
+
+}
+
+#endif // _S_PARENT_CHILD_COMPARISON_H_
@@ -32,11 +32,14 @@
 #include "CSyncPoint.h"
 #include "Utils/CUtils.h"
 #include <algorithm>
+#include <climits>
+#include <atomic>
+#include "CTaskScheduler.h"
 
 using namespace mendelian;
 
 CMendelianAnalyzer::CMendelianAnalyzer() :
-m_mendelianDecider(m_aBestPathsFatherChildGT, m_aBestPathsFatherChildAM, m_aBestPathsMotherChildGT, m_aBestPathsMotherChildAM, m_provider, m_resultLog)
+m_mendelianDecider(m_provider, m_resultLog)
 {
     m_noCallMode = ENoCallMode::eExplicitNoCall;
 }
@@ -69,73 +72,15 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     std::cerr << "[stderr] initializing output writer" << std::endl;
     
     //Initialize output writer
-    std::string directory = std::string(m_fatherChildConfig.m_pOutputDirectory);
-    std::string trioPath = directory + (directory[directory.length()-1] != '/' ? "/" + std::string(m_fatherChildConfig.m_output_prefix) + "_trio.vcf" : std::string(m_fatherChildConfig.m_output_prefix) + "_trio.vcf");
-    
-    m_trioWriter.SetTrioPath(trioPath);
-    m_trioWriter.SetNoCallMode(m_noCallMode);
-    m_trioWriter.SetResultLogPointer(&m_resultLog);
-    m_trioWriter.SetContigList(m_provider.GetContigs(),
-                               static_cast<int>(m_provider.GetCommonChromosomes().size()),
-                               m_provider.GetContigCount(eCHILD),
-                               m_provider.GetContigCount(eFATHER),
-                               m_provider.GetContigCount(eMOTHER));
+    InitializeOutput();
     
     std::cerr << "[stderr] Running best path algorithm pipeline for each chromosome..." << std::endl;
     
-    //Run core comparison engine on parallel
+    //Run core comparison engine and the mendelian decisions of each chromosome on parallel
     AssignJobsToThreads(m_fatherChildConfig.m_nThreadCount);
     
-    std::cerr << "[stderr] Evaluating mendelian consistency of variants..." << std::endl;
-    
-    //Perform merge process
-    m_mendelianDecider.SetNocallMode(m_noCallMode);
-    std::vector<SChrIdTriplet> chrIds = m_provider.GetCommonChromosomes();
-    for(unsigned int k = 0; k < chrIds.size(); k++)
-    {
-        //Initialize the decision arrays
-        std::vector<EMendelianDecision> childDecisions  = std::vector<EMendelianDecision>(m_provider.GetVariantCount(eCHILD,  chrIds[k].m_nCid));
-        std::vector<EMendelianDecision> motherDecisions = std::vector<EMendelianDecision>(m_provider.GetVariantCount(eMOTHER, chrIds[k].m_nMid));
-        std::vector<EMendelianDecision> fatherDecisions = std::vector<EMendelianDecision>(m_provider.GetVariantCount(eFATHER, chrIds[k].m_nFid));
-        
-        //Set all decisions to unknown at the beginning
-        for(unsigned int m = 0; m < childDecisions.size(); m++)
-            childDecisions[m] = eUnknown;
-        for(unsigned int m = 0; m < motherDecisions.size(); m++)
-            motherDecisions[m] = eUnknown;
-        for(unsigned int m = 0; m < fatherDecisions.size(); m++)
-            fatherDecisions[m] = eUnknown;
-        
-        //Merge the chromosome and fill the decisions arrays
-        m_mendelianDecider.MergeFunc(chrIds[k], motherDecisions, fatherDecisions, childDecisions);
-        
-        //Set decision arrays and variants to the output Trio Merger
-        m_trioWriter.SetDecisionsAndVariants(chrIds[k], eCHILD,  childDecisions, m_provider.GetSortedVariantListByIDandStartPos(eCHILD, chrIds[k].m_nCid));
-        m_trioWriter.SetDecisionsAndVariants(chrIds[k], eMOTHER, motherDecisions, m_provider.GetSortedVariantListByIDandStartPos(eMOTHER, chrIds[k].m_nMid));
-        m_trioWriter.SetDecisionsAndVariants(chrIds[k], eFATHER, fatherDecisions, m_provider.GetSortedVariantListByIDandStartPos(eFATHER, chrIds[k].m_nFid));
-    }
-    
-    std::cerr << "[stderr] Generating the output trio vcf..." << std::endl;
-    //Generate trio output vcf from common chromosomes
-    m_trioWriter.SetInfoReadParameters(m_fatherChildConfig.m_pCalledVcfFileName, m_fatherChildConfig.m_pBaseVcfFileName, m_motherChildConfig.m_pBaseVcfFileName);
-    m_trioWriter.GenerateTrioVcf(chrIds);
-    
-    std::cerr << "[stderr] Generating detailed output logs.." << std::endl;
-    
-    m_resultLog.LogSkippedVariantCounts(m_provider.GetSkippedVariantCount(eCHILD),
-                                        m_provider.GetSkippedVariantCount(eFATHER),
-                                        m_provider.GetSkippedVariantCount(eMOTHER));
-    
-    m_resultLog.LogFilteredComplexVariantCounts(m_provider.GetNotAssessedVariantCount(eCHILD),
-                                                m_provider.GetNotAssessedVariantCount(eFATHER),
-                                                m_provider.GetNotAssessedVariantCount(eMOTHER));
-    
-    //Write results to log file
-    m_resultLog.SetLogDirectory(m_fatherChildConfig.m_pOutputDirectory);
-    m_resultLog.WriteBestPathStatistics(m_fatherChildConfig.m_output_prefix);
-    m_resultLog.WriteDetailedReportTable(m_fatherChildConfig.m_output_prefix);
-    m_resultLog.WriteDetailedReportTabDelimited(m_fatherChildConfig.m_output_prefix);
-    m_resultLog.WriteShortReportTable(m_fatherChildConfig.m_output_prefix);
+    //Generate trio output vcf and the logs
+    WriteResults();
     
     duration = std::difftime(std::time(0), start1);
     std::cerr << "[stderr] Processing Chromosomes completed in " << duration << " secs" << std::endl;
@@ -171,6 +116,11 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
     
     const char* PARAM_AUTOSOME_ONLY = "--autosome-only";
     
+    const char* PARAM_REFERENCE_CACHE = "-reference-cache";
+    const char* PARAM_PREFETCH_WINDOW = "-prefetch-window";
+    const char* PARAM_OUTPUT_FORMAT = "-output-format";
+    const char* PARAM_COMPRESSION_LEVEL = "-compression-level";
+    
     bool bFatherSet = false;
     bool bMotherSet = false;
     bool bChildSet = false;
@@ -317,8 +267,42 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
         
         else if(0 == strcmp(argv[it], PARAM_THREAD_COUNT))
         {
-            m_motherChildConfig.m_nThreadCount = std::min(std::max(1, atoi(argv[it+1])), MAX_THREAD_COUNT);
-            m_fatherChildConfig.m_nThreadCount = std::min(std::max(1, atoi(argv[it+1])), MAX_THREAD_COUNT);
+            m_motherChildConfig.m_nThreadCount = std::max(1, atoi(argv[it+1]));
+            m_fatherChildConfig.m_nThreadCount = std::max(1, atoi(argv[it+1]));
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_REFERENCE_CACHE))
+        {
+            m_motherChildConfig.m_bUseReferenceCache = true;
+            m_motherChildConfig.m_pReferenceCacheDirectory = argv[it+1];
+            m_fatherChildConfig.m_bUseReferenceCache = true;
+            m_fatherChildConfig.m_pReferenceCacheDirectory = argv[it+1];
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_PREFETCH_WINDOW))
+        {
+            m_motherChildConfig.m_nPrefetchWindowSize = std::max(0, atoi(argv[it+1]));
+            m_fatherChildConfig.m_nPrefetchWindowSize = std::max(0, atoi(argv[it+1]));
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_OUTPUT_FORMAT))
+        {
+            EVcfOutputFormat format = eVCF_TEXT;
+            if(0 == strcmp(argv[it+1], "vcf.gz"))
+                format = eVCF_BGZF;
+            else if(0 == strcmp(argv[it+1], "bcf"))
+                format = eBCF;
+            else if(0 != strcmp(argv[it+1], "vcf"))
+                std::cerr << "Unknown output format: " << argv[it+1] << ". Output format is set to vcf" << std::endl;
+            
+            m_motherChildConfig.m_outputFormat = format;
+            m_fatherChildConfig.m_outputFormat = format;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_COMPRESSION_LEVEL))
+        {
+            m_motherChildConfig.m_nCompressionLevel = std::min(std::max(0, atoi(argv[it+1])), 9);
+            m_fatherChildConfig.m_nCompressionLevel = std::min(std::max(0, atoi(argv[it+1])), 9);
         }
         
         else
@@ -354,202 +338,278 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
     
 }
 
-int CMendelianAnalyzer::AssignJobsToThreads(int a_nThreadCount)
+bool CMendelianAnalyzer::InitializeFamily(const SConfig& a_rFatherChildConfig,
+                                          const SConfig& a_rMotherChildConfig,
+                                          ENoCallMode a_noCallMode,
+                                          const CJointVcfStore& a_rJointVcf,
+                                          const SMendelianSampleVariants* a_pMother,
+                                          const SMendelianSampleVariants* a_pFather,
+                                          const SMendelianSampleVariants* a_pChild,
+                                          SParentChildComparison* a_pFatherChild,
+                                          SParentChildComparison* a_pMotherChild)
 {
-    //Thread pool we have for multitasking by per chromosome
-    std::thread *pThreadPool;
+    m_fatherChildConfig = a_rFatherChildConfig;
+    m_motherChildConfig = a_rMotherChildConfig;
+    m_noCallMode = a_noCallMode;
     
-    //Get the list of chromosomes to be processed
-    std::vector<SChrIdTriplet> chromosomeListToProcess = m_provider.GetCommonChromosomes();
-
-    //Initialize best path vectors
-    m_aBestPathsFatherChildGT = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
-    m_aBestPathsMotherChildGT = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
-    m_aBestPathsFatherChildAM = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
-    m_aBestPathsMotherChildAM = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
-    
-    int exactThreadCount = std::min(a_nThreadCount, (int)chromosomeListToProcess.size());
+    if(!m_provider.InitializeFromJointVcf(m_fatherChildConfig, m_motherChildConfig, a_rJointVcf))
+        return false;
     
-    //Allocate threads
-    pThreadPool = new std::thread[exactThreadCount];
+    m_provider.SetFamily(a_pMother, a_pFather, a_pChild, a_pFatherChild, a_pMotherChild);
     
-    int threadPoolIt = 0;
-    std::vector<SChrIdTriplet> *chromosomeLists = new std::vector<SChrIdTriplet>[exactThreadCount];
+    InitializeOutput();
+    return true;
+}
+
+void CMendelianAnalyzer::InitializeOutput()
+{
+    std::string directory = std::string(m_fatherChildConfig.m_pOutputDirectory);
+    std::string trioPath = directory + (directory[directory.length()-1] != '/' ? "/" + std::string(m_fatherChildConfig.m_output_prefix) + "_trio.vcf" : std::string(m_fatherChildConfig.m_output_prefix) + "_trio.vcf");
     
-    //Divide tasks into threads
-    for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
-    {
-        chromosomeLists[threadPoolIt].push_back(chromosomeListToProcess[k]);
-        threadPoolIt = (threadPoolIt+1) % exactThreadCount;
-    }
+    m_trioWriter.SetTrioPath(trioPath);
+    m_trioWriter.SetOutputFormat(m_fatherChildConfig.m_outputFormat, m_fatherChildConfig.m_nCompressionLevel, m_fatherChildConfig.m_nThreadCount);
+    m_trioWriter.SetNoCallMode(m_noCallMode);
+    m_trioWriter.SetResultLogPointer(&m_resultLog);
+    m_trioWriter.SetVariantProviderPointer(&m_provider);
+    m_trioWriter.SetContigList(m_provider.GetContigs());
+    m_trioWriter.SetInfoReadParameters(m_fatherChildConfig.m_pCalledVcfFileName, m_fatherChildConfig.m_pBaseVcfFileName, m_motherChildConfig.m_pBaseVcfFileName);
     
-    //Assign divided task to the threads
-    for(int k = 0; k < exactThreadCount; k++)
-        pThreadPool[k] = std::thread(&CMendelianAnalyzer::ProcessChromosome, this, chromosomeLists[k]);
+    //Trio vcf is opened before the comparisons, chromosomes are written as they are decided
+    m_trioWriter.OpenTrioVcf(m_provider.GetCommonChromosomes());
     
-    for(int k = 0; k < exactThreadCount; k++)
-        pThreadPool[k].join();
+    m_mendelianDecider.SetNocallMode(m_noCallMode);
+}
 
-    //Clean allocation
-    delete[] chromosomeLists;
+void CMendelianAnalyzer::WriteResults()
+{
+    std::cerr << "[stderr] Completing the output trio vcf..." << std::endl;
+    //Chromosomes are already written as they are decided. Write the remaining ones and close the trio vcf
+    m_trioWriter.CloseTrioVcf();
     
-    //Clean threads
-    delete[] pThreadPool;
+    std::cerr << "[stderr] Generating detailed output logs.." << std::endl;
+    
+    m_resultLog.LogSkippedVariantCounts(m_provider.GetSkippedVariantCount(eCHILD),
+                                        m_provider.GetSkippedVariantCount(eFATHER),
+                                        m_provider.GetSkippedVariantCount(eMOTHER));
     
-    return exactThreadCount;
+    m_resultLog.LogFilteredComplexVariantCounts(m_provider.GetNotAssessedVariantCount(eCHILD),
+                                                m_provider.GetNotAssessedVariantCount(eFATHER),
+                                                m_provider.GetNotAssessedVariantCount(eMOTHER));
     
+    //Write results to log file
+    m_resultLog.SetLogDirectory(m_fatherChildConfig.m_pOutputDirectory);
+    m_resultLog.WriteBestPathStatistics(m_fatherChildConfig.m_output_prefix);
+    m_resultLog.WriteDetailedReportTable(m_fatherChildConfig.m_output_prefix);
+    m_resultLog.WriteDetailedReportTabDelimited(m_fatherChildConfig.m_output_prefix);
+    m_resultLog.WriteShortReportTable(m_fatherChildConfig.m_output_prefix);
 }
 
-void CMendelianAnalyzer::ProcessChromosome(const std::vector<SChrIdTriplet>& a_nChromosomeIds)
-{    
-    for(SChrIdTriplet triplet : a_nChromosomeIds)
+std::vector<double> CMendelianAnalyzer::PrepareComparisonTasks()
+{
+    //Get the list of chromosomes to be processed
+    const std::vector<SChrIdTriplet>& chromosomeListToProcess = m_provider.GetCommonChromosomes();
+
+    //Each chromosome is logged to its own entry, threads do not share any statistic data
+    m_resultLog.SetChromosomeCount(static_cast<int>(chromosomeListToProcess.size()));
+    
+    //Father-child and mother-child comparisons of each chromosome are separate tasks [task 2k: father-child, task 2k+1: mother-child of chromosome k].
+    //They only share the child variants and keep the child variant status in separate lists, so they can run concurrently.
+    //Each chromosome counts down its two comparisons. The worker which completes the second one decides the chromosome
+    std::vector<double> taskCosts;
+    for(const SChrIdTriplet& triplet : chromosomeListToProcess)
     {
-        //Get variant list of parent-child for given chromosome
-        std::vector<const CVariant*> varListFather = m_provider.GetVariantList(eFATHER, triplet.m_nFid);
-        std::vector<const CVariant*> varListMother = m_provider.GetVariantList(eMOTHER, triplet.m_nMid);
         std::vector<const CVariant*> varListChild = m_provider.GetVariantList(eCHILD, triplet.m_nCid);
-        
-        //Get oriented variant list of parent-child for given chromosome
-        std::vector<const core::COrientedVariant*> ovarListGTFather = m_provider.GetOrientedVariantList(eFATHER, triplet.m_nFid);
-        std::vector<const core::COrientedVariant*> ovarListGTMother = m_provider.GetOrientedVariantList(eMOTHER, triplet.m_nMid);
-        std::vector<const core::COrientedVariant*> ovarListGTChild = m_provider.GetOrientedVariantList(eCHILD, triplet.m_nCid);
-
-        //Get the chromosome ref seq
-        SContig ctg;
-        mtx.lock();
-        bool bIsContigAvailable = m_provider.ReadContig(triplet.m_chrName, ctg);
-        if(false == bIsContigAvailable)
+        for(EMendelianVcfName parentName : {eFATHER, eMOTHER})
         {
-            std::cerr << "Contig " << triplet.m_chrName << " is not available in given FASTA file!" << std::endl;
-            mtx.unlock();
-            continue;
+            std::vector<const CVariant*> varListParent = m_provider.GetVariantList(parentName, parentName == eFATHER ? triplet.m_nFid : triplet.m_nMid);
+            int spanStart = INT_MAX;
+            int spanEnd = 0;
+            for(const std::vector<const CVariant*>* pVarList : {&varListParent, &varListChild})
+            {
+                if(pVarList->empty())
+                    continue;
+                spanStart = std::min(spanStart, pVarList->front()->m_nStartPos);
+                spanEnd = std::max(spanEnd, pVarList->back()->m_nEndPos);
+            }
+            int variantCount = static_cast<int>(varListParent.size() + varListChild.size());
+            taskCosts.push_back(CTaskScheduler::EstimateCost(variantCount, spanEnd - spanStart));
         }
-        mtx.unlock();
+    }
+    
+    //Number of parent-child comparisons of each chromosome which are not finished yet. The worker which finishes the last one decides the chromosome
+    m_aRemainingComparisons = std::vector<std::atomic<int>>(chromosomeListToProcess.size());
+    for(std::atomic<int>& remaining : m_aRemainingComparisons)
+        remaining.store(2);
+    
+    return taskCosts;
+}
 
-        // === PROCESS FATHER-CHILD ===
-        
-        //Create path replay for parent child;
-        core::CPathReplay replayFatherChildGT(varListFather, varListChild, ovarListGTFather, ovarListGTChild);
-        
-        //Find Best Path Father-Child GT Match
-        m_aBestPathsFatherChildGT[triplet.m_nTripleIndex] = replayFatherChildGT.FindBestPath(ctg, true);
-        
-        //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsChildGT = m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsFatherGT = m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsFather = m_provider.GetVariantList(eFATHER, triplet.m_nFid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsChild = m_provider.GetVariantList(eCHILD, triplet.m_nCid,m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Allele Match oriented variants
-        std::vector<const core::COrientedVariant*> ovarListAMFather = m_provider.GetOrientedVariantList(eFATHER, triplet.m_nFid, true, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const core::COrientedVariant*> ovarListAMChildFC = m_provider.GetOrientedVariantList(eCHILD, triplet.m_nCid, true, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Clear Father child replay object
-        replayFatherChildGT.Clear();
-        
-        //Change the variant list to process
-        core::CPathReplay replayFatherChildAM(excludedVarsFather, excludedVarsChild, ovarListAMFather, ovarListAMChildFC);
-        
-        //Find Best Path Father-Child AM Match
-        m_aBestPathsFatherChildAM[triplet.m_nTripleIndex] = replayFatherChildAM.FindBestPath(ctg, false);
-        const std::vector<const core::COrientedVariant*>& includedVarsChildAM = m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsFatherAM = m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
+const SChrIdTriplet& CMendelianAnalyzer::GetTaskChromosome(int a_nTask)
+{
+    return m_provider.GetCommonChromosomes()[a_nTask / 2];
+}
 
-        const std::vector<const CVariant*> excludedVarsChildFC = m_provider.GetVariantList(excludedVarsChild, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        const std::vector<const CVariant*> excludedVarsFatherFC = m_provider.GetVariantList(excludedVarsFather, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        
-        //Set Variant status of child variants
-        m_provider.SetVariantStatus(includedVarsChildAM, eALLELE_MATCH);
-        m_provider.SetVariantStatus(includedVarsChildGT, eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(excludedVarsChildFC, eNO_MATCH);
-        
-        //Set Variant status of father variants
-        m_provider.SetVariantStatus(includedVarsFatherGT, eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(includedVarsFatherAM, eALLELE_MATCH);
-        m_provider.SetVariantStatus(excludedVarsFatherFC, eNO_MATCH);
+void CMendelianAnalyzer::RunComparisonTask(int a_nTask, const std::vector<int>& a_rQueuedTasks)
+{
+    std::vector<std::string> chrNames;
+    for(int task : a_rQueuedTasks)
+        chrNames.push_back(GetTaskChromosome(task).m_chrName);
+    
+    RunComparison(a_nTask, chrNames);
+    CompleteComparison(a_nTask);
+}
 
-        //Clear Father child replay object
-        replayFatherChildAM.Clear();
-        
-        // === PROCESS MOTHER-CHILD ===
-     
-        //Create path replay for parent child;
-        core::CPathReplay replayMotherChildGT(varListMother, varListChild, ovarListGTMother, ovarListGTChild);
-        
-        //Find Best Path Father-Child GT Match
-        m_aBestPathsMotherChildGT[triplet.m_nTripleIndex] = replayMotherChildGT.FindBestPath(ctg, true);
-        
-        //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsChildGTMC = m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsMotherGT = m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsMother = m_provider.GetVariantList(eMOTHER, triplet.m_nMid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsChild2 = m_provider.GetVariantList(eCHILD, triplet.m_nCid,m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        std::vector<const core::COrientedVariant*> ovarListAMMother = m_provider.GetOrientedVariantList(eMOTHER, triplet.m_nMid, true, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const core::COrientedVariant*> ovarListAMChildMC = m_provider.GetOrientedVariantList(eCHILD, triplet.m_nCid, true, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Clear Mother child replay object
-        replayMotherChildGT.Clear();
-        //Change the variant list to process
-        core::CPathReplay replayMotherChildAM(excludedVarsMother, excludedVarsChild2, ovarListAMMother, ovarListAMChildMC);
-        
-        //Find Best Path Mother-Child AM Match
-        m_aBestPathsMotherChildAM[triplet.m_nTripleIndex] = replayMotherChildAM.FindBestPath(ctg, false);
-        const std::vector<const core::COrientedVariant*>& includedVarsChildAMMC = m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsMotherAM = m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
+void CMendelianAnalyzer::RunComparison(int a_nTask, const std::vector<std::string>& a_rUpcomingChrNames)
+{
+    //Read ahead the reference of current and upcoming contigs of this worker while this one is replayed
+    std::vector<std::string> chrNames(1, GetTaskChromosome(a_nTask).m_chrName);
+    chrNames.insert(chrNames.end(), a_rUpcomingChrNames.begin(), a_rUpcomingChrNames.end());
+    m_provider.PrefetchContigs(chrNames, m_fatherChildConfig.m_nPrefetchWindowSize);
+    
+    ProcessChromosome(GetTaskChromosome(a_nTask), a_nTask % 2 == 0);
+}
 
-        const std::vector<const CVariant*> excludedVarsChildMC = m_provider.GetVariantList(excludedVarsChild2, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        const std::vector<const CVariant*> excludedVarsMotherMC = m_provider.GetVariantList(excludedVarsMother, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
+void CMendelianAnalyzer::CompleteComparison(int a_nTask)
+{
+    //Both comparisons are done (fetch_sub also publishes the best paths and status lists of the other comparison to this thread)
+    if(m_aRemainingComparisons[a_nTask / 2].fetch_sub(1) == 1)
+        DecideChromosome(GetTaskChromosome(a_nTask));
+}
 
-        
-        //Set Variant status of child variants
-        m_provider.SetVariantStatus(includedVarsChildAMMC, eALLELE_MATCH);
-        m_provider.SetVariantStatus(includedVarsChildGTMC, eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(excludedVarsChildMC, eNO_MATCH);
-        
-        //Set Variant status of mother variants
-        m_provider.SetVariantStatus(includedVarsMotherGT, eGENOTYPE_MATCH);
-        m_provider.SetVariantStatus(includedVarsMotherAM, eALLELE_MATCH);
-        m_provider.SetVariantStatus(excludedVarsMotherMC, eNO_MATCH);
-        
+int CMendelianAnalyzer::AssignJobsToThreads(int a_nThreadCount)
+{
+    CTaskScheduler scheduler(PrepareComparisonTasks(), a_nThreadCount);
     
-        //Clear Father child replay object
-        replayMotherChildAM.Clear();
-        
-        //Lock the logging mechanism
-        mtx.lock();
-        
-        //Send TP/FP/FN values to the log file
-        m_resultLog.LogBestPathStatistic(true,
-                                         triplet,
-                                         static_cast<int>(includedVarsChildGT.size() + includedVarsChildAM.size()),
-                                         static_cast<int>(m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size() +
-                                                          m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size()),
-                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded().size()),
-                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded().size()));
-        
-        m_resultLog.LogBestPathStatistic(false,
-                                         triplet,
-                                         static_cast<int>(includedVarsChildGTMC.size() + includedVarsChildAMMC.size()),
-                                         static_cast<int>(m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size() +
-                                                          m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size()),
-                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded().size()),
-                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded().size()));
-        
-        //Unlock the logging mechanism
-        mtx.unlock();
-        
-        if(!ctg.Clean())
-        {
-            std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
-        }
+    std::cerr << "[stderr] Evaluating mendelian consistency of variants as their comparisons are completed..." << std::endl;
+    
+    scheduler.Run([&](int a_nTask, int a_nWorkerId)
+    {
+        RunComparisonTask(a_nTask, scheduler.GetQueuedTasks(a_nWorkerId));
+    });
+    
+    return scheduler.GetThreadCount();
+}
+
+void CMendelianAnalyzer::ProcessChromosome(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild)
+{
+    EMendelianVcfName parentName = a_bIsFatherChild ? eFATHER : eMOTHER;
+    int parentChrId = a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid;
+    
+    //Best paths of this parent-child comparison. They are stored by child chromosome id since the comparison may be shared by several trios
+    SParentChildComparison& comparison = m_provider.GetComparison(a_bIsFatherChild);
+    core::CPath& bestPathGT = comparison.m_aBestPathsGT[a_rTriplet.m_nCid];
+    core::CPath& bestPathAM = comparison.m_aBestPathsAM[a_rTriplet.m_nCid];
+    
+    //Status lists of this comparison. Child variants are shared with the other parent-child comparison so they have their own list per comparison
+    std::vector<EVariantMatch>& parentStatusList = m_provider.GetVariantStatusList(parentName, parentChrId, a_bIsFatherChild);
+    std::vector<EVariantMatch>& childStatusList = m_provider.GetVariantStatusList(eCHILD, a_rTriplet.m_nCid, a_bIsFatherChild);
+    
+    //Get variant list of parent-child for given chromosome
+    std::vector<const CVariant*> varListParent = m_provider.GetVariantList(parentName, parentChrId);
+    std::vector<const CVariant*> varListChild = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid);
+    
+    //Get oriented variant list of parent-child for given chromosome
+    std::vector<const core::COrientedVariant*> ovarListGTParent = m_provider.GetOrientedVariantList(parentName, parentChrId);
+    std::vector<const core::COrientedVariant*> ovarListGTChild = m_provider.GetOrientedVariantList(eCHILD, a_rTriplet.m_nCid);
+
+    //Get the chromosome ref seq
+    SContig ctg;
+    bool bIsContigAvailable = m_provider.ReadContig(a_rTriplet.m_chrName, ctg);
+    if(false == bIsContigAvailable)
+    {
+        std::cerr << "Contig " << a_rTriplet.m_chrName << " is not available in given FASTA file!" << std::endl;
+        return;
+    }
+    
+    //Create path replay for parent child;
+    core::CPathReplay replayGT(varListParent, varListChild, ovarListGTParent, ovarListGTChild);
+    replayGT.SetStatusLists(&parentStatusList, &childStatusList);
+    
+    //Find Best Path Parent-Child GT Match
+    bestPathGT = replayGT.FindBestPath(ctg, true);
+    
+    //Genotype Match variants
+    const std::vector<const core::COrientedVariant*>& includedVarsChildGT = bestPathGT.m_calledSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& includedVarsParentGT = bestPathGT.m_baseSemiPath.GetIncludedVariants();
+    
+    //Variants that will be passed for allele match check
+    std::vector<const CVariant*> excludedVarsParent = m_provider.GetVariantList(parentName, parentChrId, bestPathGT.m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> excludedVarsChild = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid, bestPathGT.m_calledSemiPath.GetExcluded());
+    
+    //Allele Match oriented variants
+    std::vector<const core::COrientedVariant*> ovarListAMParent = m_provider.GetOrientedVariantList(parentName, parentChrId, true, bestPathGT.m_baseSemiPath.GetExcluded());
+    std::vector<const core::COrientedVariant*> ovarListAMChild = m_provider.GetOrientedVariantList(eCHILD, a_rTriplet.m_nCid, true, bestPathGT.m_calledSemiPath.GetExcluded());
+    
+    //Clear parent child replay object
+    replayGT.Clear();
+    
+    //Change the variant list to process
+    core::CPathReplay replayAM(excludedVarsParent, excludedVarsChild, ovarListAMParent, ovarListAMChild);
+    replayAM.SetStatusLists(&parentStatusList, &childStatusList);
+    
+    //Find Best Path Parent-Child AM Match
+    bestPathAM = replayAM.FindBestPath(ctg, false);
+    const std::vector<const core::COrientedVariant*>& includedVarsChildAM = bestPathAM.m_calledSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& includedVarsParentAM = bestPathAM.m_baseSemiPath.GetIncludedVariants();
+
+    const std::vector<const CVariant*> excludedVarsChildFinal = m_provider.GetVariantList(excludedVarsChild, bestPathAM.m_calledSemiPath.GetExcluded());
+    const std::vector<const CVariant*> excludedVarsParentFinal = m_provider.GetVariantList(excludedVarsParent, bestPathAM.m_baseSemiPath.GetExcluded());
+    
+    //Set Variant status of child variants
+    CMendelianVariantProvider::SetVariantStatus(childStatusList, includedVarsChildAM, eALLELE_MATCH);
+    CMendelianVariantProvider::SetVariantStatus(childStatusList, includedVarsChildGT, eGENOTYPE_MATCH);
+    CMendelianVariantProvider::SetVariantStatus(childStatusList, excludedVarsChildFinal, eNO_MATCH);
+    
+    //Set Variant status of parent variants
+    CMendelianVariantProvider::SetVariantStatus(parentStatusList, includedVarsParentGT, eGENOTYPE_MATCH);
+    CMendelianVariantProvider::SetVariantStatus(parentStatusList, includedVarsParentAM, eALLELE_MATCH);
+    CMendelianVariantProvider::SetVariantStatus(parentStatusList, excludedVarsParentFinal, eNO_MATCH);
+
+    //Clear parent child replay object
+    replayAM.Clear();
+    
+    //Decision phase processes the included variants in the order of variant ids
+    bestPathGT.SortIncludedVariants();
+    bestPathAM.SortIncludedVariants();
+    
+    if(!ctg.Clean())
+    {
+        std::cerr << ctg.m_chromosomeName << " not cleaned.." << std::endl;
     }
 }
 
+void CMendelianAnalyzer::LogBestPathStatistic(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild)
+{
+    const SParentChildComparison& comparison = m_provider.GetComparison(a_bIsFatherChild);
+    const core::CPath& bestPathGT = comparison.m_aBestPathsGT[a_rTriplet.m_nCid];
+    const core::CPath& bestPathAM = comparison.m_aBestPathsAM[a_rTriplet.m_nCid];
+    
+    m_resultLog.LogBestPathStatistic(a_bIsFatherChild,
+                                     a_rTriplet,
+                                     static_cast<int>(bestPathGT.m_calledSemiPath.GetIncludedVariants().size() + bestPathAM.m_calledSemiPath.GetIncludedVariants().size()),
+                                     static_cast<int>(bestPathGT.m_baseSemiPath.GetIncludedVariants().size() + bestPathAM.m_baseSemiPath.GetIncludedVariants().size()),
+                                     static_cast<int>(bestPathAM.m_calledSemiPath.GetExcluded().size()),
+                                     static_cast<int>(bestPathAM.m_baseSemiPath.GetExcluded().size()));
+}
+
+void CMendelianAnalyzer::DecideChromosome(const SChrIdTriplet& a_rTriplet)
+{
+    //Statistics are logged by the family since the comparisons may be shared by several trios
+    LogBestPathStatistic(a_rTriplet, true);
+    LogBestPathStatistic(a_rTriplet, false);
+    
+    //Initialize the decision arrays. All decisions are unknown at the beginning
+    std::vector<EMendelianDecision> childDecisions(m_provider.GetVariantCount(eCHILD, a_rTriplet.m_nCid), eUnknown);
+    std::vector<EMendelianDecision> motherDecisions(m_provider.GetVariantCount(eMOTHER, a_rTriplet.m_nMid), eUnknown);
+    std::vector<EMendelianDecision> fatherDecisions(m_provider.GetVariantCount(eFATHER, a_rTriplet.m_nFid), eUnknown);
+    
+    //Merge the chromosome and fill the decisions arrays
+    m_mendelianDecider.MergeFunc(a_rTriplet, motherDecisions, fatherDecisions, childDecisions);
+    
+    //Merge the trio records of the chromosome. They are written once all previous chromosomes are written
+    m_trioWriter.AddChromosome(a_rTriplet, motherDecisions, fatherDecisions, childDecisions);
+}
+
 void CMendelianAnalyzer::PrintHelp() const
 {
     std::cout << std::endl;
@@ -569,6 +629,10 @@ void CMendelianAnalyzer::PrintHelp() const
     std::cout << "-sample-mother <sample_name> [Optional.Read only the given sample in mother VCF. Default value is the first sample.]" << std::endl;
     std::cout << "-sample-child <sample_name>  [Optional.Read only the given sample in child VCF. Default value is the first sample.]" << std::endl;
     std::cout << "-thread-count                [Optional.Specify the number of threads that program will use. Default value is 2]" << std::endl;
+    std::cout << "-reference-cache <cache_dir> [Optional.Store the reference as a memory mapped cache file in cache_dir which is shared by all threads and later runs. Default is reading contigs from FASTA]" << std::endl;
+    std::cout << "-prefetch-window <size_mb>   [Optional.Read ahead the reference of upcoming contigs of each thread up to given size in MB. Requires -reference-cache. 0 disables prefetching. Default value is 512]" << std::endl;
+    std::cout << "-output-format <format>      [Optional.File format of the output trio vcf. Possible values: vcf, vcf.gz (bgzipped + tabix index), bcf (+ csi index). Default value is vcf]" << std::endl;
+    std::cout << "-compression-level [0-9]     [Optional.Compression level of vcf.gz/bcf outputs. Default value is 6]" << std::endl;
     std::cout << std::endl;
     std::cout << "Example Commands:" << std::endl;
     std::cout << "./vbt mendelian -mother mother.vcf -father father.vcf -child child.vcf -ref reference.fasta -outDir SampleResultDir -filter none -no-call explicit" << std::endl;
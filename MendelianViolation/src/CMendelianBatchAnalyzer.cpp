@@ -0,0 +1,551 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CMendelianBatchAnalyzer.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CMendelianBatchAnalyzer.h"
+#include "CMendelianAnalyzer.h"
+#include "CSimpleBEDParser.h"
+#include "CTaskScheduler.h"
+#include "Utils/CUtils.h"
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <ctime>
+
+using namespace mendelian;
+
+int CMendelianBatchAnalyzer::run(int argc, char** argv)
+{
+    std::time_t start = std::time(0);
+    
+    //Reads the command line parameters
+    if(!ReadParameters(argc, argv))
+        return -1;
+    
+    //Find the trios of the pedigree that exist in the joint vcf
+    CVcfReader headerReader;
+    if(!headerReader.Open(m_config.m_pBaseVcfFileName))
+    {
+        std::cerr << "Joint VCF file is unable to open!: " << m_config.m_pBaseVcfFileName << std::endl;
+        return -1;
+    }
+    std::vector<std::string> sampleNames;
+    headerReader.GetSampleNames(sampleNames);
+    headerReader.Close();
+    
+    CSimplePEDParser pedParser;
+    pedParser.ParsePedigree(m_config.m_pPedigreeFileName);
+    m_aTrios = pedParser.GetTrios(sampleNames);
+    
+    if(m_aTrios.empty())
+    {
+        std::cerr << "No trio of the pedigree file could be found in the joint VCF" << std::endl;
+        return -1;
+    }
+    
+    std::cerr << "[stderr] " << m_aTrios.size() << " trios are found in the pedigree file" << std::endl;
+    
+    //Only the members of the trios are decoded
+    m_aSampleNames.clear();
+    for(const SFamilyTrio& trio : m_aTrios)
+    {
+        for(const std::string* pMember : {&trio.m_motherId, &trio.m_fatherId, &trio.m_childId})
+        {
+            if(std::find(m_aSampleNames.begin(), m_aSampleNames.end(), *pMember) == m_aSampleNames.end())
+                m_aSampleNames.push_back(*pMember);
+        }
+    }
+    
+    if(!m_jointVcf.Open(m_config.m_pBaseVcfFileName, m_aSampleNames))
+        return -1;
+    
+    //Seek directly to BED regions if the input is indexed. Otherwise whole file is scanned and filtered by each family
+    CSimpleBEDParser bedParser;
+    if(true == m_config.m_bInitializeFromBed)
+    {
+        bedParser.InitBEDFile(m_config.m_pBedFileName);
+        if(m_jointVcf.SetRegions(bedParser))
+            std::cerr << "Reading only BED regions of joint vcf using its index" << std::endl;
+    }
+    
+    //Decode the joint vcf once for all families
+    m_jointVcf.Load(m_config);
+    
+    std::time_t duration = std::time(0) - start;
+    std::cerr << "[stderr] Joint vcf read completed in " << duration << " secs" << std::endl;
+    
+    //Samples are generated from the joint vcf by a single provider
+    if(!m_sampleLoader.InitializeFromJointVcf(m_config, m_config, m_jointVcf))
+        return -1;
+    
+    //Output names of each trio, and the usage of samples and parent-child comparisons by the trios
+    m_aSampleUseCounts = std::vector<int>(m_aSampleNames.size(), 0);
+    m_aSamples = std::vector<std::unique_ptr<SMendelianSampleVariants>>(m_aSampleNames.size());
+    m_comparisons.clear();
+    m_aOutputPrefixes.clear();
+    for(const SFamilyTrio& trio : m_aTrios)
+    {
+        int motherIndex = m_jointVcf.GetSampleIndex(trio.m_motherId);
+        int fatherIndex = m_jointVcf.GetSampleIndex(trio.m_fatherId);
+        int childIndex = m_jointVcf.GetSampleIndex(trio.m_childId);
+        
+        m_aOutputPrefixes.push_back(std::string(m_config.m_output_prefix) + "_" + trio.m_familyId + "_" + trio.m_childId);
+        m_aSampleUseCounts[motherIndex]++;
+        m_aSampleUseCounts[fatherIndex]++;
+        m_aSampleUseCounts[childIndex]++;
+        
+        for(int parentIndex : {fatherIndex, motherIndex})
+        {
+            std::unique_ptr<SPedigreeComparison>& pComparison = m_comparisons[std::make_pair(parentIndex, childIndex)];
+            if(!pComparison)
+                pComparison.reset(new SPedigreeComparison());
+            pComparison->m_nUseCount++;
+        }
+    }
+    
+    std::cerr << "[stderr] " << m_comparisons.size() << " unique parent-child pairs will be compared for " << m_aSampleNames.size() << " samples" << std::endl;
+    
+    int batchSize = m_nFamilyBatchSize > 0 ? m_nFamilyBatchSize : m_config.m_nThreadCount;
+    int trioCount = static_cast<int>(m_aTrios.size());
+    
+    for(int batchStart = 0; batchStart < trioCount; batchStart += batchSize)
+        ProcessFamilyBatch(batchStart, std::min(trioCount, batchStart + batchSize));
+    
+    duration = std::time(0) - start;
+    std::cerr << "[stderr] Total execution time is " << duration << " secs" << std::endl;
+    
+    return 0;
+}
+
+void CMendelianBatchAnalyzer::LoadSamples(int a_nStart, int a_nEnd)
+{
+    std::vector<int> sampleIndexes;
+    std::vector<double> loadCosts;
+    
+    for(int k = a_nStart; k < a_nEnd; k++)
+    {
+        for(const std::string* pMember : {&m_aTrios[k].m_motherId, &m_aTrios[k].m_fatherId, &m_aTrios[k].m_childId})
+        {
+            int sampleIndex = m_jointVcf.GetSampleIndex(*pMember);
+            if(m_aSamples[sampleIndex])
+                continue;
+            
+            //Cost of a sample is its stored genotype count
+            m_aSamples[sampleIndex].reset(new SMendelianSampleVariants());
+            sampleIndexes.push_back(sampleIndex);
+            loadCosts.push_back(m_jointVcf.GetGenotypeCount(sampleIndex));
+        }
+    }
+    
+    if(sampleIndexes.empty())
+        return;
+    
+    std::cerr << "[stderr] Generating the variants of " << sampleIndexes.size() << " samples..." << std::endl;
+    
+    CTaskScheduler loadScheduler(loadCosts, m_config.m_nThreadCount);
+    loadScheduler.Run([&](int a_nTask, int a_nWorkerId)
+    {
+        int sampleIndex = sampleIndexes[a_nTask];
+        m_sampleLoader.LoadJointVcfSample(sampleIndex, m_aSampleNames[sampleIndex], *m_aSamples[sampleIndex]);
+    });
+    
+    //Genotypes are not needed anymore once the variants of the sample are generated
+    for(int sampleIndex : sampleIndexes)
+        m_jointVcf.ReleaseSample(sampleIndex);
+}
+
+SParentChildComparison* CMendelianBatchAnalyzer::GetComparison(int a_nParentIndex, int a_nChildIndex)
+{
+    SPedigreeComparison& comparison = *m_comparisons[std::make_pair(a_nParentIndex, a_nChildIndex)];
+    
+    if(comparison.m_aIsCompared.empty())
+    {
+        CMendelianVariantProvider::InitializeComparison(comparison.m_comparison, *m_aSamples[a_nParentIndex], *m_aSamples[a_nChildIndex]);
+        comparison.m_aIsCompared = std::vector<char>(m_aSamples[a_nChildIndex]->m_aVariantList.size(), 0);
+    }
+    
+    return &comparison.m_comparison;
+}
+
+void CMendelianBatchAnalyzer::ProcessFamilyBatch(int a_nStart, int a_nEnd)
+{
+    int familyCount = a_nEnd - a_nStart;
+    std::vector<std::unique_ptr<CMendelianAnalyzer>> families(familyCount);
+    std::vector<char> isInitialized(familyCount, 0);
+    
+    std::cerr << "[stderr] Processing families " << a_nStart + 1 << "-" << a_nEnd << " of " << m_aTrios.size() << std::endl;
+    
+    //Generate the variants of the samples which are not loaded by the previous batches
+    LoadSamples(a_nStart, a_nEnd);
+    
+    //Families point to the shared samples and parent-child comparisons
+    for(int k = 0; k < familyCount; k++)
+    {
+        const SFamilyTrio& trio = m_aTrios[a_nStart + k];
+        int motherIndex = m_jointVcf.GetSampleIndex(trio.m_motherId);
+        int fatherIndex = m_jointVcf.GetSampleIndex(trio.m_fatherId);
+        int childIndex = m_jointVcf.GetSampleIndex(trio.m_childId);
+        
+        SConfig familyConfig = m_config;
+        familyConfig.m_pCalledVcfFileName = m_config.m_pBaseVcfFileName;
+        familyConfig.m_output_prefix = m_aOutputPrefixes[a_nStart + k].c_str();
+        //Trio vcfs of all families in the batch are open at the same time. Chunks are already compressed by the comparison workers,
+        //so each family writer uses a single thread instead of a thread pool of its own
+        familyConfig.m_nThreadCount = 1;
+        
+        families[k].reset(new CMendelianAnalyzer());
+        isInitialized[k] = families[k]->InitializeFamily(familyConfig,
+                                                         familyConfig,
+                                                         m_noCallMode,
+                                                         m_jointVcf,
+                                                         m_aSamples[motherIndex].get(),
+                                                         m_aSamples[fatherIndex].get(),
+                                                         m_aSamples[childIndex].get(),
+                                                         GetComparison(fatherIndex, childIndex),
+                                                         GetComparison(motherIndex, childIndex));
+        if(!isInitialized[k])
+            std::cerr << "Family " << trio.m_familyId << " (child " << trio.m_childId << ") could not be initialized" << std::endl;
+    }
+    
+    //Each chromosome of a unique parent-child pair is compared once by one of the families that require it (owner).
+    //All families that require it are notified when it is completed, and the chromosome of a family is decided once both of its comparisons are completed
+    struct SComparisonTask
+    {
+        SPedigreeComparison* m_pComparison;
+        int m_nChrId;
+        std::string m_chrName;
+        //Family and the task id in the family which runs the comparison
+        int m_nOwnerFamily;
+        int m_nOwnerTask;
+        //Families and their task ids which wait for the comparison [(family, task)]
+        std::vector<std::pair<int, int>> m_aConsumers;
+    };
+    
+    std::vector<SComparisonTask> tasks;
+    std::vector<double> taskCosts;
+    std::map<std::pair<SPedigreeComparison*, int>, int> taskIndexes;
+    std::vector<std::pair<int, int>> completedComparisons;
+    
+    for(int k = 0; k < familyCount; k++)
+    {
+        if(!isInitialized[k])
+            continue;
+        
+        const SFamilyTrio& trio = m_aTrios[a_nStart + k];
+        int childIndex = m_jointVcf.GetSampleIndex(trio.m_childId);
+        std::vector<double> familyCosts = families[k]->PrepareComparisonTasks();
+        
+        for(int task = 0; task < static_cast<int>(familyCosts.size()); task++)
+        {
+            //[task 2k: father-child, task 2k+1: mother-child of chromosome k]
+            int parentIndex = m_jointVcf.GetSampleIndex(task % 2 == 0 ? trio.m_fatherId : trio.m_motherId);
+            SPedigreeComparison* pComparison = m_comparisons[std::make_pair(parentIndex, childIndex)].get();
+            const SChrIdTriplet& triplet = families[k]->GetTaskChromosome(task);
+            
+            //Comparison is already computed by a previous batch
+            if(pComparison->m_aIsCompared[triplet.m_nCid])
+            {
+                completedComparisons.push_back(std::make_pair(k, task));
+                continue;
+            }
+            
+            auto taskItr = taskIndexes.find(std::make_pair(pComparison, triplet.m_nCid));
+            if(taskItr == taskIndexes.end())
+            {
+                SComparisonTask comparisonTask;
+                comparisonTask.m_pComparison = pComparison;
+                comparisonTask.m_nChrId = triplet.m_nCid;
+                comparisonTask.m_chrName = triplet.m_chrName;
+                comparisonTask.m_nOwnerFamily = k;
+                comparisonTask.m_nOwnerTask = task;
+                
+                taskItr = taskIndexes.insert(std::make_pair(std::make_pair(pComparison, triplet.m_nCid), static_cast<int>(tasks.size()))).first;
+                tasks.push_back(comparisonTask);
+                taskCosts.push_back(familyCosts[task]);
+            }
+            
+            tasks[taskItr->second].m_aConsumers.push_back(std::make_pair(k, task));
+        }
+    }
+    
+    //Chromosomes whose comparisons are all computed by the previous batches are decided before the new comparisons start
+    for(const std::pair<int, int>& completed : completedComparisons)
+        families[completed.first]->CompleteComparison(completed.second);
+    
+    std::cerr << "[stderr] Running best path algorithm pipeline for " << taskCosts.size() << " parent-child comparisons..." << std::endl;
+    
+    CTaskScheduler scheduler(taskCosts, m_config.m_nThreadCount);
+    scheduler.Run([&](int a_nTask, int a_nWorkerId)
+    {
+        SComparisonTask& task = tasks[a_nTask];
+        
+        //Upcoming contigs of the worker are prefetched. Reference cache is shared by all families
+        std::vector<std::string> upcomingChrNames;
+        for(int queuedTask : scheduler.GetQueuedTasks(a_nWorkerId))
+            upcomingChrNames.push_back(tasks[queuedTask].m_chrName);
+        
+        families[task.m_nOwnerFamily]->RunComparison(task.m_nOwnerTask, upcomingChrNames);
+        task.m_pComparison->m_aIsCompared[task.m_nChrId] = 1;
+        
+        for(const std::pair<int, int>& consumer : task.m_aConsumers)
+            families[consumer.first]->CompleteComparison(consumer.second);
+    });
+    
+    //Write the outputs of each family and release the family, the samples and the comparisons that are not used anymore
+    for(int k = 0; k < familyCount; k++)
+    {
+        const SFamilyTrio& trio = m_aTrios[a_nStart + k];
+        
+        if(isInitialized[k])
+        {
+            std::cerr << "[stderr] Writing outputs of family " << trio.m_familyId << " (child " << trio.m_childId << ")" << std::endl;
+            families[k]->WriteResults();
+        }
+        families[k].reset();
+        
+        int childIndex = m_jointVcf.GetSampleIndex(trio.m_childId);
+        for(const std::string* pParent : {&trio.m_fatherId, &trio.m_motherId})
+        {
+            auto comparisonItr = m_comparisons.find(std::make_pair(m_jointVcf.GetSampleIndex(*pParent), childIndex));
+            if(--comparisonItr->second->m_nUseCount == 0)
+                m_comparisons.erase(comparisonItr);
+        }
+        
+        for(const std::string* pMember : {&trio.m_motherId, &trio.m_fatherId, &trio.m_childId})
+        {
+            int sampleIndex = m_jointVcf.GetSampleIndex(*pMember);
+            if(--m_aSampleUseCounts[sampleIndex] == 0)
+                m_aSamples[sampleIndex].reset();
+        }
+    }
+}
+
+bool CMendelianBatchAnalyzer::ReadParameters(int argc, char** argv)
+{
+    const char* PARAM_HELP = "--help";
+    
+    const char* PARAM_VCF = "-vcf";
+    const char* PARAM_PEDIGREE = "-pedigree";
+    const char* PARAM_REFERENCE = "-ref";
+    const char* PARAM_OUTPUT_DIR = "-outDir";
+    const char* PARAM_FILTER = "-filter";
+    const char* PARAM_BED = "-bed";
+    const char* PARAM_REF_OVERLAP = "--disable-ref-overlap";
+    const char* PARAM_THREAD_COUNT = "-thread-count";
+    const char* PARAM_NO_CALL = "-no-call";
+    const char* PARAM_PRINT_INFO = "-output-info-tags";
+    const char* PARAM_OUTPUT_PREFIX = "-out-prefix";
+    const char* PARAM_AUTOSOME_ONLY = "--autosome-only";
+    const char* PARAM_REFERENCE_CACHE = "-reference-cache";
+    const char* PARAM_PREFETCH_WINDOW = "-prefetch-window";
+    const char* PARAM_OUTPUT_FORMAT = "-output-format";
+    const char* PARAM_COMPRESSION_LEVEL = "-compression-level";
+    const char* PARAM_FAMILY_BATCH_SIZE = "-family-batch-size";
+    
+    bool bVcfSet = false;
+    bool bPedigreeSet = false;
+    bool bReferenceSet = false;
+    bool bOutputDirSet = false;
+    
+    m_config.m_bTrimBeginningFirst = false;
+    
+    //Start from index 2 since first parameter will be mendelian-batch mode indicator
+    int it = 2;
+    
+    while(it < argc)
+    {
+        if(0 == strcmp(argv[it], PARAM_HELP))
+        {
+            PrintHelp();
+            return false;
+        }
+        
+        //Parameters without value
+        else if(0 == strcmp(argv[it], PARAM_REF_OVERLAP))
+        {
+            m_config.m_bIsRefOverlap = false;
+            it++;
+            continue;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_AUTOSOME_ONLY))
+        {
+            m_config.m_bAutosomeOnly = true;
+            it++;
+            continue;
+        }
+        
+        else if(it + 1 >= argc)
+        {
+            std::cerr << "Missing value of the parameter: " << argv[it] << std::endl;
+            return false;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_VCF))
+        {
+            m_config.m_pBaseVcfFileName = argv[it+1];
+            m_config.m_pCalledVcfFileName = argv[it+1];
+            bVcfSet = true;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_PEDIGREE))
+        {
+            m_config.m_pPedigreeFileName = argv[it+1];
+            bPedigreeSet = true;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_REFERENCE))
+        {
+            m_config.m_pFastaFileName = argv[it+1];
+            bReferenceSet = true;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_OUTPUT_DIR))
+        {
+            m_config.m_pOutputDirectory = argv[it+1];
+            bOutputDirSet = true;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_BED))
+        {
+            m_config.m_bInitializeFromBed = true;
+            m_config.m_pBedFileName = argv[it+1];
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_FILTER))
+        {
+            if(0 == strcmp("none", argv[it+1]))
+                m_config.m_bIsFilterEnabled = false;
+            else
+            {
+                m_config.m_bIsFilterEnabled = true;
+                m_config.m_pFilterName = argv[it+1];
+            }
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_NO_CALL))
+        {
+            if(0 == strcmp("none", argv[it+1]))
+                m_noCallMode = ENoCallMode::eNone;
+            else
+                m_noCallMode = ENoCallMode::eExplicitNoCall;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_OUTPUT_PREFIX))
+            m_config.m_output_prefix = argv[it+1];
+        
+        else if(0 == strcmp(argv[it], PARAM_PRINT_INFO))
+        {
+            m_config.m_bIsReadINFO = true;
+            m_config.m_infotags = std::string(argv[it+1]);
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_THREAD_COUNT))
+            m_config.m_nThreadCount = std::max(1, atoi(argv[it+1]));
+        
+        else if(0 == strcmp(argv[it], PARAM_REFERENCE_CACHE))
+        {
+            m_config.m_bUseReferenceCache = true;
+            m_config.m_pReferenceCacheDirectory = argv[it+1];
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_PREFETCH_WINDOW))
+            m_config.m_nPrefetchWindowSize = std::max(0, atoi(argv[it+1]));
+        
+        else if(0 == strcmp(argv[it], PARAM_FAMILY_BATCH_SIZE))
+            m_nFamilyBatchSize = std::max(1, atoi(argv[it+1]));
+        
+        else if(0 == strcmp(argv[it], PARAM_OUTPUT_FORMAT))
+        {
+            EVcfOutputFormat format = eVCF_TEXT;
+            if(0 == strcmp(argv[it+1], "vcf.gz"))
+                format = eVCF_BGZF;
+            else if(0 == strcmp(argv[it+1], "bcf"))
+                format = eBCF;
+            else if(0 != strcmp(argv[it+1], "vcf"))
+                std::cerr << "Unknown output format: " << argv[it+1] << ". Output format is set to vcf" << std::endl;
+            
+            m_config.m_outputFormat = format;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_COMPRESSION_LEVEL))
+            m_config.m_nCompressionLevel = std::min(std::max(0, atoi(argv[it+1])), 9);
+        
+        else
+        {
+            std::cerr << "Unknown Command or Argument: " << argv[it] << std::endl;
+            std::cerr << "Use the following command for parameter usage:" << std::endl;
+            std::cerr << "./vbt mendelian-batch --help" << std::endl;
+            return false;
+        }
+        
+        it += 2;
+    }
+    
+    if(!bVcfSet)
+        std::cerr << "Joint vcf file is not set" << std::endl;
+    else if(!bPedigreeSet)
+        std::cerr << "Pedigree file is not set" << std::endl;
+    else if(!bReferenceSet)
+        std::cerr << "Reference fasta file is not set" << std::endl;
+    else if(!bOutputDirSet)
+        std::cerr << "Output Directory is not set" << std::endl;
+    else if(!CUtils::IsFileExists(m_config.m_pBaseVcfFileName))
+    {
+        std::cerr << "Joint vcf file path is wrong" << std::endl;
+        return false;
+    }
+    else if(!CUtils::IsFileExists(m_config.m_pPedigreeFileName))
+    {
+        std::cerr << "Pedigree file path is wrong" << std::endl;
+        return false;
+    }
+    
+    return bVcfSet && bPedigreeSet && bReferenceSet && bOutputDirSet;
+}
+
+void CMendelianBatchAnalyzer::PrintHelp() const
+{
+    std::cout << std::endl;
+    std::cout << " --- MENDELIAN BATCH PARAMETERS --- " << std::endl;
+    std::cout << "-vcf <joint_vcf_path>        [Required.Add joint-called multi-sample VCF file of the cohort.]" << std::endl;
+    std::cout << "-pedigree <PED_file_path>    [Required.Add PED file of the cohort. Every child whose parents are in the VCF is analyzed as a trio]" << std::endl;
+    std::cout << "-ref <reference_fasta_path>  [Required.Add reference FASTA file]" << std::endl;
+    std::cout << "-outDir <output_directory>   [Required.Add output directory. Outputs of each trio are prefixed with <out-prefix>_<family_id>_<child_id>]" << std::endl;
+    std::cout << "-no-call <no_call_mode>      [Optional. Decides what to do with no call variants. There are 2 modes:" << std::endl;
+    std::cout << "\t" << "explicit : [Default Value] mark variants with ./. genotype as NoCall. All other unknown sites will be treated as 0/0" << std::endl;
+    std::cout << "\t" << "none : Treat all unknown variants including ./. genotype will be treated as 0/0" << std::endl;
+    std::cout << "-filter <filter_name>        [Optional.Filter variants based on filter column. Default value is PASS. Use 'none' to disable filtering]" << std::endl;
+    std::cout << "-bed <BED_file_path>         [Optional.Analyze only the variants in the given BED regions]" << std::endl;
+    std::cout << "--disable-ref-overlap        [Optional.Disable reference overlapping. Does not trim alleles]" << std::endl;
+    std::cout << "--autosome-only              [Optional.Analyze only the autosomes]" << std::endl;
+    std::cout << "-thread-count                [Optional.Specify the number of threads that program will use. Default value is 2]" << std::endl;
+    std::cout << "-family-batch-size <count>   [Optional.Number of families that are kept in memory and processed together on the thread pool. Default value is the thread count]" << std::endl;
+    std::cout << "-reference-cache <cache_dir> [Optional.Store the reference as a memory mapped cache file in cache_dir which is shared by all threads and later runs. Default is reading contigs from FASTA]" << std::endl;
+    std::cout << "-prefetch-window <size_mb>   [Optional.Read ahead the reference of upcoming contigs of each thread up to given size in MB. Requires -reference-cache. 0 disables prefetching. Default value is 512]" << std::endl;
+    std::cout << "-output-format <format>      [Optional.File format of the output trio vcfs. Possible values: vcf, vcf.gz (bgzipped + tabix index), bcf (+ csi index). Default value is vcf]" << std::endl;
+    std::cout << "-compression-level [0-9]     [Optional.Compression level of vcf.gz/bcf outputs. Default value is 6]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Example Command:" << std::endl;
+    std::cout << "./vbt mendelian-batch -vcf cohort.vcf.gz -pedigree cohort.ped -ref reference.fasta -outDir CohortResultDir -thread-count 16 -family-batch-size 8" << std::endl;
+}
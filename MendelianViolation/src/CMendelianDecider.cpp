@@ -31,67 +31,75 @@
 #include "CMendelianResultLog.h"
 #include "Utils/CUtils.h"
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 using namespace mendelian;
 
-CMendelianDecider::CMendelianDecider(std::vector<core::CPath>& a_aBestPathsFatherChildGT,
-                                    std::vector<core::CPath>& a_aBestPathsFatherChildAM,
-                                     std::vector<core::CPath>& a_aBestPathsMotherChildGT,
-                                     std::vector<core::CPath>& a_aBestPathsMotherChildAM,
-                                     CMendelianVariantProvider& a_rProvider,
-                                     CMendelianResultLog& a_rResultLog) :
-m_aBestPathsFatherChildGT(a_aBestPathsFatherChildGT),
-m_aBestPathsFatherChildAM(a_aBestPathsFatherChildAM),
-m_aBestPathsMotherChildGT(a_aBestPathsMotherChildGT),
-m_aBestPathsMotherChildAM(a_aBestPathsMotherChildAM),
+CMendelianDecider::CMendelianDecider(const CMendelianVariantProvider& a_rProvider, CMendelianResultLog& a_rResultLog) :
 m_provider(a_rProvider),
 m_resultLog(a_rResultLog)
 {
 }
 
+const core::CPath& CMendelianDecider::GetBestPath(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild, bool a_bIsGT) const
+{
+    //Comparisons may be shared by several trios, so best paths are stored by chromosome id instead of the triple index
+    const SParentChildComparison& comparison = m_provider.GetComparison(a_bIsFatherChild);
+    return a_bIsGT ? comparison.m_aBestPathsGT[a_rTriplet.m_nCid] : comparison.m_aBestPathsAM[a_rTriplet.m_nCid];
+}
+
 void CMendelianDecider::SetNocallMode(ENoCallMode a_nMode)
 {
     m_nocallMode = a_nMode;
 }
 
-void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, SChrIdTriplet& a_rTriplet,
-                                        const std::vector<const CVariant*>& a_rVariantList,
-                                        std::vector<bool>& a_rSideDecisions,
-                                        const std::vector<EMendelianDecision>& a_rParentSelfDecisions,
-                                        const std::vector<EMendelianDecision>& a_rChildDecisions)
+const CVariant* CMendelianDecider::GetExcludedVariant(const std::vector<CVariant>& a_rVariants,
+                                                      const std::vector<int>& a_rExcludedGT,
+                                                      const std::vector<int>* a_pExcludedAM,
+                                                      unsigned int a_nIndex)
+{
+    return &a_rVariants[a_pExcludedAM == NULL ? a_rExcludedGT[a_nIndex] : a_rExcludedGT[(*a_pExcludedAM)[a_nIndex]]];
+}
+
+void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, const SChrIdTriplet& a_rTriplet,
+                                        std::vector<EMendelianDecision>& a_rParentSelfDecisions,
+                                        const std::vector<EMendelianDecision>& a_rChildDecisions) const
 {
-    std::vector<const CVariant*> varListToCheckChild = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid);
-    std::vector<const CVariant*> varListToCheckParent = a_checkSide == eMOTHER ? m_provider.GetVariantList(eFATHER, a_rTriplet.m_nFid) : m_provider.GetVariantList(eMOTHER, a_rTriplet.m_nMid);
-    std::vector<const CVariant*> varListToCheckSelf = a_checkSide == eFATHER ? m_provider.GetVariantList(eFATHER, a_rTriplet.m_nFid) : m_provider.GetVariantList(eMOTHER, a_rTriplet.m_nMid);
+    const std::vector<CVariant>& varListToCheckChild = m_provider.GetVariants(eCHILD, a_rTriplet.m_nCid);
+    const std::vector<CVariant>& varListToCheckSelf = a_checkSide == eFATHER ? m_provider.GetVariants(eFATHER, a_rTriplet.m_nFid) : m_provider.GetVariants(eMOTHER, a_rTriplet.m_nMid);
     
+    //Parent variants excluded from both genotype and allele match best paths
+    const std::vector<int>& excludedGT = GetBestPath(a_rTriplet, a_checkSide == eFATHER, true).m_baseSemiPath.GetExcluded();
+    const std::vector<int>& excludedAM = GetBestPath(a_rTriplet, a_checkSide == eFATHER, false).m_baseSemiPath.GetExcluded();
     
     unsigned int varItrChild = 0;
     unsigned int varItrSelf = 0;
     
-    for(unsigned int k = 0; k < a_rVariantList.size(); k++)
+    for(unsigned int k = 0; k < excludedAM.size(); k++)
     {
+        const CVariant* pVar = GetExcludedVariant(varListToCheckSelf, excludedGT, &excludedAM, k);
         
         //Check if the variant is already marked
-        if(a_rParentSelfDecisions[a_rVariantList[k]->m_nId] != eUnknown)
+        if(a_rParentSelfDecisions[pVar->m_nId] != eUnknown)
         {
-            a_rSideDecisions[k] = a_rParentSelfDecisions[a_rVariantList[k]->m_nId] == eCompliant ? true : false;
+            a_rParentSelfDecisions[pVar->m_nId] = a_rParentSelfDecisions[pVar->m_nId] == eCompliant ? eCompliant : eViolation;
             continue;
         }
         
         //If variant does not have 0 allele
-        else if(a_rVariantList[k]->m_genotype[0] != 0 && a_rVariantList[k]->m_genotype[1] != 0)
+        else if(pVar->m_genotype[0] != 0 && pVar->m_genotype[1] != 0)
         {
-            a_rSideDecisions[k] = false;
+            a_rParentSelfDecisions[pVar->m_nId] = eViolation;
             continue;
         }
         
         //Skip child variants until end position of child variant is more than our current Parent variant start position
-        while(varItrChild <  varListToCheckChild.size() && varListToCheckChild[varItrChild]->m_nEndPos <= a_rVariantList[k]->m_nStartPos)
+        while(varItrChild <  varListToCheckChild.size() && varListToCheckChild[varItrChild].m_nEndPos <= pVar->m_nStartPos)
             varItrChild++;
         
         //Skip self variants until end position of child variant is more than our current Parent variant start position
-        while(varItrSelf <  varListToCheckSelf.size() && varListToCheckSelf[varItrSelf]->m_nEndPos <= a_rVariantList[k]->m_nStartPos)
+        while(varItrSelf <  varListToCheckSelf.size() && varListToCheckSelf[varItrSelf].m_nEndPos <= pVar->m_nStartPos)
             varItrSelf++;
         
         unsigned int counterChild = 0;
@@ -101,18 +109,18 @@ void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, SChrIdTri
         std::vector<const CVariant*> selfSideMatches;
         
         //Get All overlapping variants in child side
-        while(varItrChild + counterChild < varListToCheckChild.size() && varListToCheckChild[varItrChild+counterChild]->m_nStartPos < a_rVariantList[k]->m_nEndPos)
+        while(varItrChild + counterChild < varListToCheckChild.size() && varListToCheckChild[varItrChild+counterChild].m_nStartPos < pVar->m_nEndPos)
         {
-            if(CUtils::IsOverlap(a_rVariantList[k]->m_nStartPos, a_rVariantList[k]->m_nEndPos, varListToCheckChild[varItrChild+counterChild]->m_nStartPos, varListToCheckChild[varItrChild+counterChild]->m_nEndPos))
-                childSideMatches.push_back(varListToCheckChild[varItrChild+counterChild]);
+            if(CUtils::IsOverlap(pVar->m_nStartPos, pVar->m_nEndPos, varListToCheckChild[varItrChild+counterChild].m_nStartPos, varListToCheckChild[varItrChild+counterChild].m_nEndPos))
+                childSideMatches.push_back(&varListToCheckChild[varItrChild+counterChild]);
             counterChild++;
         }
         
         //Get All overlapping variants in self side
-        while(varItrSelf + counterSelf < varListToCheckSelf.size() && varListToCheckSelf[varItrSelf+counterSelf]->m_nStartPos < a_rVariantList[k]->m_nEndPos)
+        while(varItrSelf + counterSelf < varListToCheckSelf.size() && varListToCheckSelf[varItrSelf+counterSelf].m_nStartPos < pVar->m_nEndPos)
         {
-            if(CUtils::IsOverlap(a_rVariantList[k]->m_nStartPos, a_rVariantList[k]->m_nEndPos, varListToCheckSelf[varItrSelf+counterSelf]->m_nStartPos, varListToCheckSelf[varItrSelf+counterSelf]->m_nEndPos))
-                selfSideMatches.push_back(varListToCheckSelf[varItrSelf+counterSelf]);
+            if(CUtils::IsOverlap(pVar->m_nStartPos, pVar->m_nEndPos, varListToCheckSelf[varItrSelf+counterSelf].m_nStartPos, varListToCheckSelf[varItrSelf+counterSelf].m_nEndPos))
+                selfSideMatches.push_back(&varListToCheckSelf[varItrSelf+counterSelf]);
             counterSelf++;
         }
         
@@ -125,7 +133,7 @@ void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, SChrIdTri
         {
             if(selfSideMatches[m]->m_genotype[0] != 0 && selfSideMatches[m]->m_genotype[1] != 0)
             {
-                if(selfSideMatches[m]->m_variantStatus == eALLELE_MATCH || selfSideMatches[m]->m_variantStatus == eGENOTYPE_MATCH)
+                if(m_provider.GetVariantStatus(a_checkSide, selfSideMatches[m]) == eALLELE_MATCH || m_provider.GetVariantStatus(a_checkSide, selfSideMatches[m]) == eGENOTYPE_MATCH)
                     continue;
                 
                 selfCheck = false;
@@ -141,13 +149,13 @@ void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, SChrIdTri
                 int sideIallele = selfSideMatches[i]->m_genotype[0] == 0 ? 0 : 1;
                 
                 //Skip matching variants
-                if(selfSideMatches[i]->m_variantStatus == eALLELE_MATCH || selfSideMatches[i]->m_variantStatus == eGENOTYPE_MATCH)
+                if(m_provider.GetVariantStatus(a_checkSide, selfSideMatches[i]) == eALLELE_MATCH || m_provider.GetVariantStatus(a_checkSide, selfSideMatches[i]) == eGENOTYPE_MATCH)
                     continue;
                 
                 for(int  j= i+1; j < (int)selfSideMatches.size(); j++)
                 {
                     //Skip matching variants
-                    if(selfSideMatches[j]->m_variantStatus == eALLELE_MATCH || selfSideMatches[j]->m_variantStatus == eGENOTYPE_MATCH)
+                    if(m_provider.GetVariantStatus(a_checkSide, selfSideMatches[j]) == eALLELE_MATCH || m_provider.GetVariantStatus(a_checkSide, selfSideMatches[j]) == eGENOTYPE_MATCH)
                         continue;
 
                     int sideJallele = selfSideMatches[j]->m_genotype[0] == 0 ? 0 : 1;
@@ -169,56 +177,41 @@ void CMendelianDecider::CheckUniqueVars(EMendelianVcfName a_checkSide, SChrIdTri
         //===== STEP 2: Check child Side =========
         for(unsigned int m=0; m < childSideMatches.size(); m++)
         {
-            if(a_rChildDecisions[varListToCheckChild[varItrChild+m]->m_nId] == eViolation)
+            if(a_rChildDecisions[varListToCheckChild[varItrChild+m].m_nId] == eViolation)
             {
                 childCheck = false;
                 break;
             }
         }
         
-        a_rSideDecisions[k] = selfCheck && childCheck;
+        a_rParentSelfDecisions[pVar->m_nId] = (selfCheck && childCheck) ? eCompliant : eViolation;
         
     }
 }
 
-void CMendelianDecider::GetSyncPointList(SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild, std::vector<core::CSyncPoint>& a_rSyncPointList, bool a_bIsGT)
+void CMendelianDecider::GetSyncPointList(const SChrIdTriplet& a_rTriplet, bool a_bIsFatherChild, std::vector<core::CSyncPoint>& a_rSyncPointList, bool a_bIsGT) const
 {
-    std::vector<const core::COrientedVariant*> pBaseIncluded;
-    std::vector<const core::COrientedVariant*> pCalledIncluded;
+    //Sync points are always taken from the genotype match path. Allele match path is run on the excluded variants of it
+    const core::CPath& rPath = GetBestPath(a_rTriplet, a_bIsFatherChild, a_bIsGT);
+    const core::CPath& rPathGT = GetBestPath(a_rTriplet, a_bIsFatherChild, true);
+    const core::CPath* pPathSync = &rPathGT;
     
-    std::vector<const CVariant*> pBaseExcluded;
-    std::vector<const CVariant*> pCalledExcluded;
+    const std::vector<const core::COrientedVariant*>& pBaseIncluded = rPath.m_baseSemiPath.GetIncludedVariants();
+    const std::vector<const core::COrientedVariant*>& pCalledIncluded = rPath.m_calledSemiPath.GetIncludedVariants();
     
-    core::CPath *pPath;
-    core::CPath *pPathSync;
+    //Excluded variants are read through the excluded index lists of the paths instead of being copied into pointer lists
+    const std::vector<CVariant>& baseVariants = m_provider.GetVariants(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid);
+    const std::vector<CVariant>& calledVariants = m_provider.GetVariants(eCHILD, a_rTriplet.m_nCid);
+    const std::vector<int>& baseExcludedGT = rPathGT.m_baseSemiPath.GetExcluded();
+    const std::vector<int>& calledExcludedGT = rPathGT.m_calledSemiPath.GetExcluded();
+    const std::vector<int>* pBaseExcludedAM = a_bIsGT ? NULL : &rPath.m_baseSemiPath.GetExcluded();
+    const std::vector<int>* pCalledExcludedAM = a_bIsGT ? NULL : &rPath.m_calledSemiPath.GetExcluded();
     
-    if(a_bIsGT == false)
-    {
-        pPath = a_bIsFatherChild ? &m_aBestPathsFatherChildAM[a_rTriplet.m_nTripleIndex] : &m_aBestPathsMotherChildAM[a_rTriplet.m_nTripleIndex];
-        core::CPath *pPathGT = a_bIsFatherChild ? &m_aBestPathsFatherChildGT[a_rTriplet.m_nTripleIndex] : &m_aBestPathsMotherChildGT[a_rTriplet.m_nTripleIndex];
-        pPathSync = pPathGT;
-        
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPathGT->m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCalled = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid, pPathGT->m_calledSemiPath.GetExcluded());
-        
-        pBaseIncluded = pPath->m_baseSemiPath.GetIncludedVariants();
-        pCalledIncluded = pPath->m_calledSemiPath.GetIncludedVariants();
-        
-        pBaseExcluded = m_provider.GetVariantList(excludedVarsBase, pPath->m_baseSemiPath.GetExcluded());
-        pCalledExcluded = m_provider.GetVariantList(excludedVarsCalled, pPath->m_calledSemiPath.GetExcluded());
-    }
-    else
-    {
-        pPath = a_bIsFatherChild ? &m_aBestPathsFatherChildGT[a_rTriplet.m_nTripleIndex] : &m_aBestPathsMotherChildGT[a_rTriplet.m_nTripleIndex];
-        pPathSync = pPath;
-        
-        pBaseIncluded = pPath->m_baseSemiPath.GetIncludedVariants();
-        pCalledIncluded = pPath->m_calledSemiPath.GetIncludedVariants();
-        
-        pBaseExcluded = m_provider.GetVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPath->m_baseSemiPath.GetExcluded());
-        pCalledExcluded = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid, pPath->m_calledSemiPath.GetExcluded());
-    }
+    const unsigned int baseExcludedSize = static_cast<unsigned int>(a_bIsGT ? baseExcludedGT.size() : pBaseExcludedAM->size());
+    const unsigned int calledExcludedSize = static_cast<unsigned int>(a_bIsGT ? calledExcludedGT.size() : pCalledExcludedAM->size());
     
+    auto baseExcluded = [&](unsigned int a_nIndex) { return GetExcludedVariant(baseVariants, baseExcludedGT, pBaseExcludedAM, a_nIndex); };
+    auto calledExcluded = [&](unsigned int a_nIndex) { return GetExcludedVariant(calledVariants, calledExcludedGT, pCalledExcludedAM, a_nIndex); };
     
     unsigned int baseIncludedItr = 0;
     unsigned int baseExcludedItr = 0;
@@ -247,19 +240,19 @@ void CMendelianDecider::GetSyncPointList(SChrIdTriplet& a_rTriplet, bool a_bIsFa
             calledIncludedItr++;
         }
         
-        while(baseExcludedItr < pBaseExcluded.size() && pBaseExcluded[baseExcludedItr]->m_nStartPos < (pPathSync->m_aSyncPointList[k] + bound))
+        while(baseExcludedItr < baseExcludedSize && baseExcluded(baseExcludedItr)->m_nStartPos < (pPathSync->m_aSyncPointList[k] + bound))
         {
-            ssPoint.m_baseVariantsExcluded.push_back(pBaseExcluded[baseExcludedItr]);
+            ssPoint.m_baseVariantsExcluded.push_back(baseExcluded(baseExcludedItr));
             baseExcludedItr++;
         }
         
-        while(calledExcludedItr < pCalledExcluded.size() && pCalledExcluded[calledExcludedItr]->m_nStartPos < (pPathSync->m_aSyncPointList[k] + bound))
+        while(calledExcludedItr < calledExcludedSize && calledExcluded(calledExcludedItr)->m_nStartPos < (pPathSync->m_aSyncPointList[k] + bound))
         {
-            ssPoint.m_calledVariantsExcluded.push_back(pCalledExcluded[calledExcludedItr]);
+            ssPoint.m_calledVariantsExcluded.push_back(calledExcluded(calledExcludedItr));
             calledExcludedItr++;
         }
         
-        a_rSyncPointList.push_back(ssPoint);
+        a_rSyncPointList.push_back(std::move(ssPoint));
     }
     
     //Add Remaining variants to the last syncPoint
@@ -279,119 +272,103 @@ void CMendelianDecider::GetSyncPointList(SChrIdTriplet& a_rTriplet, bool a_bIsFa
         calledIncludedItr++;
     }
     
-    while(baseExcludedItr < pBaseExcluded.size() && pBaseExcluded[baseExcludedItr]->m_nStartPos <= sPoint.m_nEndPosition)
+    while(baseExcludedItr < baseExcludedSize && baseExcluded(baseExcludedItr)->m_nStartPos <= sPoint.m_nEndPosition)
     {
-        sPoint.m_baseVariantsExcluded.push_back(pBaseExcluded[baseExcludedItr]);
+        sPoint.m_baseVariantsExcluded.push_back(baseExcluded(baseExcludedItr));
         baseExcludedItr++;
     }
     
-    while(calledExcludedItr < pCalledExcluded.size() && pCalledExcluded[calledExcludedItr]->m_nStartPos <= sPoint.m_nEndPosition)
+    while(calledExcludedItr < calledExcludedSize && calledExcluded(calledExcludedItr)->m_nStartPos <= sPoint.m_nEndPosition)
     {
-        sPoint.m_calledVariantsExcluded.push_back(pCalledExcluded[calledExcludedItr]);
+        sPoint.m_calledVariantsExcluded.push_back(calledExcluded(calledExcludedItr));
         calledExcludedItr++;
     }
-    a_rSyncPointList.push_back(sPoint);
+    a_rSyncPointList.push_back(std::move(sPoint));
     
 }
 
-void CMendelianDecider::CheckFor0Path(SChrIdTriplet& a_rTriplet,
+void CMendelianDecider::CheckFor0Path(const SChrIdTriplet& a_rTriplet,
                                        bool a_bIsFatherChild,
-                                       std::vector<const CVariant *> &a_pVarList,
-                                       std::vector<const CVariant *> &a_pViolantList,
-                                       std::vector<const CVariant *> &a_pCompliantList,
+                                       const std::vector<bool>& a_rCheck0Variants,
+                                       std::vector<EMendelianDecision>& a_rChildDecisions,
                                        std::vector<EMendelianDecision>& a_rParentDecisions,
-                                       bool a_bIsUpdateDecisionList)
+                                       bool a_bIsUpdateDecisionList) const
 {
+    //Nothing to check at this side
+    if(std::find(a_rCheck0Variants.begin(), a_rCheck0Variants.end(), true) == a_rCheck0Variants.end())
+        return;
     
     //Get sync point list
     std::vector<core::CSyncPoint> a_rSyncPointList;
     GetSyncPointList(a_rTriplet, a_bIsFatherChild, a_rSyncPointList);
     
-    
-    int varlistItr = 0;
-    for(unsigned int k = 0; k < a_rSyncPointList.size() && varlistItr < (int)a_pVarList.size(); k++)
+    for(unsigned int k = 0; k < a_rSyncPointList.size(); k++)
     {
-        //If we check that syncpoint
-        bool bDoCheck = false;
-        std::vector<const CVariant*> tmpVarList;
-        
-        //Exclude variant if we somehow skip the syncpoint intervals
-        while(varlistItr < (int)a_pVarList.size() -1 && a_rSyncPointList[k].m_nStartPosition > a_pVarList[varlistItr]->m_nStartPos)
+        //Check if the sync interval contains 0/x child variants waiting for a decision at this side
+        const CVariant* pFirstVar = NULL;
+        for(const CVariant* pVar : a_rSyncPointList[k].m_calledVariantsExcluded)
         {
-            a_pViolantList.push_back(a_pVarList[varlistItr]);
-            varlistItr++;
-        }
-        
-        //Check if the sync interval contains 0/x child variants
-        for(unsigned int m = 0; m < a_rSyncPointList[k].m_calledVariantsExcluded.size() && varlistItr != (int)a_pVarList.size(); m++)
-        {
-            if(a_rSyncPointList[k].m_calledVariantsExcluded[m]->m_nId == a_pVarList[varlistItr]->m_nId)
+            if(a_rCheck0Variants[pVar->m_nId])
             {
-                tmpVarList.push_back(a_pVarList[varlistItr]);
-                varlistItr++;
-                bDoCheck = true;
+                pFirstVar = pVar;
+                break;
             }
         }
         
-        if(true == bDoCheck)
+        if(pFirstVar == NULL)
+            continue;
+        
+        bool bIsCompliant = true;
+        
+        for(unsigned int m = 0; m < a_rSyncPointList[k].m_baseVariantsExcluded.size(); m++)
         {
-            bool bIsCompliant = true;
+            const CVariant* pVar = a_rSyncPointList[k].m_baseVariantsExcluded[m];
             
-            for(unsigned int m = 0; m < a_rSyncPointList[k].m_baseVariantsExcluded.size(); m++)
+            if(CUtils::IsOverlap(pVar->GetStart(), pVar->GetEnd(), pFirstVar->GetStart(), pFirstVar->GetEnd()))
             {
-                const CVariant* pVar = a_rSyncPointList[k].m_baseVariantsExcluded[m];
                 
-                if(CUtils::IsOverlap(pVar->GetStart(), pVar->GetEnd(), tmpVarList[0]->GetStart(), tmpVarList[0]->GetEnd()))
+                if(pVar->m_genotype[0] != 0 && pVar->m_genotype[1] != 0)
                 {
-                    
-                    if(pVar->m_genotype[0] != 0 && pVar->m_genotype[1] != 0)
+                    if(a_bIsUpdateDecisionList)
                     {
-                        if(a_bIsUpdateDecisionList)
-                        {
-                            //We are marking decision of mother/father variant as violation
-                            a_rParentDecisions[pVar->m_nId] = eViolation;
-                        }
-                        
-                        bIsCompliant = false;
-                        break;
+                        //We are marking decision of mother/father variant as violation
+                        a_rParentDecisions[pVar->m_nId] = eViolation;
                     }
                     
-                    else
+                    bIsCompliant = false;
+                    break;
+                }
+                
+                else
+                {
+                    if(a_bIsUpdateDecisionList)
                     {
-                        if(a_bIsUpdateDecisionList)
-                        {
-                            //We are marking decision of mother/father variant as compliant
-                            a_rParentDecisions[pVar->m_nId] = eCompliant;
-                        }
+                        //We are marking decision of mother/father variant as compliant
+                        a_rParentDecisions[pVar->m_nId] = eCompliant;
                     }
                 }
             }
-            
-            if(bIsCompliant == true)
-            {
-                for(unsigned int aa = 0; aa < tmpVarList.size(); aa++)
-                    a_pCompliantList.push_back(tmpVarList[aa]);
-            }
-            
-            else
-            {
-                for(unsigned int aa = 0; aa < tmpVarList.size(); aa++)
-                    a_pViolantList.push_back(tmpVarList[aa]);
-            }
+        }
+        
+        //All 0/x child variants of the sync interval share the same decision
+        for(const CVariant* pVar : a_rSyncPointList[k].m_calledVariantsExcluded)
+        {
+            if(a_rCheck0Variants[pVar->m_nId])
+                a_rChildDecisions[pVar->m_nId] = bIsCompliant ? eCompliant : eViolation;
         }
     }
 }
 
-void CMendelianDecider::AssignDecisionToParentVars(EMendelianVcfName a_checkSide, SChrIdTriplet& a_rTriplet, std::vector<EMendelianDecision>& a_rParentDecisions)
+void CMendelianDecider::AssignDecisionToParentVars(EMendelianVcfName a_checkSide, const SChrIdTriplet& a_rTriplet, std::vector<EMendelianDecision>& a_rParentDecisions) const
 {
-    std::vector<const CVariant*> varListToCheckParent = a_checkSide == eMOTHER ? m_provider.GetVariantList(eMOTHER, a_rTriplet.m_nMid) : m_provider.GetVariantList(eFATHER, a_rTriplet.m_nFid);
-    std::vector<const CVariant*> varListToCheckChild = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid);
+    const std::vector<CVariant>& varListToCheckParent = a_checkSide == eMOTHER ? m_provider.GetVariants(eMOTHER, a_rTriplet.m_nMid) : m_provider.GetVariants(eFATHER, a_rTriplet.m_nFid);
+    const std::vector<CVariant>& varListToCheckChild = m_provider.GetVariants(eCHILD, a_rTriplet.m_nCid);
     
     assert(varListToCheckParent.size() == a_rParentDecisions.size());
     
     //Generate the sync point list
-    std::vector<int> syncPoints(a_checkSide == eFATHER ? m_aBestPathsFatherChildGT[a_rTriplet.m_nTripleIndex].m_aSyncPointList : m_aBestPathsMotherChildGT[a_rTriplet.m_nTripleIndex].m_aSyncPointList);
-    std::vector<int> syncPointsAM(a_checkSide == eFATHER ? m_aBestPathsFatherChildAM[a_rTriplet.m_nTripleIndex].m_aSyncPointList : m_aBestPathsMotherChildAM[a_rTriplet.m_nTripleIndex].m_aSyncPointList);
+    std::vector<int> syncPoints(GetBestPath(a_rTriplet, a_checkSide == eFATHER, true).m_aSyncPointList);
+    std::vector<int> syncPointsAM(GetBestPath(a_rTriplet, a_checkSide == eFATHER, false).m_aSyncPointList);
     
     //Concat AM + GT sync points
     syncPoints.insert( syncPoints.end(), syncPointsAM.begin(), syncPointsAM.end());
@@ -405,25 +382,25 @@ void CMendelianDecider::AssignDecisionToParentVars(EMendelianVcfName a_checkSide
     for(unsigned int k = 0; k < varListToCheckParent.size(); k++)
     {
         //Skipped assigned variants
-        if(a_rParentDecisions[varListToCheckParent[k]->m_nId] != eUnknown)
+        if(a_rParentDecisions[varListToCheckParent[k].m_nId] != eUnknown)
             continue;
         
         //If parent variant is genotype match, this side has no problem
-        if(varListToCheckParent[k]->m_variantStatus == eGENOTYPE_MATCH || varListToCheckParent[k]->m_variantStatus == eALLELE_MATCH)
+        if(m_provider.GetVariantStatus(a_checkSide, &varListToCheckParent[k]) == eGENOTYPE_MATCH || m_provider.GetVariantStatus(a_checkSide, &varListToCheckParent[k]) == eALLELE_MATCH)
         {
-            a_rParentDecisions[varListToCheckParent[k]->m_nId] = eCompliant;
+            a_rParentDecisions[varListToCheckParent[k].m_nId] = eCompliant;
             continue;
         }
         
         //If variant is no match and has no reference allele, mark it as violation
-        if(varListToCheckParent[k]->m_variantStatus == eNO_MATCH && varListToCheckParent[k]->m_genotype[0] != 0 && varListToCheckParent[k]->m_genotype[1] != 0)
+        if(m_provider.GetVariantStatus(a_checkSide, &varListToCheckParent[k]) == eNO_MATCH && varListToCheckParent[k].m_genotype[0] != 0 && varListToCheckParent[k].m_genotype[1] != 0)
         {
-            a_rParentDecisions[varListToCheckParent[k]->m_nId] = eViolation;
+            a_rParentDecisions[varListToCheckParent[k].m_nId] = eViolation;
             continue;
         }
         
         //Skip irrelevant sync points
-        while(itrSyncPList < syncPoints.size() && syncPoints[itrSyncPList] <= varListToCheckParent[k]->m_nStartPos)
+        while(itrSyncPList < syncPoints.size() && syncPoints[itrSyncPList] <= varListToCheckParent[k].m_nStartPos)
             itrSyncPList++;
         
         //Terminate if the sync point list is ended
@@ -431,7 +408,7 @@ void CMendelianDecider::AssignDecisionToParentVars(EMendelianVcfName a_checkSide
             break;
         
         //Skip irrelevant child variants
-        while (itrChildVars < varListToCheckChild.size() && varListToCheckChild[itrChildVars]->m_nEndPos < varListToCheckParent[k]->m_nStartPos)
+        while (itrChildVars < varListToCheckChild.size() && varListToCheckChild[itrChildVars].m_nEndPos < varListToCheckParent[k].m_nStartPos)
             itrChildVars++;
 
         //Terminate if the child variant list is ended
@@ -442,57 +419,70 @@ void CMendelianDecider::AssignDecisionToParentVars(EMendelianVcfName a_checkSide
         
         std::vector<const CVariant*> betweenSyncChildVars;
         unsigned int secondChildItr = itrChildVars;
-        while (secondChildItr < varListToCheckChild.size() && varListToCheckChild[secondChildItr]->m_nEndPos < syncPoints[itrSyncPList])
-            betweenSyncChildVars.push_back(varListToCheckChild[secondChildItr++]);
+        while (secondChildItr < varListToCheckChild.size() && varListToCheckChild[secondChildItr].m_nEndPos < syncPoints[itrSyncPList])
+            betweenSyncChildVars.push_back(&varListToCheckChild[secondChildItr++]);
         
         //Check if there is a reference path formed by child variant
         for(unsigned int m = 0; m < betweenSyncChildVars.size(); m++)
         {
             if(betweenSyncChildVars[m]->m_genotype[0] != 0 && betweenSyncChildVars[m]->m_genotype[0] != 0)
             {
-                a_rParentDecisions[varListToCheckParent[k]->m_nId] = eViolation;
+                a_rParentDecisions[varListToCheckParent[k].m_nId] = eViolation;
                 bIsViolationFound = true;
                 break;
             }
         }
         
         if(!bIsViolationFound)
-            a_rParentDecisions[varListToCheckParent[k]->m_nId] = eCompliant;
+            a_rParentDecisions[varListToCheckParent[k].m_nId] = eCompliant;
     }
 }
 
-void CMendelianDecider::ReportChildChromosomeData(SChrIdTriplet& a_rTriplet, std::vector<const CVariant*>& a_rCompliants, std::vector<const CVariant*>& a_rViolations)
+void CMendelianDecider::ReportChildChromosomeData(const SChrIdTriplet& a_rTriplet, const SVariantSpan& a_rChildVariants, const std::vector<EMendelianDecision>& a_rChildDecisions) const
 {
     int compliantSNPcount = 0;
     int compliantINDELcount = 0;
     int violationSNPcount = 0;
     int violationINDELcount = 0;
     
-    for(const CVariant* pVar : a_rCompliants)
+    for(unsigned int k = 0; k < a_rChildVariants.size(); k++)
     {
-        if(pVar->GetVariantType() == eSNP)
-            compliantSNPcount++;
-        else
-            compliantINDELcount++;
+        const CVariant* pVar = a_rChildVariants[k];
+        
+        if(a_rChildDecisions[pVar->m_nId] == eCompliant)
+        {
+            if(pVar->GetVariantType() == eSNP)
+                compliantSNPcount++;
+            else
+                compliantINDELcount++;
+        }
+        
+        else if(a_rChildDecisions[pVar->m_nId] == eViolation)
+        {
+            if(pVar->GetVariantType() == eSNP)
+                violationSNPcount++;
+            else
+                violationINDELcount++;
+        }
     }
     
-    for(const CVariant* pVar : a_rViolations)
-    {
-        if(pVar->GetVariantType() == eSNP)
-            violationSNPcount++;
-        else
-            violationINDELcount++;
-    }
+    m_resultLog.LogShortReport(a_rTriplet, compliantSNPcount, violationSNPcount, compliantINDELcount, violationINDELcount);
     
-    m_resultLog.LogShortReport(a_rTriplet.m_chrName, compliantSNPcount, violationSNPcount, compliantINDELcount, violationINDELcount);
+    //Chromosomes are decided concurrently. Statistics are printed with a single write so they do not interleave
+    std::stringstream statistics;
+    statistics << "===================== STATISTICS " << a_rTriplet.m_chrName << " ===================" << std::endl;
+    statistics << "Total Compliants:" << compliantSNPcount + compliantINDELcount << std::endl;
+    statistics << "Total Violations:" << violationSNPcount + violationINDELcount << std::endl;
+    statistics << "Child Var Size:" << a_rChildVariants.size()<< std::endl;
+    statistics << "=====================================================" << std::endl << std::endl;
+    std::cerr << statistics.str();
 }
 
 void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChildVariants,
                                                  CVariantIterator& a_rFatherChildVariants,
-                                                 std::vector<const CVariant*>& a_rViolationVars,
-                                                 std::vector<const CVariant*>& a_rMendelianCompliantVars,
-                                                 std::vector<const CVariant*>& a_rCheck0atMotherSide,
-                                                 std::vector<const CVariant*>& a_rCheck0atFatherSide)
+                                                 std::vector<EMendelianDecision>& a_rChildDecisions,
+                                                 std::vector<bool>& a_rCheck0atMotherSide,
+                                                 std::vector<bool>& a_rCheck0atFatherSide) const
 {
     const core::COrientedVariant* varMC = (a_rMotherChildVariants.hasNext() ? a_rMotherChildVariants.Next() : NULL);
     const core::COrientedVariant* varFC = (a_rFatherChildVariants.hasNext() ? a_rFatherChildVariants.Next() : NULL);
@@ -507,19 +497,18 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
                 //ELIMINATE SAME ALLELE MATCHING EXCEPTION
                 if(varMC->GetAlleleIndex() == varFC->GetAlleleIndex())
                 {
-                    if(varMC->GetVariant().m_variantStatus == eGENOTYPE_MATCH
-                       ||
-                       varFC->GetVariant().m_variantStatus == eGENOTYPE_MATCH)
-                        a_rMendelianCompliantVars.push_back(&varMC->GetVariant());
+                    //Child status combines both parent-child comparisons
+                    if(m_provider.GetVariantStatus(eCHILD, &varMC->GetVariant()) == eGENOTYPE_MATCH)
+                        a_rChildDecisions[varMC->GetVariant().m_nId] = eCompliant;
                     else
-                        a_rViolationVars.push_back(&varMC->GetVariant());
+                        a_rChildDecisions[varMC->GetVariant().m_nId] = eViolation;
                 }
                 else
-                    a_rMendelianCompliantVars.push_back(&varMC->GetVariant());
+                    a_rChildDecisions[varMC->GetVariant().m_nId] = eCompliant;
             }
             
             else
-                a_rMendelianCompliantVars.push_back(&varMC->GetVariant());
+                a_rChildDecisions[varMC->GetVariant().m_nId] = eCompliant;
             
             if(a_rMotherChildVariants.hasNext() && a_rFatherChildVariants.hasNext())
             {
@@ -539,9 +528,9 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
         else if(varMC->GetVariant().m_nId > varFC->GetVariant().m_nId)
         {
             if(varFC->GetVariant().m_genotype[0] == 0 || varFC->GetVariant().m_genotype[1] == 0)
-                a_rCheck0atMotherSide.push_back(&varFC->GetVariant());
+                a_rCheck0atMotherSide[varFC->GetVariant().m_nId] = true;
             else
-                a_rViolationVars.push_back(&varFC->GetVariant());
+                a_rChildDecisions[varFC->GetVariant().m_nId] = eViolation;
             
             if(a_rFatherChildVariants.hasNext())
                 varFC = a_rFatherChildVariants.Next();
@@ -556,9 +545,9 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
         else
         {
             if(varMC->GetVariant().m_genotype[0] == 0 || varMC->GetVariant().m_genotype[1] == 0)
-                a_rCheck0atFatherSide.push_back(&varMC->GetVariant());
+                a_rCheck0atFatherSide[varMC->GetVariant().m_nId] = true;
             else
-                a_rViolationVars.push_back(&varMC->GetVariant());
+                a_rChildDecisions[varMC->GetVariant().m_nId] = eViolation;
             
             if(a_rMotherChildVariants.hasNext())
                 varMC = a_rMotherChildVariants.Next();
@@ -583,9 +572,9 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
         }
         
         if(varFC->GetVariant().m_genotype[0] == 0 || varFC->GetVariant().m_genotype[1] == 0)
-            a_rCheck0atMotherSide.push_back(&varFC->GetVariant());
+            a_rCheck0atMotherSide[varFC->GetVariant().m_nId] = true;
         else
-            a_rViolationVars.push_back(&varFC->GetVariant());
+            a_rChildDecisions[varFC->GetVariant().m_nId] = eViolation;
         
         if(!a_rFatherChildVariants.hasNext())
             break;
@@ -605,9 +594,9 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
         }
         
         if(varMC->GetVariant().m_genotype[0] == 0 || varMC->GetVariant().m_genotype[1] == 0)
-            a_rCheck0atFatherSide.push_back(&varMC->GetVariant());
+            a_rCheck0atFatherSide[varMC->GetVariant().m_nId] = true;
         else
-            a_rViolationVars.push_back(&varMC->GetVariant());
+            a_rChildDecisions[varMC->GetVariant().m_nId] = eViolation;
         
         if(!a_rMotherChildVariants.hasNext())
             break;
@@ -616,151 +605,84 @@ void CMendelianDecider::EliminateSameAlleleMatch(CVariantIterator& a_rMotherChil
     }
 }
 
-void CMendelianDecider::FindUniqueChildVariantList(std::vector<const CVariant*> a_rChildVariants,
-                                                   const std::vector<const CVariant*>& a_rViolationVars,
-                                                   const std::vector<const CVariant*>& a_rCompliantVars,
-                                                   std::vector<const CVariant*>& a_rChildUniqueList)
+void CMendelianDecider::MarkUniqueChildVariants(std::vector<EMendelianDecision>& a_rChildDecisions) const
 {
-
-    std::vector<int>childProcessedArray(a_rChildVariants.size());
-    for(unsigned int k = 0; k < childProcessedArray.size(); k++)
-        childProcessedArray[k] = 0;
-    
-    //Mark mendelian compliant vars as processed
-    for(unsigned int k = 0; k < a_rCompliantVars.size(); k++)
-        childProcessedArray[a_rCompliantVars[k]->m_nId]++;
-    
-    //Mark mendelian violation vars as processed
-    for(unsigned int k = 0; k < a_rViolationVars.size(); k++)
-        childProcessedArray[a_rViolationVars[k]->m_nId]++;
-    
-    for(unsigned int childItr = 0; childItr < childProcessedArray.size(); childItr++)
+    //Child variants that are not decided by any of the parent-child comparisons are unique to child
+    for(unsigned int k = 0; k < a_rChildDecisions.size(); k++)
     {
-        if(childProcessedArray[childItr] == 0)
-        {
-            const CVariant* pVar = a_rChildVariants[childItr];
-            a_rChildUniqueList.push_back(pVar);
-        }
+        if(a_rChildDecisions[k] == eUnknown)
+            a_rChildDecisions[k] = eViolation;
     }
 }
 
 
-void CMendelianDecider::MergeFunc(SChrIdTriplet& a_triplet,
+void CMendelianDecider::MergeFunc(const SChrIdTriplet& a_triplet,
                                   std::vector<EMendelianDecision>& a_rMotherDecisions,
                                   std::vector<EMendelianDecision>& a_rFatherDecisions,
-                                  std::vector<EMendelianDecision>& a_rChildDecisions)
+                                  std::vector<EMendelianDecision>& a_rChildDecisions) const
 {
-    std::vector<const CVariant*> compliants;
-    std::vector<const CVariant*> violations;
-    
-    std::vector<const CVariant*> check0atMotherSide;
-    std::vector<const CVariant*> check0atFatherSide;
-    
-    std::vector<const CVariant*> childVariants = m_provider.GetSortedVariantListByID(eCHILD, a_triplet.m_nCid);
-    
-    //Sort variants according to variant ids
-    m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].SortIncludedVariants();
+    SVariantSpan childVariants = m_provider.GetSortedVariantListByID(eCHILD, a_triplet.m_nCid);
     
+    //Included variants of best paths are already sorted according to variant ids after the replay
     //Merged Genotype and Allele match Child variants with Father
-    CVariantIterator FatherChildVariants(m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants(),
-                                         m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants());
+    CVariantIterator FatherChildVariants(GetBestPath(a_triplet, true, true).m_calledSemiPath.GetIncludedVariants(),
+                                         GetBestPath(a_triplet, true, false).m_calledSemiPath.GetIncludedVariants());
     
     //Merged Genotype and Allele match Child variants with Mother
-    CVariantIterator MotherChildVariants(m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants(),
-                                         m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants());
+    CVariantIterator MotherChildVariants(GetBestPath(a_triplet, false, true).m_calledSemiPath.GetIncludedVariants(),
+                                         GetBestPath(a_triplet, false, false).m_calledSemiPath.GetIncludedVariants());
     
     //Check if the two list have common variants
     if(FatherChildVariants.hasNext() == false && MotherChildVariants.hasNext() == false)
         return;
     
+    //Child variants which will be checked for 0 path at mother and father side, indexed by variant id
+    std::vector<bool> check0atMotherSide(childVariants.size(), false);
+    std::vector<bool> check0atFatherSide(childVariants.size(), false);
+    
     //Process child variants from mother-child and father-child comparisons. Eliminate same allele matches
-    //and identifies variants requires post-processing
+    //and identifies variants requires post-processing. Decisions are written directly to the child decision array
     EliminateSameAlleleMatch(MotherChildVariants,
                              FatherChildVariants,
-                             violations,
-                             compliants,
+                             a_rChildDecisions,
                              check0atMotherSide,
                              check0atFatherSide);
     
-    //Check for 0/x child variant set at father side. Set eligible 0/x child variants to compliants list and other to the violation list
-    CheckFor0Path(a_triplet, true, check0atFatherSide, violations, compliants, a_rFatherDecisions);
-    //Check for 0/x child variant set at the mother side. Set eligible 0/x child variants to compliants list and other to the violation list
-    CheckFor0Path(a_triplet, false, check0atMotherSide, violations, compliants, a_rMotherDecisions);
+    //Check for 0/x child variant set at father side. Mark eligible 0/x child variants as compliant and others as violation
+    CheckFor0Path(a_triplet, true, check0atFatherSide, a_rChildDecisions, a_rFatherDecisions);
+    //Check for 0/x child variant set at the mother side. Mark eligible 0/x child variants as compliant and others as violation
+    CheckFor0Path(a_triplet, false, check0atMotherSide, a_rChildDecisions, a_rMotherDecisions);
     
-    //Find Child Unique variants and add them to the violation list
-    FindUniqueChildVariantList(childVariants, violations, compliants, violations);
+    //Find Child Unique variants and mark them as violation
+    MarkUniqueChildVariants(a_rChildDecisions);
     
-    //Sort compliant and violation variant list
-    std::sort(compliants.begin(), compliants.end(), CUtils::CompareVariantsById);
-    std::sort(violations.begin(), violations.end(), CUtils::CompareVariantsById);
+    ReportChildChromosomeData(a_triplet, childVariants, a_rChildDecisions);
     
     //We looked up all child variants. Now, we will look at parent variants where there is no corresponding child variant exist
     //in the child.vcf (check for hidden 0/0 child variants)
     
-    //Fill the child decision array
-    std::vector<const CVariant*>::iterator compliantsIterator = compliants.begin();
-    std::vector<const CVariant*>::iterator violationsIterator = violations.begin();
-    
-    int counterCompliant = 0;
-    int counterViolation = 0;
-    
-    for(unsigned int k = 0; k < childVariants.size(); k++)
-    {
-        if(compliantsIterator != compliants.end() && childVariants[k]->m_nId == (*compliantsIterator)->m_nId)
-        {
-            a_rChildDecisions[childVariants[k]->m_nId] = EMendelianDecision::eCompliant;
-            compliantsIterator++;
-            counterCompliant++;
-        }
-        else if(violationsIterator != violations.end() && childVariants[k]->m_nId == (*violationsIterator)->m_nId)
-        {
-            a_rChildDecisions[childVariants[k]->m_nId] = EMendelianDecision::eViolation;
-            violationsIterator++;
-            counterViolation++;
-        }
-        else
-            a_rChildDecisions[childVariants[k]->m_nId] = EMendelianDecision::eUnknown;
-    }
-    
     //Excluded Mother variant Check - If we can find 0/0 hidden child site correspond to mother variant
-    std::vector<const CVariant*> uniqueMotherVars = m_provider.GetVariantList(m_provider.GetVariantList(eMOTHER, a_triplet.m_nMid,  m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded()),
-                                                                              m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-    std::vector<bool> motherDecisions(uniqueMotherVars.size());
-    CheckUniqueVars(eMOTHER, a_triplet, uniqueMotherVars, motherDecisions, a_rMotherDecisions, a_rChildDecisions);
+    CheckUniqueVars(eMOTHER, a_triplet, a_rMotherDecisions, a_rChildDecisions);
     
     //Excluded Father variant Check - If we can find 0/0 hidden child site correspond to father variant
-    std::vector<const CVariant*> uniqueFatherVars = m_provider.GetVariantList(m_provider.GetVariantList(eFATHER, a_triplet.m_nFid,  m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded()),
-                                                                              m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-    std::vector<bool> fatherDecisions(uniqueFatherVars.size());
-    CheckUniqueVars(eFATHER, a_triplet, uniqueFatherVars, fatherDecisions, a_rFatherDecisions, a_rChildDecisions);
-    
-    //Fill the mother decision array
-    for(unsigned int k = 0; k < motherDecisions.size(); k++)
-        a_rMotherDecisions[uniqueMotherVars[k]->m_nId] = (motherDecisions[k] ? eCompliant : eViolation);
-    
-    //Fill the father decision array
-    for(unsigned int k = 0; k < fatherDecisions.size(); k++)
-        a_rFatherDecisions[uniqueFatherVars[k]->m_nId] = (fatherDecisions[k] ? eCompliant : eViolation);
+    CheckUniqueVars(eFATHER, a_triplet, a_rFatherDecisions, a_rChildDecisions);
     
     //If NoCall Mode Is not enabled, mark all decisions of nocall childs as NoCallChild and all nocall parents as NoCallParent
     if(m_nocallMode != eNone)
     {
-        std::vector<const CVariant*> motherVariants = m_provider.GetVariantList(eMOTHER, a_triplet.m_nMid);
-        std::vector<const CVariant*> fatherVariants = m_provider.GetVariantList(eFATHER, a_triplet.m_nFid);
+        const std::vector<CVariant>& motherVariants = m_provider.GetVariants(eMOTHER, a_triplet.m_nMid);
+        const std::vector<CVariant>& fatherVariants = m_provider.GetVariants(eFATHER, a_triplet.m_nFid);
         
         for(unsigned int k = 0; k < motherVariants.size(); k ++)
         {
-            if(motherVariants[k]->m_bIsNoCall)
-                a_rMotherDecisions[motherVariants[k]->m_nId] = eNoCallParent;
+            if(motherVariants[k].m_bIsNoCall)
+                a_rMotherDecisions[motherVariants[k].m_nId] = eNoCallParent;
         }
         
         for(unsigned int k = 0; k < fatherVariants.size(); k ++)
         {
-            if(fatherVariants[k]->m_bIsNoCall)
-                a_rFatherDecisions[fatherVariants[k]->m_nId] = eNoCallParent;
+            if(fatherVariants[k].m_bIsNoCall)
+                a_rFatherDecisions[fatherVariants[k].m_nId] = eNoCallParent;
         }
         
         for(unsigned int k = 0; k < childVariants.size(); k ++)
@@ -774,12 +696,4 @@ void CMendelianDecider::MergeFunc(SChrIdTriplet& a_triplet,
     AssignDecisionToParentVars(eMOTHER, a_triplet, a_rMotherDecisions);
     AssignDecisionToParentVars(eFATHER, a_triplet, a_rFatherDecisions);
     
-    ReportChildChromosomeData(a_triplet, compliants, violations);
-    
-    std::cerr << "===================== STATISTICS " << a_triplet.m_chrName << " ===================" << std::endl;
-    std::cerr << "Total Compliants:" << compliants.size() << std::endl;
-    std::cerr << "Total Violations:" << violations.size() << std::endl;
-    std::cerr << "Child Var Size:" << childVariants.size()<< std::endl;
-    std::cerr << "=====================================================" << std::endl << std::endl;
-    
 }
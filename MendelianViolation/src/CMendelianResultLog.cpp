@@ -158,9 +158,16 @@ void CMendelianResultLog::WriteGenotypeRowSum(std::ofstream* a_pOutput, const st
 
 }
 
+void CMendelianResultLog::SetChromosomeCount(int a_nChromosomeCount)
+{
+    m_aFatherChildLogEntries = std::vector<SMendelianBestPathLogEntry>(a_nChromosomeCount);
+    m_aMotherChildLogEntries = std::vector<SMendelianBestPathLogEntry>(a_nChromosomeCount);
+    m_aShortLogEntries = std::vector<SMendelianShortLogEntry>(a_nChromosomeCount);
+}
+
 void CMendelianResultLog::LogBestPathStatistic(bool a_bIsFatherChild, SChrIdTriplet a_triplet, int a_nTpCalled, int a_nTpBaseline, int a_nFalsePositive, int a_nFalseNegative)
 {
-    SMendelianBestPathLogEntry entry;
+    SMendelianBestPathLogEntry& entry = a_bIsFatherChild ? m_aFatherChildLogEntries[a_triplet.m_nTripleIndex] : m_aMotherChildLogEntries[a_triplet.m_nTripleIndex];
     
     entry.m_nTpBase = a_nTpBaseline;
     entry.m_nTpCalled = a_nTpCalled;
@@ -168,13 +175,6 @@ void CMendelianResultLog::LogBestPathStatistic(bool a_bIsFatherChild, SChrIdTrip
     entry.m_nFP = a_nFalsePositive;
     entry.m_bIsNull = false;
     entry.m_chrName = a_triplet.m_chrName;
-    
-    if(true == a_bIsFatherChild)
-        m_aFatherChildLogEntries.push_back(entry);
-
-    else
-        m_aMotherChildLogEntries.push_back(entry);
-    
 }
 
 void CMendelianResultLog::LogDetailedReport(SMendelianDetailedLogEntry& a_rLogEntry)
@@ -192,17 +192,15 @@ void CMendelianResultLog::LogGenotypeMatrix(SMendelianDetailedLogGenotypes& a_rL
         }
 }
 
-void CMendelianResultLog::LogShortReport(std::string& a_rChrName, int a_nSNPcompliant, int a_nSNPviolation, int a_nINDELcompliant, int a_nINDELviolation)
+void CMendelianResultLog::LogShortReport(const SChrIdTriplet& a_rTriplet, int a_nSNPcompliant, int a_nSNPviolation, int a_nINDELcompliant, int a_nINDELviolation)
 {
-    SMendelianShortLogEntry entry;
+    SMendelianShortLogEntry& entry = m_aShortLogEntries[a_rTriplet.m_nTripleIndex];
     
     entry.m_nSNPcompliant = a_nSNPcompliant;
     entry.m_nSNPviolation = a_nSNPviolation;
     entry.m_nINDELcompliant = a_nINDELcompliant;
     entry.m_nINDELviolation = a_nINDELviolation;
-    entry.m_chrName = a_rChrName;
-    
-    m_aShortLogEntries.push_back(entry);
+    entry.m_chrName = a_rTriplet.m_chrName;
 }
 
 void CMendelianResultLog::WriteBestPathStatistics(const std::string& a_rPrefixName)
@@ -496,6 +494,23 @@ void SMendelianDetailedLogEntry::clear()
 
 }
 
+void SMendelianDetailedLogEntry::Merge(const SMendelianDetailedLogEntry& a_rEntry)
+{
+    for(int k=0; k < 4; k++)
+    {
+        m_nSNP[k] += a_rEntry.m_nSNP[k];
+        m_nInsertSmall[k] += a_rEntry.m_nInsertSmall[k];
+        m_nInsertMedium[k] += a_rEntry.m_nInsertMedium[k];
+        m_nInsertLarge[k] += a_rEntry.m_nInsertLarge[k];
+        m_nDeleteSmall[k] += a_rEntry.m_nDeleteSmall[k];
+        m_nDeleteMedium[k] += a_rEntry.m_nDeleteMedium[k];
+        m_nDeleteLarge[k] += a_rEntry.m_nDeleteLarge[k];
+        m_nComplexSmall[k] += a_rEntry.m_nComplexSmall[k];
+        m_nComplexMedium[k] += a_rEntry.m_nComplexMedium[k];
+        m_nComplexLarge[k] += a_rEntry.m_nComplexLarge[k];
+    }
+}
+
 void SMendelianDetailedLogGenotypes::clear()
 {
     for(int var = 0; var < 10; var++)
@@ -506,6 +521,16 @@ void SMendelianDetailedLogGenotypes::clear()
         }
 }
 
+void SMendelianDetailedLogGenotypes::Merge(const SMendelianDetailedLogGenotypes& a_rGenotypes)
+{
+    for(int var = 0; var < 10; var++)
+        for(int col = 0; col < 28; col++)
+        {
+            genotypesCompliant[var][col] += a_rGenotypes.genotypesCompliant[var][col];
+            genotypesViolation[var][col] += a_rGenotypes.genotypesViolation[var][col];
+        }
+}
+
 void CMendelianResultLog::LogSkippedVariantCounts(int a_nChildSkipped, int a_nFatherSkipped, int a_nMotherSkipped)
 {
     m_nTotalSkippedCountChild = a_nChildSkipped;
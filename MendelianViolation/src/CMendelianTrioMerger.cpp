@@ -24,6 +24,7 @@
  */
 
 #include "CMendelianTrioMerger.h"
+#include "CMendelianVariantProvider.h"
 #include "CTrioVcfMerge.h"
 #include "Constants.h"
 #include "Utils/CUtils.h"
@@ -46,39 +47,9 @@ void CMendelianTrioMerger::SetTrioPath(const std::string& a_nTrioPath)
     m_trioPath = std::string(a_nTrioPath);
 }
 
-void CMendelianTrioMerger::SetDecisionsAndVariants(SChrIdTriplet& a_rTriplet, EMendelianVcfName a_vcfName, const std::vector<EMendelianDecision>& a_rDecisionList, const std::vector<const CVariant*>& a_rVarList)
+void CMendelianTrioMerger::SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount)
 {
-    std::vector<EMendelianDecision>* pDecisionList;
-    std::vector<const CVariant*>* pVarList;
-
-    assert(a_rDecisionList.size() == a_rVarList.size());
-    
-    switch (a_vcfName)
-    {
-        case eCHILD:
-            pDecisionList = &m_aChildDecisions[a_rTriplet.m_nTripleIndex];
-            pVarList = &m_aChildVariants[a_rTriplet.m_nCid];
-            break;
-            
-        case eFATHER:
-            pDecisionList = &m_aFatherDecisions[a_rTriplet.m_nTripleIndex];
-            pVarList = &m_aFatherVariants[a_rTriplet.m_nFid];
-            break;
-            
-        case eMOTHER:
-            pDecisionList = &m_aMotherDecisions[a_rTriplet.m_nTripleIndex];
-            pVarList = &m_aMotherVariants[a_rTriplet.m_nMid];
-            break;
-            
-        default:
-            break;
-    }
-
-    for(unsigned int k = 0; k < a_rVarList.size(); k++)
-    {
-        pDecisionList->push_back(a_rDecisionList[k]);
-        pVarList->push_back(a_rVarList[k]);
-    }
+    m_vcfWriter.SetOutputFormat(a_format, a_nCompressionLevel, a_nThreadCount);
 }
 
 void CMendelianTrioMerger::SetNoCallMode(ENoCallMode a_mode)
@@ -91,19 +62,14 @@ void CMendelianTrioMerger::SetResultLogPointer(CMendelianResultLog* a_pResultLog
     m_pResultLog = a_pResultLog;
 }
 
-void CMendelianTrioMerger::SetContigList(const std::vector<SVcfContig>& a_rCommonContigs, int a_nCommonContigCount, int a_nChildVarListSize, int a_nFatherVarListSize, int a_nMotherVarListSize)
+void CMendelianTrioMerger::SetVariantProviderPointer(const CMendelianVariantProvider* a_pProvider)
+{
+    m_pProvider = a_pProvider;
+}
+
+void CMendelianTrioMerger::SetContigList(const std::vector<SVcfContig>& a_rCommonContigs)
 {
     m_contigs = a_rCommonContigs;
-    
-    //Allocate decisions vectors
-    m_aChildDecisions  = std::vector<std::vector<EMendelianDecision>>(a_nCommonContigCount);
-    m_aFatherDecisions = std::vector<std::vector<EMendelianDecision>>(a_nCommonContigCount);
-    m_aMotherDecisions = std::vector<std::vector<EMendelianDecision>>(a_nCommonContigCount);
-    
-    //Allocate variant vectors
-    m_aChildVariants  = std::vector<std::vector<const CVariant*>>(a_nChildVarListSize);
-    m_aFatherVariants = std::vector<std::vector<const CVariant*>>(a_nFatherVarListSize);
-    m_aMotherVariants = std::vector<std::vector<const CVariant*>>(a_nMotherVarListSize);
 }
 
 void CMendelianTrioMerger::FillHeader()
@@ -136,7 +102,7 @@ void CMendelianTrioMerger::FillHeader()
     
 }
 
-void CMendelianTrioMerger::GenerateTrioVcf(std::vector<SChrIdTriplet>& a_rCommonChromosomes)
+void CMendelianTrioMerger::OpenTrioVcf(const std::vector<SChrIdTriplet>& a_rCommonChromosomes)
 {
     //Open Vcf file to write
     m_vcfWriter.CreateVcf(m_trioPath.c_str());
@@ -148,10 +114,74 @@ void CMendelianTrioMerger::GenerateTrioVcf(std::vector<SChrIdTriplet>& a_rCommon
     m_logEntry.clear();
     m_logGenotypes.clear();
     
-    for(unsigned int k = 0; k < a_rCommonChromosomes.size(); k++)
+    int chrCount = static_cast<int>(a_rCommonChromosomes.size());
+    
+    //Each chromosome has its own chunk and log tables until it is written
+    m_aChunks = std::vector<SVcfChunk>(chrCount);
+    m_aLogEntries = std::vector<SMendelianDetailedLogEntry>(chrCount);
+    m_aLogGenotypes = std::vector<SMendelianDetailedLogGenotypes>(chrCount);
+    m_aIsChunkReady = std::vector<bool>(chrCount, false);
+    m_nNextChunkToWrite = 0;
+    m_bIsWriting = false;
+    
+    m_aChromosomeNames.clear();
+    for(const SChrIdTriplet& triplet : a_rCommonChromosomes)
+        m_aChromosomeNames.push_back(triplet.m_chrName);
+}
+
+void CMendelianTrioMerger::AddChromosome(const SChrIdTriplet& a_rTriplet,
+                                         const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                                         const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                                         const std::vector<EMendelianDecision>& a_rChildDecisions)
+{
+    int index = a_rTriplet.m_nTripleIndex;
+    
+    //Chunk and log tables of the chromosome are only accessed by this thread until the chunk is committed
+    m_aLogEntries[index].clear();
+    m_aLogGenotypes[index].clear();
+    m_vcfWriter.InitChunk(m_aChunks[index]);
+    AddRecords(a_rTriplet, a_rMotherDecisions, a_rFatherDecisions, a_rChildDecisions, m_aChunks[index], m_aLogEntries[index], m_aLogGenotypes[index]);
+    m_vcfWriter.FinalizeChunk(m_aChunks[index]);
+    
+    CommitChunk(index);
+}
+
+void CMendelianTrioMerger::CommitChunk(int a_nChromosomeIndex)
+{
+    std::unique_lock<std::mutex> lock(m_chunkMutex);
+    m_aIsChunkReady[a_nChromosomeIndex] = true;
+    
+    //The writing thread also writes this chunk when its turn comes
+    if(true == m_bIsWriting)
+        return;
+    
+    m_bIsWriting = true;
+    
+    while(m_nNextChunkToWrite < static_cast<int>(m_aChunks.size()) && m_aIsChunkReady[m_nNextChunkToWrite])
+    {
+        int index = m_nNextChunkToWrite;
+        
+        //Other chromosomes can be committed while this chunk is written
+        lock.unlock();
+        std::cerr << "[stderr] Writing chromosome " << m_aChromosomeNames[index] << std::endl;
+        m_vcfWriter.WriteChunk(m_aChunks[index]);
+        m_logEntry.Merge(m_aLogEntries[index]);
+        m_logGenotypes.Merge(m_aLogGenotypes[index]);
+        lock.lock();
+        
+        m_nNextChunkToWrite++;
+    }
+    
+    m_bIsWriting = false;
+}
+
+void CMendelianTrioMerger::CloseTrioVcf()
+{
+    //Chromosomes that are not added (eg. a family which is not processed) are written as empty chunks
+    for(int k = 0; k < static_cast<int>(m_aChunks.size()); k++)
     {
-        std::cerr << "[stderr] Writing chromosome " << a_rCommonChromosomes[k].m_chrName << std::endl;
-        AddRecords(a_rCommonChromosomes[k]);
+        if(!m_aIsChunkReady[k])
+            CommitChunk(k);
     }
     
     //Send the logs to the log class
@@ -159,37 +189,69 @@ void CMendelianTrioMerger::GenerateTrioVcf(std::vector<SChrIdTriplet>& a_rCommon
     m_pResultLog->LogGenotypeMatrix(m_logGenotypes);
     
     m_vcfWriter.CloseVcf();
+    
+    std::vector<SVcfChunk>().swap(m_aChunks);
+    std::vector<SMendelianDetailedLogEntry>().swap(m_aLogEntries);
+    std::vector<SMendelianDetailedLogGenotypes>().swap(m_aLogGenotypes);
 }
 
 void CMendelianTrioMerger::WriteRecords(const std::vector<SVcfRecord>& recordList,
                                               const std::vector<EVariantCategory>& recordCategoryList,
-                                              const std::vector<EMendelianDecision>& recordDecisionList)
+                                              const std::vector<EMendelianDecision>& recordDecisionList,
+                                              SVcfChunk& a_rChunk,
+                                              SMendelianDetailedLogEntry& a_rLogEntry,
+                                              SMendelianDetailedLogGenotypes& a_rLogGenotypes)
 {
-    //Write the final updated variants to output vcf and logs to the report table
+    //Write the final updated variants to output chunk and logs to the report table
     for(int k = 0; k < static_cast<int>(recordList.size()); k++)
     {
-        m_vcfWriter.AddMendelianRecord(recordList[k]);
-        RegisterMergedLine(recordDecisionList[k], recordCategoryList[k]);
-        RegisterGenotype(recordList[k], recordCategoryList[k], recordDecisionList[k]);
+        m_vcfWriter.AddMendelianRecord(recordList[k], a_rChunk);
+        RegisterMergedLine(recordDecisionList[k], recordCategoryList[k], a_rLogEntry);
+        RegisterGenotype(recordList[k], recordCategoryList[k], recordDecisionList[k], a_rLogGenotypes);
     }
 }
 
-void CMendelianTrioMerger::AddRecords(SChrIdTriplet &a_rTriplet)
+void CMendelianTrioMerger::AddRecords(const SChrIdTriplet& a_rTriplet,
+                                      const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                                      const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                                      const std::vector<EMendelianDecision>& a_rChildDecisions,
+                                      SVcfChunk& a_rChunk,
+                                      SMendelianDetailedLogEntry& a_rLogEntry,
+                                      SMendelianDetailedLogGenotypes& a_rLogGenotypes)
 {
+    //Records of the current overlap group. Buffers are reused for all groups of the chromosome
     std::vector<SVcfRecord> recordList;
     std::vector<EVariantCategory> recordCategoryList;
     std::vector<EMendelianDecision> recordDecisionList;
     
-    CTrioVcfMerge trioMerger(m_aMotherVariants[a_rTriplet.m_nMid], m_aFatherVariants[a_rTriplet.m_nFid], m_aChildVariants[a_rTriplet.m_nCid]);
+    //Variants of each sample in the order of their original positions. Sample order of the merger is the sample order of trio vcf (Mother, Father, Child)
+    std::vector<SVariantSpan> sampleVariants = {m_pProvider->GetSortedVariantListByIDandStartPos(eMOTHER, a_rTriplet.m_nMid),
+                                                m_pProvider->GetSortedVariantListByIDandStartPos(eFATHER, a_rTriplet.m_nFid),
+                                                m_pProvider->GetSortedVariantListByIDandStartPos(eCHILD, a_rTriplet.m_nCid)};
+    
+    CTrioVcfMerge trioMerger(sampleVariants);
     
-    const CVariant* motherVariant;
-    const CVariant* fatherVariant;
-    const CVariant* childVariant;
+    std::vector<const CVariant*> recordVariants;
+    bool bIsNewGroup;
     
-    while(true == trioMerger.GetNext(&motherVariant, &fatherVariant, &childVariant))
+    while(true == trioMerger.GetNext(recordVariants, bIsNewGroup))
     {
+        //Previous overlap group is completed. Update records for overlapping regions and write them to the chunk
+        if(true == bIsNewGroup && false == recordList.empty())
+        {
+            ProcessRefOverlappedRegions(recordList, recordDecisionList);
+            WriteRecords(recordList, recordCategoryList, recordDecisionList, a_rChunk, a_rLogEntry, a_rLogGenotypes);
+            recordList.clear();
+            recordCategoryList.clear();
+            recordDecisionList.clear();
+        }
+        
+        const CVariant* motherVariant = recordVariants[0];
+        const CVariant* fatherVariant = recordVariants[1];
+        const CVariant* childVariant = recordVariants[2];
+        
         //Determine the decision of the record
-        EMendelianDecision decision = GetMendelianDecision(motherVariant, fatherVariant, childVariant, a_rTriplet);
+        EMendelianDecision decision = GetMendelianDecision(motherVariant, fatherVariant, childVariant, a_rMotherDecisions, a_rFatherDecisions, a_rChildDecisions);
         
         //Ignore complex-skipped variants
         if(decision == eSkipped)
@@ -206,15 +268,9 @@ void CMendelianTrioMerger::AddRecords(SChrIdTriplet &a_rTriplet)
         DoMerge(motherVariant, fatherVariant, childVariant, decision, recordList);
     }
     
-    std::cerr << "Processing Overlapping Regions..." << std::endl;
-    
-    //Update records for overlapping regions
+    //Update records for the last overlap group and write them to the chunk
     ProcessRefOverlappedRegions(recordList, recordDecisionList);
-    
-    std::cerr << "Writing variants to output vcf..." << std::endl;
-    
-    //Write records to the VCF file and fill logs
-    WriteRecords(recordList, recordCategoryList, recordDecisionList);
+    WriteRecords(recordList, recordCategoryList, recordDecisionList, a_rChunk, a_rLogEntry, a_rLogGenotypes);
     
 }
 
@@ -335,18 +391,15 @@ void CMendelianTrioMerger::DoMerge(const CVariant* a_pVarMother,
     vcfrecord.m_aSampleData.push_back(dataFather);
     vcfrecord.m_aSampleData.push_back(dataChild);
     
-    //Push SInfo columns to the vcfrecord
+    //Point to SInfo columns of the variant (Variants outlive the record so no copy is needed)
     if(true == m_bIsAnnotationsON)
-    {
-        const SInfo& pInfoToCopy = (a_pVarChild == 0 ? (a_pVarFather == 0 ? a_pVarMother->m_info : a_pVarFather->m_info) : a_pVarChild->m_info);
-        vcfrecord.m_pInfo = new SInfo(pInfoToCopy);
-    }
+        vcfrecord.m_pInfo = (a_pVarChild == 0 ? (a_pVarFather == 0 ? &a_pVarMother->m_info : &a_pVarFather->m_info) : &a_pVarChild->m_info);
     
     //Add record to the trio
     a_rRecordList.push_back(vcfrecord);
 }
 
-void CMendelianTrioMerger::RegisterMergedLine(EMendelianDecision a_decision, EVariantCategory a_category)
+void CMendelianTrioMerger::RegisterMergedLine(EMendelianDecision a_decision, EVariantCategory a_category, SMendelianDetailedLogEntry& a_rLogEntry)
 {
     //Ignore the complex types
     if(a_decision == EMendelianDecision::eUnknown)
@@ -355,34 +408,34 @@ void CMendelianTrioMerger::RegisterMergedLine(EMendelianDecision a_decision, EVa
     switch (a_category)
     {
         case EVariantCategory::eSNP:
-            m_logEntry.m_nSNP[a_decision-1]++;
+            a_rLogEntry.m_nSNP[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_INSERT_SMALL:
-            m_logEntry.m_nInsertSmall[a_decision-1]++;
+            a_rLogEntry.m_nInsertSmall[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_INSERT_MEDIUM:
-            m_logEntry.m_nInsertMedium[a_decision-1]++;
+            a_rLogEntry.m_nInsertMedium[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_INSERT_LARGE:
-            m_logEntry.m_nInsertLarge[a_decision-1]++;
+            a_rLogEntry.m_nInsertLarge[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_DELETE_SMALL:
-            m_logEntry.m_nDeleteSmall[a_decision-1]++;
+            a_rLogEntry.m_nDeleteSmall[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_DELETE_MEDIUM:
-            m_logEntry.m_nDeleteMedium[a_decision-1]++;
+            a_rLogEntry.m_nDeleteMedium[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_DELETE_LARGE:
-            m_logEntry.m_nDeleteLarge[a_decision-1]++;
+            a_rLogEntry.m_nDeleteLarge[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_COMPLEX_SMALL:
-            m_logEntry.m_nComplexSmall[a_decision-1]++;
+            a_rLogEntry.m_nComplexSmall[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_COMPLEX_MEDIUM:
-            m_logEntry.m_nComplexMedium[a_decision-1]++;
+            a_rLogEntry.m_nComplexMedium[a_decision-1]++;
             break;
         case EVariantCategory::eINDEL_COMPLEX_LARGE:
-            m_logEntry.m_nComplexLarge[a_decision-1]++;
+            a_rLogEntry.m_nComplexLarge[a_decision-1]++;
             break;
             
         default:
@@ -391,15 +444,20 @@ void CMendelianTrioMerger::RegisterMergedLine(EMendelianDecision a_decision, EVa
     
 }
 
-EMendelianDecision CMendelianTrioMerger::GetMendelianDecision(const CVariant* a_pVarMother, const CVariant* a_pVarFather, const CVariant* a_pVarChild, SChrIdTriplet& a_rTriplet)
+EMendelianDecision CMendelianTrioMerger::GetMendelianDecision(const CVariant* a_pVarMother,
+                                                              const CVariant* a_pVarFather,
+                                                              const CVariant* a_pVarChild,
+                                                              const std::vector<EMendelianDecision>& a_rMotherDecisions,
+                                                              const std::vector<EMendelianDecision>& a_rFatherDecisions,
+                                                              const std::vector<EMendelianDecision>& a_rChildDecisions)
 {
     EMendelianDecision decision = eUnknown;
     
-    if(a_pVarMother != 0 && a_pVarMother->m_variantStatus == eCOMPLEX_SKIPPED)
+    if(a_pVarMother != 0 && m_pProvider->GetVariantStatus(eMOTHER, a_pVarMother) == eCOMPLEX_SKIPPED)
         decision = eSkipped;
-    else if(a_pVarFather != 0 && a_pVarFather->m_variantStatus == eCOMPLEX_SKIPPED)
+    else if(a_pVarFather != 0 && m_pProvider->GetVariantStatus(eFATHER, a_pVarFather) == eCOMPLEX_SKIPPED)
         decision = eSkipped;
-    else if(a_pVarChild != 0 && a_pVarChild->m_variantStatus == eCOMPLEX_SKIPPED)
+    else if(a_pVarChild != 0 && m_pProvider->GetVariantStatus(eCHILD, a_pVarChild) == eCOMPLEX_SKIPPED)
         decision = eSkipped;
     
     //Check for nocall - Implicit Mode
@@ -427,9 +485,9 @@ EMendelianDecision CMendelianTrioMerger::GetMendelianDecision(const CVariant* a_
     //If variant is not no-call
     if(decision == eUnknown)
     {
-        EMendelianDecision childDecision = a_pVarChild   != 0 ? m_aChildDecisions[a_rTriplet.m_nTripleIndex][a_pVarChild->m_nId]   : EMendelianDecision::eUnknown;
-        EMendelianDecision fatherDecision = a_pVarFather != 0 ? m_aFatherDecisions[a_rTriplet.m_nTripleIndex][a_pVarFather->m_nId] : EMendelianDecision::eUnknown;
-        EMendelianDecision motherDecision = a_pVarMother != 0 ? m_aMotherDecisions[a_rTriplet.m_nTripleIndex][a_pVarMother->m_nId] : EMendelianDecision::eUnknown;
+        EMendelianDecision childDecision = a_pVarChild   != 0 ? a_rChildDecisions[a_pVarChild->m_nId]   : EMendelianDecision::eUnknown;
+        EMendelianDecision fatherDecision = a_pVarFather != 0 ? a_rFatherDecisions[a_pVarFather->m_nId] : EMendelianDecision::eUnknown;
+        EMendelianDecision motherDecision = a_pVarMother != 0 ? a_rMotherDecisions[a_pVarMother->m_nId] : EMendelianDecision::eUnknown;
         
         if(childDecision == eViolation || motherDecision == eViolation || fatherDecision == eViolation)
             decision = eViolation;
@@ -440,7 +498,7 @@ EMendelianDecision CMendelianTrioMerger::GetMendelianDecision(const CVariant* a_
     return decision;
 }
 
-void CMendelianTrioMerger::RegisterGenotype(const SVcfRecord& a_rRecord, EVariantCategory a_uCategory, EMendelianDecision a_uDecision)
+void CMendelianTrioMerger::RegisterGenotype(const SVcfRecord& a_rRecord, EVariantCategory a_uCategory, EMendelianDecision a_uDecision, SMendelianDetailedLogGenotypes& a_rLogGenotypes)
 {
  
     if(a_uCategory == EVariantCategory::eNONE)
@@ -459,18 +517,18 @@ void CMendelianTrioMerger::RegisterGenotype(const SVcfRecord& a_rRecord, EVarian
     if(a_uDecision == EMendelianDecision::eCompliant)
     {
         if(bIsMotherMultiAllelic || bIsFatherMultiAllelic || bIsChildMultiAllelic)
-            m_logGenotypes.genotypesCompliant[static_cast<int>(a_uCategory)][27]++;
+            a_rLogGenotypes.genotypesCompliant[static_cast<int>(a_uCategory)][27]++;
         else
-            m_logGenotypes.genotypesCompliant[static_cast<int>(a_uCategory)][columnNo]++;
+            a_rLogGenotypes.genotypesCompliant[static_cast<int>(a_uCategory)][columnNo]++;
         
     }
     
     if(a_uDecision == EMendelianDecision::eViolation)
     {
         if(bIsMotherMultiAllelic || bIsFatherMultiAllelic || bIsChildMultiAllelic)
-            m_logGenotypes.genotypesViolation[static_cast<int>(a_uCategory)][27]++;
+            a_rLogGenotypes.genotypesViolation[static_cast<int>(a_uCategory)][27]++;
         else
-            m_logGenotypes.genotypesViolation[static_cast<int>(a_uCategory)][columnNo]++;
+            a_rLogGenotypes.genotypesViolation[static_cast<int>(a_uCategory)][columnNo]++;
     }
     
 }
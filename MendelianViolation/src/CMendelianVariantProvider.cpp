@@ -27,9 +27,12 @@
 #include "CMendelianVariantProvider.h"
 #include "CSimplePEDParser.h"
 #include "CSimpleBEDParser.h"
+#include "CJointVcfStore.h"
 #include "Utils/CUtils.h"
 #include <iostream>
 #include <sstream>
+#include <chrono>
+#include <cstring>
 
 using namespace mendelian;
 
@@ -153,101 +156,206 @@ bool CMendelianVariantProvider::InitializeReaders(const SConfig &a_rFatherChildC
     m_fatherChildConfig = a_rFatherChildConfig;
     
     // OPEN VCF FILES
-    bIsSuccessVCFs = OpenVcfFiles();
+    bIsSuccessVCFs = OpenVcfFiles() && OpenTrioVcf();
 
     if(!bIsSuccessVCFs)
         std::cerr << "VCF file(s) has error!" << std::endl;
 
     // OPEN FASTA FILE
-    bIsSuccessFasta = m_referenceFasta.OpenFastaFile(a_rFatherChildConfig.m_pFastaFileName);
+    bIsSuccessFasta = m_referenceFasta.OpenFastaFile(a_rFatherChildConfig.m_pFastaFileName, a_rFatherChildConfig.m_bUseReferenceCache ? a_rFatherChildConfig.m_pReferenceCacheDirectory : NULL);
 
     if(!bIsSuccessFasta)
         std::cerr << "FASTA file is unable to open!: " << a_rFatherChildConfig.m_pFastaFileName << std::endl;
     
     if(bIsSuccessVCFs && bIsSuccessFasta)
+        LoadVariants();
+
+    return bIsSuccessVCFs && bIsSuccessFasta;
+}
+
+bool CMendelianVariantProvider::OpenTrioVcf()
+{
+    if(0 != strcmp(m_fatherChildConfig.m_pBaseVcfFileName, m_motherChildConfig.m_pBaseVcfFileName)
+       ||
+       0 != strcmp(m_fatherChildConfig.m_pBaseVcfFileName, m_fatherChildConfig.m_pCalledVcfFileName))
+        return true;
+    
+    //Samples selected by OpenVcfFiles. The same sample can be selected more than once
+    std::vector<std::string> sampleNames;
+    for(const CVcfReader* pReader : {&m_MotherVcf, &m_FatherVcf, &m_ChildVcf})
     {
-        //Fill the variants of 3 vcf file
-        FillVariants();
-        
-        //Get the common chromosome ids and clear the uncommon variants from provider
-        SetCommonChromosomes();
-        
-        //Fill the oriented variants of 3 vcf for genotype matching
-        FillGenotypeMatchOrientedVariants(m_aCommonChromosomes);
-        
-        //Fill the oriented variants of 3 vcf for allele matching
-        FillAlleleMatchOrientedVariants(m_aCommonChromosomes);
+        std::string sampleName = pReader->GetSelectedSample();
+        if(std::find(sampleNames.begin(), sampleNames.end(), sampleName) == sampleNames.end())
+            sampleNames.push_back(sampleName);
+    }
+    
+    //Each record is decoded once for the 3 samples instead of reading the file 3 times. Ploidy is decoded per sample so mixed ploidy
+    //records (eg. haploid chrX of a male child) produce the same variants as the separate readers
+    if(!m_trioVcf.Open(m_fatherChildConfig.m_pBaseVcfFileName, sampleNames))
+        return false;
+    
+    std::cerr << "[stderr] Mother, father and child are read from the same vcf in a single pass" << std::endl;
+    
+    //Seek directly to BED regions if the input is indexed. Otherwise whole file is scanned and filtered by each sample
+    if(true == m_motherChildConfig.m_bInitializeFromBed)
+    {
+        CSimpleBEDParser bedParser;
+        bedParser.InitBEDFile(m_motherChildConfig.m_pBedFileName);
+        if(m_trioVcf.SetRegions(bedParser))
+            std::cerr << "Reading only BED regions of trio vcf using its index" << std::endl;
     }
+    
+    m_trioVcf.Load(m_motherChildConfig);
+    m_pJointVcf = &m_trioVcf;
+    
+    //Variants are generated from the decoded records, separate readers are not needed anymore
+    m_MotherVcf.Close();
+    m_FatherVcf.Close();
+    m_ChildVcf.Close();
+    
+    return true;
+}
 
-    return bIsSuccessVCFs && bIsSuccessFasta;
+bool CMendelianVariantProvider::InitializeFromJointVcf(const SConfig& a_rFatherChildConfig, const SConfig& a_rMotherChildConfig, const CJointVcfStore& a_rJointVcf)
+{
+    m_motherChildConfig = a_rMotherChildConfig;
+    m_fatherChildConfig = a_rFatherChildConfig;
+    
+    //Samples are read from the decoded joint vcf, no vcf file is opened
+    m_pJointVcf = &a_rJointVcf;
+    
+    // OPEN FASTA FILE
+    bool bIsSuccessFasta = m_referenceFasta.OpenFastaFile(a_rFatherChildConfig.m_pFastaFileName, a_rFatherChildConfig.m_bUseReferenceCache ? a_rFatherChildConfig.m_pReferenceCacheDirectory : NULL);
+    
+    if(!bIsSuccessFasta)
+        std::cerr << "FASTA file is unable to open!: " << a_rFatherChildConfig.m_pFastaFileName << std::endl;
+    
+    return bIsSuccessFasta;
 }
 
-void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
+void CMendelianVariantProvider::LoadJointVcfSample(int a_nSampleIndex, const std::string& a_rSampleName, SMendelianSampleVariants& a_rSample)
 {
-    EMendelianVcfName sampleName = static_cast<EMendelianVcfName>(a_nSampleId);
+    FillVariantForSample(a_rSample, NULL, a_nSampleIndex, a_rSampleName, m_motherChildConfig);
+    
+    FillVariantOrders(a_rSample);
+    
+    //The sample can be compared with several family members, so oriented variants of all chromosomes are generated
+    InitializeOrientedVariants(a_rSample);
+    for(unsigned int k = 0; k < a_rSample.m_aVariantList.size(); k++)
+        FillOrientedVariants(a_rSample, k);
+}
 
-    CSimpleBEDParser bedParser;
-    unsigned int remainingBedContigCount = 0;
+void CMendelianVariantProvider::SetFamily(const SMendelianSampleVariants* a_pMother,
+                                          const SMendelianSampleVariants* a_pFather,
+                                          const SMendelianSampleVariants* a_pChild,
+                                          SParentChildComparison* a_pFatherChild,
+                                          SParentChildComparison* a_pMotherChild)
+{
+    m_pSamples[eMOTHER] = a_pMother;
+    m_pSamples[eFATHER] = a_pFather;
+    m_pSamples[eCHILD] = a_pChild;
+    m_pFatherChildComparison = a_pFatherChild;
+    m_pMotherChildComparison = a_pMotherChild;
+    
+    //Get the common chromosome ids of the family
+    SetCommonChromosomes();
+}
+
+void CMendelianVariantProvider::LoadVariants()
+{
+    //Fill the variants of 3 vcf file
+    FillVariants();
     
-    if(true == a_rConfig.m_bInitializeFromBed)
+    //Family members and comparisons are owned by this provider
+    for(EMendelianVcfName sample : {eFATHER, eMOTHER, eCHILD})
+        m_pSamples[sample] = &m_aSamples[sample];
+    m_pFatherChildComparison = &m_fatherChildComparison;
+    m_pMotherChildComparison = &m_motherChildComparison;
+    
+    //Get the common chromosome ids
+    SetCommonChromosomes();
+    
+    //Allocate the per comparison best paths and variant status lists
+    InitializeComparison(m_fatherChildComparison, m_aSamples[eFATHER], m_aSamples[eCHILD]);
+    InitializeComparison(m_motherChildComparison, m_aSamples[eMOTHER], m_aSamples[eCHILD]);
+    
+    //Compute the sort orders which are used by the decision phase and output
+    for(SMendelianSampleVariants& sample : m_aSamples)
     {
-        bedParser.InitBEDFile(a_rConfig.m_pBedFileName);
-        remainingBedContigCount = bedParser.m_nTotalContigCount;
+        FillVariantOrders(sample);
+        InitializeOrientedVariants(sample);
     }
     
-    int* pNonAssessedVariantCount;
-    int* pAsteriskVariantCount;
-    std::vector<std::vector<CVariant>>* pVariants;
-    CVcfReader* pReader;
-    std::string sampleNameStr;
+    //Fill the oriented variants of 3 vcf for genotype and allele matching. Only common chromosomes are compared
+    for(const SChrIdTriplet& triplet : m_aCommonChromosomes)
+    {
+        FillOrientedVariants(m_aSamples[eFATHER], triplet.m_nFid);
+        FillOrientedVariants(m_aSamples[eMOTHER], triplet.m_nMid);
+        FillOrientedVariants(m_aSamples[eCHILD], triplet.m_nCid);
+    }
+}
+
+const CVcfReader& CMendelianVariantProvider::GetVcfReader(EMendelianVcfName a_uFrom) const
+{
+    if(m_pJointVcf != NULL)
+        return m_pJointVcf->GetReader();
     
-    switch (sampleName)
+    switch (a_uFrom)
     {
         case eFATHER:
-            pNonAssessedVariantCount = &m_nFatherNotAssessedVariantCount;
-            pVariants = &m_aFatherVariantList;
-            pReader = &m_FatherVcf;
-            pAsteriskVariantCount = &m_nFatherAsteriskCount;
-            sampleNameStr = "father";
-            break;
+            return m_FatherVcf;
         case eMOTHER:
-            pNonAssessedVariantCount = &m_nMotherNotAssessedVariantCount;
-            pVariants = &m_aMotherVariantList;
-            pReader = &m_MotherVcf;
-            pAsteriskVariantCount = &m_nMotherAsteriskCount;
-            sampleNameStr = "mother";
-            break;
-        case eCHILD:
-            pNonAssessedVariantCount = &m_nChildNotAssessedVariantCount;
-            pVariants = &m_aChildVariantList;
-            pReader = &m_ChildVcf;
-            pAsteriskVariantCount = &m_nChildAsteriskCount;
-            sampleNameStr = "child";
-            break;
-            
+            return m_MotherVcf;
         default:
-            std::cerr << "Wrong Sample Enumeration in Mendelian Variant Provider!" << std::endl;
-            break;
+            return m_ChildVcf;
     }
+}
+
+void CMendelianVariantProvider::FillVariantForSample(SMendelianSampleVariants& a_rSample, CVcfReader* a_pReader, int a_nJointSampleIndex, const std::string& a_rSampleName, SConfig& a_rConfig)
+{
+    CSimpleBEDParser bedParser;
+    unsigned int remainingBedContigCount = 0;
+    
+    if(true == a_rConfig.m_bInitializeFromBed)
+    {
+        bedParser.InitBEDFile(a_rConfig.m_pBedFileName);
+        remainingBedContigCount = bedParser.m_nTotalContigCount;
+    }
+    
+    //Initialize variant lists
+    a_rSample.m_aVariantList = std::vector<std::vector<CVariant>>(a_pReader != NULL ? a_pReader->GetContigs().size() : m_pJointVcf->GetReader().GetContigs().size());
+    a_rSample.m_nNotAssessedVariantCount = 0;
+    a_rSample.m_nAsteriskCount = 0;
+    
+    std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+    
+    //Seek directly to BED regions if the input is indexed. Otherwise whole file is scanned and filtered below (Joint vcf is already decoded)
+    if(a_pReader != NULL && true == a_rConfig.m_bInitializeFromBed && a_pReader->SetRegions(bedParser))
+        std::cerr << "Reading only BED regions of " << a_rSampleName << " vcf using its index" << std::endl;
     
     CVariant variant;
     int id = 0;
     std::string preChrId = "";
     unsigned int regionIterator = 0;
+    const std::vector<SBedRegion>* pRegions = &bedParser.GetRegions(preChrId);
     
     std::vector<CVariant> multiTrimmableVarList;
     
+    //Position at the stored genotypes of the sample if variants are generated from the joint vcf
+    int jointItr = 0;
     
-    while(pReader->GetNextRecord(&variant, id, a_rConfig))
+    while(a_pReader == NULL ? m_pJointVcf->GetSampleVariant(a_nJointSampleIndex, jointItr++, id, a_rConfig, &variant)
+                            : a_pReader->GetNextRecord(&variant, id, a_rConfig))
     {
         if(preChrId != variant.m_chrName)
         {
             //We update the remaining contig count in BED file
-            if(bedParser.m_regionMap[preChrId].size() > 0)
+            if(pRegions->size() > 0)
                 remainingBedContigCount--;
             
             preChrId = variant.m_chrName;
-            std::cerr << "Reading chromosome " << preChrId << " of Parent[" << sampleNameStr <<"] vcf" << std::endl;
+            pRegions = &bedParser.GetRegions(preChrId);
+            std::cerr << "Reading chromosome " << preChrId << " of Parent[" << a_rSampleName <<"] vcf" << std::endl;
             id = 0;
             variant.m_nId = id;
             
@@ -260,24 +368,16 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
             if(remainingBedContigCount == 0)
                 break;
             
-            //No Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
-                continue;
-            
             //Skip to next region
-            while(regionIterator < bedParser.m_regionMap[variant.m_chrName].size()
-                  &&
-                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nEndPos)
-            {
+            while(regionIterator < pRegions->size() && variant.m_nOriginalPos >= (*pRegions)[regionIterator].m_nEndPos)
                 regionIterator++;
-            }
             
             //Skip if regions are finished for given chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == pRegions->size())
                 continue;
             
             //Variant Could not pass from BED region
-            if(bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
+            if((*pRegions)[regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
                 continue;
         }
             
@@ -291,15 +391,15 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
         std::size_t found = variant.m_allelesStr.find('*');
         if (found!=std::string::npos)
         {
-            pAsteriskVariantCount++;
+            a_rSample.m_nAsteriskCount++;
             continue;
         }
         
         else if(a_rConfig.m_bIsFilterEnabled && variant.m_bIsFilterPASS == false)
-            pNonAssessedVariantCount++;
+            a_rSample.m_nNotAssessedVariantCount++;
         
         else if(CUtils::IsStructuralVariant(variant, a_rConfig.m_nMaxVariantSize))
-            pNonAssessedVariantCount++;
+            a_rSample.m_nNotAssessedVariantCount++;
         
         else if(true == variant.m_bHaveMultipleTrimOption)
         {
@@ -309,111 +409,147 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
         
         else
         {
-            (*pVariants)[variant.m_nChrId].push_back(variant);
+            a_rSample.m_aVariantList[variant.m_nChrId].push_back(variant);
             id++;
         }
     }
     
-    FindOptimalTrimmings(multiTrimmableVarList, sampleName);
-    AppendTrimmedVariants(multiTrimmableVarList, sampleName);
+    //Find the optimal trimmings and merge trimmed variants with the original variant list
+    if(multiTrimmableVarList.size() > 0)
+        CBaseVariantProvider::FindOptimalTrimmings(multiTrimmableVarList, &a_rSample.m_aVariantList, a_rConfig);
     
-    for(unsigned int k = 0; k < pReader->GetContigs().size(); k++)
+    for(unsigned int k = 0; k < multiTrimmableVarList.size(); k++)
+        a_rSample.m_aVariantList[multiTrimmableVarList[k].m_nChrId].push_back(multiTrimmableVarList[k]);
+    
+    for(unsigned int k = 0; k < a_rSample.m_aVariantList.size(); k++)
     {
-        std::sort((*pVariants)[k].begin(), (*pVariants)[k].end(), CUtils::CompareVariants);
-        (*pVariants)[k].shrink_to_fit();
+        std::sort(a_rSample.m_aVariantList[k].begin(), a_rSample.m_aVariantList[k].end(), CUtils::CompareVariants);
+        a_rSample.m_aVariantList[k].shrink_to_fit();
     }
     
-    (*pVariants).shrink_to_fit();
+    a_rSample.m_aVariantList.shrink_to_fit();
+    
+    std::chrono::steady_clock::time_point loadEnd = std::chrono::steady_clock::now();
+    std::cerr << "Loaded " << a_rSampleName << " " << (a_pReader == NULL ? "from joint VCF" : (a_pReader->IsBcf() ? "BCF" : "VCF")) << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count() << " ms" << std::endl;
 }
 
 void CMendelianVariantProvider::FillVariants()
 {
-    //initialize variant lists
-    m_aFatherVariantList = std::vector<std::vector<CVariant>>(m_FatherVcf.GetContigs().size());
-    m_aMotherVariantList = std::vector<std::vector<CVariant>>(m_MotherVcf.GetContigs().size());
-    m_aChildVariantList = std::vector<std::vector<CVariant>>(m_ChildVcf.GetContigs().size());
-    m_nFatherNotAssessedVariantCount = 0;
-    m_nMotherNotAssessedVariantCount = 0;
-    m_nChildNotAssessedVariantCount = 0;
+    //Samples of a multi-sample trio vcf are generated from the records decoded by OpenTrioVcf
+    if(m_pJointVcf != NULL)
+    {
+        FillVariantForSample(m_aSamples[eMOTHER], NULL, m_pJointVcf->GetSampleIndex(m_MotherVcf.GetSelectedSample()), "mother", m_motherChildConfig);
+        FillVariantForSample(m_aSamples[eFATHER], NULL, m_pJointVcf->GetSampleIndex(m_FatherVcf.GetSelectedSample()), "father", m_fatherChildConfig);
+        FillVariantForSample(m_aSamples[eCHILD], NULL, m_pJointVcf->GetSampleIndex(m_ChildVcf.GetSelectedSample()), "child", m_motherChildConfig);
+        
+        //Decoded genotypes are not needed once the variants are generated
+        if(m_pJointVcf == &m_trioVcf)
+        {
+            for(const CVcfReader* pReader : {&m_MotherVcf, &m_FatherVcf, &m_ChildVcf})
+                m_trioVcf.ReleaseSample(m_trioVcf.GetSampleIndex(pReader->GetSelectedSample()));
+        }
+        return;
+    }
     
-    //TODO : this will be replaced ??
-    m_nMotherAsteriskCount = 0;
-    m_nFatherAsteriskCount = 0;
-    m_nChildAsteriskCount  = 0;
+    FillVariantForSample(m_aSamples[eMOTHER], &m_MotherVcf, -1, "mother", m_motherChildConfig);
+    FillVariantForSample(m_aSamples[eFATHER], &m_FatherVcf, -1, "father", m_fatherChildConfig);
+    FillVariantForSample(m_aSamples[eCHILD], &m_ChildVcf, -1, "child", m_motherChildConfig);
+}
+
+void CMendelianVariantProvider::InitializeComparison(SParentChildComparison& a_rComparison, const SMendelianSampleVariants& a_rParent, const SMendelianSampleVariants& a_rChild)
+{
+    a_rComparison.m_aBestPathsGT = std::vector<core::CPath>(a_rChild.m_aVariantList.size());
+    a_rComparison.m_aBestPathsAM = std::vector<core::CPath>(a_rChild.m_aVariantList.size());
+    
+    a_rComparison.m_aParentVariantStatus = std::vector<std::vector<EVariantMatch>>(a_rParent.m_aVariantList.size());
+    a_rComparison.m_aChildVariantStatus = std::vector<std::vector<EVariantMatch>>(a_rChild.m_aVariantList.size());
+    
+    for(unsigned int k = 0; k < a_rParent.m_aVariantList.size(); k++)
+        a_rComparison.m_aParentVariantStatus[k] = std::vector<EVariantMatch>(a_rParent.m_aVariantList[k].size(), eNOT_ASSESSED);
     
-    FillVariantForSample(eMOTHER, m_motherChildConfig);
-    FillVariantForSample(eFATHER, m_fatherChildConfig);
-    FillVariantForSample(eCHILD, m_motherChildConfig);
+    for(unsigned int k = 0; k < a_rChild.m_aVariantList.size(); k++)
+        a_rComparison.m_aChildVariantStatus[k] = std::vector<EVariantMatch>(a_rChild.m_aVariantList[k].size(), eNOT_ASSESSED);
 }
 
+SParentChildComparison& CMendelianVariantProvider::GetComparison(bool a_bIsFatherChild)
+{
+    return a_bIsFatherChild ? *m_pFatherChildComparison : *m_pMotherChildComparison;
+}
 
-void CMendelianVariantProvider::FillGenotypeMatchOrientedVariants(std::vector<SChrIdTriplet>& a_aCommonChromosomes)
+const SParentChildComparison& CMendelianVariantProvider::GetComparison(bool a_bIsFatherChild) const
 {
-    //INITIALIZE ORIENTED VARIANT LISTS
-    m_aFatherOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_FatherVcf.GetContigs().size());
-    m_aMotherOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_MotherVcf.GetContigs().size());
-    m_aChildOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_ChildVcf.GetContigs().size());
+    return a_bIsFatherChild ? *m_pFatherChildComparison : *m_pMotherChildComparison;
+}
+
+std::vector<EVariantMatch>& CMendelianVariantProvider::GetVariantStatusList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsFatherChild)
+{
+    if(a_uFrom == eCHILD)
+        return GetComparison(a_bIsFatherChild).m_aChildVariantStatus[a_nChrNo];
     
-    for(unsigned int i=0; i < a_aCommonChromosomes.size(); i++)
+    //Each parent is only compared with child
+    return GetComparison(a_uFrom == eFATHER).m_aParentVariantStatus[a_nChrNo];
+}
+
+EVariantMatch CMendelianVariantProvider::GetVariantStatus(EMendelianVcfName a_uFrom, const CVariant* a_pVariant) const
+{
+    switch (a_uFrom)
     {
-        //GENERATE FATHER ORIENTED VARS
-        m_aFatherOrientedVariantList[a_aCommonChromosomes[i].m_nFid] = std::vector<core::COrientedVariant>(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid].size(); j++, k+=2)
-        {
-            m_aFatherOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k] = core::COrientedVariant(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid][j], true);
-            m_aFatherOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k+1] = core::COrientedVariant(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid][j], false);
-        }
-        
-        //GENERATE CHILD ORIENTED VARS
-        m_aChildOrientedVariantList[a_aCommonChromosomes[i].m_nCid] = std::vector<core::COrientedVariant>(m_aChildVariantList[a_aCommonChromosomes[i].m_nCid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aChildVariantList[a_aCommonChromosomes[i].m_nCid].size(); j++,k+=2)
-        {
-            m_aChildOrientedVariantList[a_aCommonChromosomes[i].m_nCid][k] = core::COrientedVariant(m_aChildVariantList[a_aCommonChromosomes[i].m_nCid][j], true);
-            m_aChildOrientedVariantList[a_aCommonChromosomes[i].m_nCid][k+1] = core::COrientedVariant(m_aChildVariantList[a_aCommonChromosomes[i].m_nCid][j], false);
-        }
-        
-        //GENERATE MOTHER ORIENTED VARS
-        m_aMotherOrientedVariantList[a_aCommonChromosomes[i].m_nMid] = std::vector<core::COrientedVariant>(m_aMotherVariantList[a_aCommonChromosomes[i].m_nMid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aMotherVariantList[a_aCommonChromosomes[i].m_nMid].size(); j++, k+=2)
+        case eFATHER:
+            return m_pFatherChildComparison->m_aParentVariantStatus[a_pVariant->m_nChrId][a_pVariant->m_nId];
+        case eMOTHER:
+            return m_pMotherChildComparison->m_aParentVariantStatus[a_pVariant->m_nChrId][a_pVariant->m_nId];
+        default:
         {
-            m_aMotherOrientedVariantList[a_aCommonChromosomes[i].m_nMid][k] = core::COrientedVariant(m_aMotherVariantList[a_aCommonChromosomes[i].m_nMid][j], true);
-            m_aMotherOrientedVariantList[a_aCommonChromosomes[i].m_nMid][k+1] = core::COrientedVariant(m_aMotherVariantList[a_aCommonChromosomes[i].m_nMid][j], false);
+            EVariantMatch statusFC = m_pFatherChildComparison->m_aChildVariantStatus[a_pVariant->m_nChrId][a_pVariant->m_nId];
+            EVariantMatch statusMC = m_pMotherChildComparison->m_aChildVariantStatus[a_pVariant->m_nChrId][a_pVariant->m_nId];
+            
+            //A variant skipped in any of the comparisons is skipped
+            if(statusMC == eCOMPLEX_SKIPPED)
+                return statusMC;
+            return MergeVariantStatus(statusFC, statusMC);
         }
     }
 }
 
-void CMendelianVariantProvider::FillAlleleMatchOrientedVariants(std::vector<SChrIdTriplet>& a_aCommonChromosomes)
+void CMendelianVariantProvider::SetVariantStatus(std::vector<EVariantMatch>& a_rStatusList, const std::vector<const CVariant*>& a_rVariantList, EVariantMatch a_status)
 {
-    //INITIALIZE ORIENTED VARIANT LISTS
-    m_aFatherAlleleMatchOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_FatherVcf.GetContigs().size());
-    m_aMotherAlleleMatchOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_MotherVcf.GetContigs().size());
-    m_aChildAlleleMatchOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_ChildVcf.GetContigs().size());
+    for(const CVariant* pVar : a_rVariantList)
+        a_rStatusList[pVar->m_nId] = MergeVariantStatus(a_rStatusList[pVar->m_nId], a_status);
+}
 
-    for(unsigned int i=0; i < a_aCommonChromosomes.size(); i++)
+void CMendelianVariantProvider::SetVariantStatus(std::vector<EVariantMatch>& a_rStatusList, const std::vector<const core::COrientedVariant*>& a_rVariantList, EVariantMatch a_status)
+{
+    for(const core::COrientedVariant* pOVar : a_rVariantList)
+        a_rStatusList[pOVar->GetVariant().m_nId] = MergeVariantStatus(a_rStatusList[pOVar->GetVariant().m_nId], a_status);
+}
+
+void CMendelianVariantProvider::InitializeOrientedVariants(SMendelianSampleVariants& a_rSample)
+{
+    a_rSample.m_aOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(a_rSample.m_aVariantList.size());
+    a_rSample.m_aAlleleMatchOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(a_rSample.m_aVariantList.size());
+}
+
+void CMendelianVariantProvider::FillOrientedVariants(SMendelianSampleVariants& a_rSample, int a_nChrId)
+{
+    const std::vector<CVariant>& variants = a_rSample.m_aVariantList[a_nChrId];
+    std::vector<core::COrientedVariant>& orientedVariants = a_rSample.m_aOrientedVariantList[a_nChrId];
+    std::vector<core::COrientedVariant>& alleleMatchOrientedVariants = a_rSample.m_aAlleleMatchOrientedVariantList[a_nChrId];
+    
+    //GENERATE GENOTYPE MATCH ORIENTED VARS
+    orientedVariants = std::vector<core::COrientedVariant>(variants.size() * 2);
+    for(unsigned int j=0, k=0; j < variants.size(); j++, k+=2)
     {
-        //GENERATE FATHER ORIENTED VARS
-        m_aFatherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid] = std::vector<core::COrientedVariant>(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid].size(); j++, k+=2)
-        {
-            m_aFatherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k] = core::COrientedVariant(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid][j], 0);
-            m_aFatherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k+1] = core::COrientedVariant(m_aFatherVariantList[a_aCommonChromosomes[i].m_nFid][j], 1);
-        }
-        
-        //GENERATE CHILD ORIENTED VARS
-        m_aChildAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid] = std::vector<core::COrientedVariant>(m_aChildVariantList[a_aCommonChromosomes[i].m_nFid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aChildVariantList[a_aCommonChromosomes[i].m_nFid].size(); j++,k+=2)
-        {
-            m_aChildAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k] = core::COrientedVariant(m_aChildVariantList[a_aCommonChromosomes[i].m_nFid][j], 0);
-            m_aChildAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k+1] = core::COrientedVariant(m_aChildVariantList[a_aCommonChromosomes[i].m_nFid][j], 1);
-        }
-        
-        //GENERATE MOTHER ORIENTED VARS
-        m_aMotherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid] = std::vector<core::COrientedVariant>(m_aMotherVariantList[a_aCommonChromosomes[i].m_nFid].size() * 2);
-        for(unsigned int j=0, k=0; j < m_aMotherVariantList[a_aCommonChromosomes[i].m_nFid].size(); j++, k+=2)
-        {
-            m_aMotherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k] = core::COrientedVariant(m_aMotherVariantList[a_aCommonChromosomes[i].m_nFid][j], 0);
-            m_aMotherAlleleMatchOrientedVariantList[a_aCommonChromosomes[i].m_nFid][k+1] = core::COrientedVariant(m_aMotherVariantList[a_aCommonChromosomes[i].m_nFid][j], 1);
-        }
+        orientedVariants[k] = core::COrientedVariant(variants[j], true);
+        orientedVariants[k+1] = core::COrientedVariant(variants[j], false);
+    }
+    
+    //GENERATE ALLELE MATCH ORIENTED VARS
+    alleleMatchOrientedVariants = std::vector<core::COrientedVariant>(variants.size() * 2);
+    for(unsigned int j=0, k=0; j < variants.size(); j++, k+=2)
+    {
+        alleleMatchOrientedVariants[k] = core::COrientedVariant(variants[j], 0);
+        alleleMatchOrientedVariants[k+1] = core::COrientedVariant(variants[j], 1);
     }
 }
 
@@ -451,21 +587,21 @@ void CMendelianVariantProvider::SetCommonChromosomes()
 {
     int tripleIndex = 0;
     
-    for(auto fatherItr = m_FatherVcf.m_chrIndexMap.begin(); fatherItr != m_FatherVcf.m_chrIndexMap.end(); fatherItr++)
+    for(auto fatherItr = GetVcfReader(eFATHER).m_chrIndexMap.begin(); fatherItr != GetVcfReader(eFATHER).m_chrIndexMap.end(); fatherItr++)
     {
         bool isFound = false;
         
-        for(auto motherItr = m_MotherVcf.m_chrIndexMap.begin(); motherItr != m_MotherVcf.m_chrIndexMap.end(); motherItr++)
+        for(auto motherItr = GetVcfReader(eMOTHER).m_chrIndexMap.begin(); motherItr != GetVcfReader(eMOTHER).m_chrIndexMap.end(); motherItr++)
         {
-            for(auto childItr = m_ChildVcf.m_chrIndexMap.begin(); childItr != m_ChildVcf.m_chrIndexMap.end(); childItr++)
+            for(auto childItr = GetVcfReader(eCHILD).m_chrIndexMap.begin(); childItr != GetVcfReader(eCHILD).m_chrIndexMap.end(); childItr++)
             {
                 if(childItr->first == motherItr->first && childItr->first == fatherItr->first)
                 {
-                    if(m_aChildVariantList[childItr->second].size() > LEAST_VARIANT_THRESHOLD
+                    if(m_pSamples[eCHILD]->m_aVariantList[childItr->second].size() > LEAST_VARIANT_THRESHOLD
                        &&
-                       m_aFatherVariantList[fatherItr->second].size() > LEAST_VARIANT_THRESHOLD
+                       m_pSamples[eFATHER]->m_aVariantList[fatherItr->second].size() > LEAST_VARIANT_THRESHOLD
                        &&
-                       m_aMotherVariantList[motherItr->second].size() > LEAST_VARIANT_THRESHOLD)
+                       m_pSamples[eMOTHER]->m_aVariantList[motherItr->second].size() > LEAST_VARIANT_THRESHOLD)
                     {
                         if(m_motherChildConfig.m_bAutosomeOnly && !IsAutosome(motherItr->first))
                             continue;
@@ -493,130 +629,77 @@ std::vector<SChrIdTriplet>& CMendelianVariantProvider::GetCommonChromosomes()
 
 std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo) const
 {
-    std::vector<const CVariant*> varList;
+    const std::vector<CVariant>& variants = m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo];
+    std::vector<const CVariant*> varList(variants.size());
     
-    switch (a_uFrom) {
-        case eCHILD:
-            for(unsigned int k = 0; k < m_aChildVariantList[a_nChrNo].size();k++)
-                varList.push_back(&m_aChildVariantList[a_nChrNo][k]);
-            break;
-        case eFATHER:
-            for(unsigned int k = 0; k < m_aFatherVariantList[a_nChrNo].size();k++)
-                varList.push_back(&m_aFatherVariantList[a_nChrNo][k]);
-            break;
-        case eMOTHER:
-            for(unsigned int k = 0; k < m_aMotherVariantList[a_nChrNo].size();k++)
-                varList.push_back(&m_aMotherVariantList[a_nChrNo][k]);
-            break;
-
-        default:
-            break;
-    }
+    for(unsigned int k = 0; k < variants.size(); k++)
+        varList[k] = &variants[k];
     
     return varList;
 }
 
+const std::vector<CVariant>& CMendelianVariantProvider::GetVariants(EMendelianVcfName a_uFrom, int a_nChrNo) const
+{
+    return m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo];
+}
+
 std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_nIndexList) const
 {
-    std::vector<const CVariant*> varList;
+    const std::vector<CVariant>& variants = m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo];
+    std::vector<const CVariant*> varList(a_nIndexList.size());
     
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aChildVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-        case eFATHER:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aFatherVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-        case eMOTHER:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aMotherVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-            
-        default:
-            break;
-    }
+    for(unsigned int k = 0; k < a_nIndexList.size(); k++)
+        varList[k] = &variants[a_nIndexList[k]];
     
     return varList;
 }
 
-std::vector<const CVariant*> CMendelianVariantProvider::GetSortedVariantListByID(EMendelianVcfName a_uFrom, int a_nChrNo) const
+SVariantSpan CMendelianVariantProvider::GetSortedVariantListByID(EMendelianVcfName a_uFrom, int a_nChrNo) const
 {
-    std::vector<const CVariant*> varList = GetVariantList(a_uFrom, a_nChrNo);
-    std::sort(varList.begin(), varList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
-    return varList;
+    SVariantSpan span;
+    span.m_pVariants = &m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo];
+    span.m_pOrder = &m_pSamples[a_uFrom]->m_aIdOrder[a_nChrNo];
+    return span;
 }
 
-std::vector<const CVariant*> CMendelianVariantProvider::GetSortedVariantListByIDandStartPos(EMendelianVcfName a_uFrom, int a_nChrNo) const
+SVariantSpan CMendelianVariantProvider::GetSortedVariantListByIDandStartPos(EMendelianVcfName a_uFrom, int a_nChrNo) const
 {
-    std::vector<const CVariant*> varList = GetVariantList(a_uFrom, a_nChrNo);
-    std::sort(varList.begin(), varList.end(), [](const CVariant* pVar1, const CVariant* pVar2)
-    {
-        if(pVar1->m_nOriginalPos != pVar2->m_nOriginalPos)
-            return pVar1->m_nOriginalPos < pVar2->m_nOriginalPos;
-        else if(pVar1->m_nStartPos != pVar2->m_nStartPos)
-            return pVar1->m_nStartPos < pVar2->m_nStartPos;
-        else if(pVar1->m_nEndPos != pVar2->m_nEndPos)
-            return pVar1->m_nEndPos < pVar2->m_nEndPos;
-        else
-            return pVar1->m_nId < pVar2->m_nId;
-    });
-    return varList;
+    SVariantSpan span;
+    span.m_pVariants = &m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo];
+    span.m_pOrder = &m_pSamples[a_uFrom]->m_aOriginalPosOrder[a_nChrNo];
+    return span;
+}
+
+void CMendelianVariantProvider::FillVariantOrders(SMendelianSampleVariants& a_rSample)
+{
+    CBaseVariantProvider::FillVariantOrders(a_rSample.m_aVariantList, a_rSample.m_aIdOrder, CUtils::CompareVariantsById);
+    CBaseVariantProvider::FillVariantOrders(a_rSample.m_aVariantList, a_rSample.m_aOriginalPosOrder, CUtils::CompareVariantsByOriginalPos);
 }
 
 
 std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetOrientedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsAlleleMatch) const
 {
-    std::vector<const core::COrientedVariant*> ovarList;
-    const std::vector<std::vector<core::COrientedVariant>>* pBaseVarList;
-    
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aChildAlleleMatchOrientedVariantList : &m_aChildOrientedVariantList;
-            break;
-        case eFATHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aFatherAlleleMatchOrientedVariantList : &m_aFatherOrientedVariantList;
-            break;
-        case eMOTHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aMotherAlleleMatchOrientedVariantList : &m_aMotherOrientedVariantList;
-            break;
-        default:
-            break;
-    }
+    const std::vector<core::COrientedVariant>& baseVarList = a_bIsAlleleMatch ? m_pSamples[a_uFrom]->m_aAlleleMatchOrientedVariantList[a_nChrNo]
+                                                                              : m_pSamples[a_uFrom]->m_aOrientedVariantList[a_nChrNo];
+    std::vector<const core::COrientedVariant*> ovarList(baseVarList.size());
     
-    for(unsigned int k = 0; k < (*pBaseVarList)[a_nChrNo].size();k++)
-        ovarList.push_back(&((*pBaseVarList)[a_nChrNo][k]));
+    for(unsigned int k = 0; k < baseVarList.size(); k++)
+        ovarList[k] = &baseVarList[k];
     
     return ovarList;
 }
 
 std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetOrientedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsAlleleMatch, const std::vector<int>& a_nIndexList) const
 {
+    const std::vector<core::COrientedVariant>& baseVarList = a_bIsAlleleMatch ? m_pSamples[a_uFrom]->m_aAlleleMatchOrientedVariantList[a_nChrNo]
+                                                                              : m_pSamples[a_uFrom]->m_aOrientedVariantList[a_nChrNo];
     std::vector<const core::COrientedVariant*> ovarList;
-    const std::vector<std::vector<core::COrientedVariant>>* pBaseVarList;
-
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aChildAlleleMatchOrientedVariantList : &m_aChildOrientedVariantList;
-            break;
-        case eFATHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aFatherAlleleMatchOrientedVariantList : &m_aFatherOrientedVariantList;
-            break;
-        case eMOTHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aMotherAlleleMatchOrientedVariantList : &m_aMotherOrientedVariantList;
-            break;
-        default:
-            break;
-    }
+    ovarList.reserve(a_nIndexList.size() * 2);
     
     for(unsigned int k = 0; k < a_nIndexList.size();k++)
     {
-        ovarList.push_back(&((*pBaseVarList)[a_nChrNo][a_nIndexList[k]*2]));
-        ovarList.push_back(&((*pBaseVarList)[a_nChrNo][a_nIndexList[k]*2+1]));
+        ovarList.push_back(&baseVarList[a_nIndexList[k]*2]);
+        ovarList.push_back(&baseVarList[a_nIndexList[k]*2+1]);
     }
 
     return ovarList;
@@ -635,14 +718,7 @@ std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(const std
 
 int CMendelianVariantProvider:: GetVariantCount(EMendelianVcfName a_uFrom, int a_nChrNo) const
 {
-    if(a_uFrom == eMOTHER)
-        return static_cast<int>(m_aMotherVariantList[a_nChrNo].size());
-    if(a_uFrom == eFATHER)
-        return static_cast<int>(m_aFatherVariantList[a_nChrNo].size());
-    if(a_uFrom == eCHILD)
-        return static_cast<int>(m_aChildVariantList[a_nChrNo].size());
-    else
-        return -1;
+    return static_cast<int>(m_pSamples[a_uFrom]->m_aVariantList[a_nChrNo].size());
 }
 
 
@@ -650,27 +726,13 @@ int CMendelianVariantProvider::GetSkippedVariantCount(EMendelianVcfName a_uFrom)
 {
     int totalCount = 0;
     
-    const std::vector<std::vector<CVariant>>* pVariantList;
-    switch (a_uFrom)
-    {
-        case eFATHER:
-            pVariantList = &m_aFatherVariantList;
-            break;
-        case eMOTHER:
-            pVariantList = &m_aMotherVariantList;
-            break;
-        case eCHILD:
-            pVariantList = &m_aChildVariantList;
-            break;
-        default:
-            break;
-    }
+    const std::vector<std::vector<CVariant>>& variantList = m_pSamples[a_uFrom]->m_aVariantList;
     
-    for(unsigned int k = 0; k < pVariantList->size(); k++)
+    for(unsigned int k = 0; k < variantList.size(); k++)
     {
-        for(CVariant var : (*pVariantList)[k])
+        for(const CVariant& var : variantList[k])
         {
-            if(var.m_variantStatus == eCOMPLEX_SKIPPED)
+            if(GetVariantStatus(a_uFrom, &var) == eCOMPLEX_SKIPPED)
                 totalCount++;
         }
     }
@@ -681,93 +743,16 @@ int CMendelianVariantProvider::GetSkippedVariantCount(EMendelianVcfName a_uFrom)
 
 const std::vector<SVcfContig>& CMendelianVariantProvider::GetContigs() const
 {
-    return m_ChildVcf.GetContigs();
+    return GetVcfReader(eCHILD).GetContigs();
 }
 
 int CMendelianVariantProvider::GetContigCount(EMendelianVcfName a_uFrom)
 {
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            return (int)m_aChildVariantList.size();
-        case eFATHER:
-            return (int)m_aFatherVariantList.size();
-        case eMOTHER:
-            return (int)m_aMotherVariantList.size();
-        default:
-            return -1;
-    }
+    return static_cast<int>(m_pSamples[a_uFrom]->m_aVariantList.size());
 }
 
 
 int CMendelianVariantProvider::GetNotAssessedVariantCount(EMendelianVcfName a_uFrom)
 {
-    unsigned int skippedVariantCount = 0;
-    
-    switch (a_uFrom) {
-        case eMOTHER:
-            skippedVariantCount = m_nMotherNotAssessedVariantCount;
-            break;
-        case eFATHER:
-            skippedVariantCount = m_nFatherNotAssessedVariantCount;
-            break;
-        case eCHILD:
-            skippedVariantCount = m_nChildNotAssessedVariantCount;
-            break;
-        default:
-            break;
-    }
-    
-    return static_cast<int>(skippedVariantCount);
-}
-
-void CMendelianVariantProvider::FindOptimalTrimmings(std::vector<CVariant>& a_rVariantList, EMendelianVcfName a_uFrom)
-{
-    if(a_rVariantList.size() == 0)
-        return;
-    
-    std::vector<std::vector<CVariant>>* allVarList;
-    
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            allVarList = &m_aChildVariantList;
-            break;
-        case eFATHER:
-            allVarList = &m_aFatherVariantList;
-            break;
-        case eMOTHER:
-            allVarList = &m_aMotherVariantList;
-            break;
-        default:
-            allVarList = 0;
-            break;
-    }
-    
-    CBaseVariantProvider::FindOptimalTrimmings(a_rVariantList, allVarList, m_motherChildConfig);
-}
-
-
-void CMendelianVariantProvider::AppendTrimmedVariants(std::vector<CVariant>& a_rVariantList, EMendelianVcfName a_uFrom)
-{
-    std::vector<std::vector<CVariant>>* variantList;
-    
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            variantList = &m_aChildVariantList;
-            break;
-        case eFATHER:
-            variantList = &m_aFatherVariantList;
-            break;
-        case eMOTHER:
-            variantList = &m_aMotherVariantList;
-            break;
-        default:
-            variantList = 0;
-            break;
-    }
-    
-    for(unsigned int k = 0; k < a_rVariantList.size(); k++)
-        (*variantList)[a_rVariantList[k].m_nChrId].push_back(a_rVariantList[k]);
+    return m_pSamples[a_uFrom]->m_nNotAssessedVariantCount;
 }
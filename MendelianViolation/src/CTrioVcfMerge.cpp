@@ -26,101 +26,123 @@
 #include "CTrioVcfMerge.h"
 #include "CVariant.h"
 #include <algorithm>
+#include <climits>
 
 
 using namespace mendelian;
 
-///Constructor. Set the variant sets
-CTrioVcfMerge::CTrioVcfMerge(std::vector<const CVariant*>& a_rMotherVariants, std::vector<const CVariant*>& a_rFatherVariants, std::vector<const CVariant*>& a_rChildVariants) :
-m_motherVariants(a_rMotherVariants),
-m_fatherVariants(a_rFatherVariants),
-m_childVariants(a_rChildVariants)
+///Constructor. Set the variant spans. Record variants are returned in the same sample order
+CTrioVcfMerge::CTrioVcfMerge(const std::vector<SVariantSpan>& a_rSampleVariants) :
+m_aSampleVariants(a_rSampleVariants),
+m_aBufferStart(a_rSampleVariants.size(), 0),
+m_aBufferEnd(a_rSampleVariants.size(), 0)
 {
-    motherItr = 0;
-    fatherItr = 0;
-    childItr = 0;
+    m_nGroupEnd = INT_MIN;
+    m_bIsFirstRecord = true;
+    
+    for(int k = 0; k < (int)m_aSampleVariants.size(); k++)
+    {
+        if(m_aSampleVariants[k].size() > 0)
+            m_sampleHeap.push(std::make_pair(m_aSampleVariants[k][0]->m_nOriginalPos, k));
+    }
 }
 
 ///Return the next record variants. If a sample is 0/0 null pointer will be returned for that sample. false will be return when iterator comes to the end
-bool CTrioVcfMerge::GetNext(const CVariant** a_rMotherVariant, const CVariant** a_rFatherVariant, const CVariant** a_rChildVariant)
+bool CTrioVcfMerge::GetNext(std::vector<const CVariant*>& a_rRecordVariants, bool& a_rbIsNewGroup)
 {
-    bool bIsSuccess = true;
+    a_rRecordVariants.assign(m_aSampleVariants.size(), 0);
+    a_rbIsNewGroup = false;
     
     //Refill our variant buffer
-    if(motherVariantBuffer.size() == 0 && fatherVariantBuffer.size() == 0 && childVariantBuffer.size() == 0)
-         bIsSuccess = RefillBuffers();
+    if(m_aBufferedSamples.empty() && false == RefillBuffers())
+        return false;
     
-        
-    //We have multiple variants starting at same position. Best combination will be selected as a new record
-    if(motherVariantBuffer.size() > 1 || fatherVariantBuffer.size() > 1 || childVariantBuffer.size() > 1)
+    //Check if any sample has multiple variants starting at same position
+    bool bHasMultipleVariant = false;
+    int minimumStart = INT_MAX;
+    for(int sample : m_aBufferedSamples)
     {
-        int motherStart = motherVariantBuffer.size() == 0 ? INT_MAX : motherVariantBuffer[0]->m_nStartPos;
-        int fatherStart = fatherVariantBuffer.size() == 0 ? INT_MAX : fatherVariantBuffer[0]->m_nStartPos;
-        int childStart = childVariantBuffer.size() == 0 ? INT_MAX : childVariantBuffer[0]->m_nStartPos;
-        
-        int minimumStart = std::min({fatherStart, motherStart, childStart});
-        
-        if(motherStart == minimumStart)
-        {
-            *a_rMotherVariant = motherVariantBuffer[0];
-            motherVariantBuffer.erase(motherVariantBuffer.begin());
-        }
-        else
-            *a_rMotherVariant = 0;
-            
-        if(fatherStart == minimumStart)
-        {
-            *a_rFatherVariant = fatherVariantBuffer[0];
-            fatherVariantBuffer.erase(fatherVariantBuffer.begin());
-        }
-        else
-            *a_rFatherVariant = 0;
-
-        
-        if(childStart == minimumStart)
-        {
-            *a_rChildVariant = childVariantBuffer[0];
-            childVariantBuffer.erase(childVariantBuffer.begin());
-        }
-        else
-            *a_rChildVariant = 0;
-
+        const CVariant* pVariant = m_aSampleVariants[sample][m_aBufferStart[sample]];
+        minimumStart = std::min(minimumStart, pVariant->m_nStartPos);
+        if(m_aBufferEnd[sample] - m_aBufferStart[sample] > 1)
+            bHasMultipleVariant = true;
     }
     
-    //We have at most 1 variant per sample, send them directly to the output pointers and clear buffers
-    else
+    //We have multiple variants starting at same position. Variants with the smallest start position will be selected as a new record
+    //Otherwise we have at most 1 variant per sample, send them all directly to the output and clear buffers
+    for(int sample : m_aBufferedSamples)
     {
-        (*a_rMotherVariant) = motherVariantBuffer.size() == 0 ? 0 : motherVariantBuffer[0];
-        (*a_rFatherVariant) = fatherVariantBuffer.size() == 0 ? 0 : fatherVariantBuffer[0];
-        (*a_rChildVariant)  = childVariantBuffer.size() == 0 ? 0 : childVariantBuffer[0];
-        
-        //Clear buffers
-        motherVariantBuffer.clear();
-        fatherVariantBuffer.clear();
-        childVariantBuffer.clear();
+        const CVariant* pVariant = m_aSampleVariants[sample][m_aBufferStart[sample]];
+        if(false == bHasMultipleVariant || pVariant->m_nStartPos == minimumStart)
+        {
+            a_rRecordVariants[sample] = pVariant;
+            m_aBufferStart[sample]++;
+        }
     }
     
-    return bIsSuccess;
+    //Remove the samples whose buffer is consumed
+    m_aBufferedSamples.erase(std::remove_if(m_aBufferedSamples.begin(),
+                                            m_aBufferedSamples.end(),
+                                            [this](int sample){return m_aBufferStart[sample] == m_aBufferEnd[sample];}),
+                             m_aBufferedSamples.end());
+    
+    a_rbIsNewGroup = UpdateOverlapGroup(a_rRecordVariants);
+    
+    return true;
 }
 
 bool CTrioVcfMerge::RefillBuffers()
 {
     //Has variant left to fill buffers
-    if(childItr == (int)m_childVariants.size() && motherItr == (int)m_motherVariants.size() && fatherItr == (int)m_fatherVariants.size())
+    if(m_sampleHeap.empty())
         return false;
     
-    smallestVariantPosition = std::min({childItr  == (int)m_childVariants.size()  ?  INT_MAX : m_childVariants[childItr]->m_nOriginalPos,
-                                        motherItr == (int)m_motherVariants.size() ?  INT_MAX : m_motherVariants[motherItr]->m_nOriginalPos,
-                                        fatherItr == (int)m_fatherVariants.size() ?  INT_MAX :  m_fatherVariants[fatherItr]->m_nOriginalPos});
-    
-    while(childItr < (int)m_childVariants.size() && smallestVariantPosition == m_childVariants[childItr]->m_nOriginalPos)
-        childVariantBuffer.push_back(m_childVariants[childItr++]);
+    int smallestVariantPosition = m_sampleHeap.top().first;
     
-    while(motherItr < (int)m_motherVariants.size() && smallestVariantPosition == m_motherVariants[motherItr]->m_nOriginalPos)
-        motherVariantBuffer.push_back(m_motherVariants[motherItr++]);
+    while(false == m_sampleHeap.empty() && m_sampleHeap.top().first == smallestVariantPosition)
+    {
+        int sample = m_sampleHeap.top().second;
+        const SVariantSpan& rVariants = m_aSampleVariants[sample];
+        m_sampleHeap.pop();
+        
+        int itr = m_aBufferEnd[sample];
+        while(itr < (int)rVariants.size() && rVariants[itr]->m_nOriginalPos == smallestVariantPosition)
+            itr++;
+        
+        m_aBufferEnd[sample] = itr;
+        m_aBufferedSamples.push_back(sample);
+        
+        //Push the next variant of the sample back to the heap
+        if(itr < (int)rVariants.size())
+            m_sampleHeap.push(std::make_pair(rVariants[itr]->m_nOriginalPos, sample));
+    }
     
-    while(fatherItr < (int)m_fatherVariants.size() && smallestVariantPosition == m_fatherVariants[fatherItr]->m_nOriginalPos)
-        fatherVariantBuffer.push_back(m_fatherVariants[fatherItr++]);
+    //Keep the sample order of the buffer stable
+    std::sort(m_aBufferedSamples.begin(), m_aBufferedSamples.end());
     
     return true;
 }
+
+bool CTrioVcfMerge::UpdateOverlapGroup(const std::vector<const CVariant*>& a_rRecordVariants)
+{
+    int recordPosition = INT_MAX;
+    int recordEnd = INT_MIN;
+    
+    for(const CVariant* pVariant : a_rRecordVariants)
+    {
+        if(pVariant != 0)
+        {
+            recordPosition = std::min(recordPosition, pVariant->m_nOriginalPos);
+            recordEnd = std::max(recordEnd, pVariant->m_nEndPos);
+        }
+    }
+    
+    //Records are streamed in original position order and trimmed start positions are never smaller than the original position.
+    //So if a record starts after the end of the group, none of the following records can overlap with the group
+    bool bIsNewGroup = m_bIsFirstRecord || recordPosition > m_nGroupEnd;
+    
+    m_nGroupEnd = bIsNewGroup ? recordEnd : std::max(m_nGroupEnd, recordEnd);
+    m_bIsFirstRecord = false;
+    
+    return bIsNewGroup;
+}
@@ -102,6 +102,18 @@ bool CUtils::CompareVariantsById(const CVariant* v1, const CVariant* v2)
     return v1->m_nId < v2->m_nId;
 }
 
+bool CUtils::CompareVariantsByOriginalPos(const CVariant* v1, const CVariant* v2)
+{
+    if(v1->m_nOriginalPos != v2->m_nOriginalPos)
+        return v1->m_nOriginalPos < v2->m_nOriginalPos;
+    else if(v1->m_nStartPos != v2->m_nStartPos)
+        return v1->m_nStartPos < v2->m_nStartPos;
+    else if(v1->m_nEndPos != v2->m_nEndPos)
+        return v1->m_nEndPos < v2->m_nEndPos;
+    else
+        return v1->m_nId < v2->m_nId;
+}
+
 bool CUtils::CompareOrientedVariantsById(const core::COrientedVariant* v1, const core::COrientedVariant* v2)
 {
     return v1->GetVariant().m_nId < v2->GetVariant().m_nId;
@@ -55,6 +55,9 @@ public:
     ///Compare variants according to id for sort operation
     static bool CompareVariantsById(const CVariant* v1, const CVariant* v2);
     
+    ///Compare variants according to original (untrimmed) position, start, end positions and id for sort operation
+    static bool CompareVariantsByOriginalPos(const CVariant* v1, const CVariant* v2);
+    
     ///Compare  oriented variants according to id for sort operation
     static bool CompareOrientedVariantsById(const core::COrientedVariant* v1, const core::COrientedVariant* v2);
     
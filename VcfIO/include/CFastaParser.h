@@ -28,6 +28,9 @@
 
 #include "faidx.h"
 #include <string>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
 
 /**
  * @brief Container to store each FASTA contig
@@ -36,13 +39,26 @@
  */
 struct SContig
 {
-    //Free the reference sequence
+    //Free the reference sequence (Shared sequences are only released)
     bool Clean();
     
     //Chromosome name written on fasta/vcf
     std::string  m_chromosomeName;
-    char* m_pRefSeq = 0;
+    const char* m_pRefSeq = 0;
     int m_nRefLength;
+    
+    //True if m_pRefSeq points to the shared (memory mapped) reference cache. It is owned by CFastaParser
+    bool m_bIsShared = false;
+};
+
+/**
+ * @brief Location of a contig sequence inside the reference cache file
+ *
+ */
+struct SReferenceCacheEntry
+{
+    long long m_nOffset;
+    int m_nLength;
 };
 
 
@@ -59,8 +75,8 @@ public:
     ///Destructor
     ~CFastaParser();
     
-    ///Open Given FASTA file with the given filename and creates FASTA index file if it does not exists
-    bool OpenFastaFile(const char *fn);
+    ///Open Given FASTA file with the given filename and creates FASTA index file if it does not exists. If a cache directory is given, contigs are served from the reference cache stored there
+    bool OpenFastaFile(const char *fn, const char* a_pCacheDirectory = NULL);
     
     ///Read contig from FASTA file name with the given chromosome name
     bool FetchNewChromosome(std::string chromosome, SContig& a_rContig);
@@ -68,9 +84,32 @@ public:
     ///Generate FASTA index file from given fasta file if it does not already exists
     bool GenerateFastaIndex(const char *fn);
     
+    ///Returns the length of the given contig in the reference cache. Returns -1 if the cache is not available or contig is not found
+    int GetCachedContigLength(const std::string& a_rChromosome) const;
+    
+    ///Asks the kernel to read ahead the pages of the given contig in the reference cache. Returns FALSE if the contig is not cached
+    bool PrefetchChromosome(const std::string& a_rChromosome) const;
+    
 private:
     
-    faidx_t *fai;
+    //Open the reference cache (<cache_dir>/<fasta_name>.vbtref) of given FASTA file. The cache is (re)generated if it does not exist or its FASTA size/mtime does not match
+    bool OpenReferenceCache(const char *fn, const char* a_pCacheDirectory);
+    
+    //Memory map the cache file. Returns FALSE if the file does not exist, belongs to another version of the FASTA or is corrupted
+    bool LoadReferenceCache(const std::string& a_rCachePath, const struct stat& a_rFastaStat);
+    
+    //Write all contigs of FASTA as contiguous sequences into a unique temporary file and rename it to the cache path
+    bool GenerateReferenceCache(const std::string& a_rCachePath, const struct stat& a_rFastaStat);
+    
+    faidx_t *fai = 0;
+    
+    //faidx is not thread safe. Only used if the reference cache is not available
+    std::mutex m_faidxMutex;
+    
+    //Memory mapped reference cache which is shared read-only by all threads
+    const char* m_pCache = 0;
+    long long m_nCacheSize = 0;
+    std::unordered_map<std::string, SReferenceCacheEntry> m_cacheEntries;
 };
 
 #endif //_C_FASTA_PARSER_H_
@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CJointVcfStore.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_JOINT_VCF_STORE_H_
+#define _C_JOINT_VCF_STORE_H_
+
+#include <string>
+#include <vector>
+#include "CVcfReader.h"
+#include "SSharedRecord.h"
+#include "SConfig.h"
+
+class CSimpleBEDParser;
+
+/**
+ * @brief Decodes a joint-called multi-sample vcf once and keeps the genotypes of each sample in a compact list
+ *
+ * Sample independent columns of each record are stored once. Each sample only stores the genotypes which are not homozygous reference
+ * (record index + allele indexes). Variants of a sample are generated on demand from the shared record and the genotype, so the
+ * variant lists of a sample only exist while it is being processed.
+ */
+class CJointVcfStore
+{
+    
+public:
+    
+    ///Opens the joint vcf and selects the given samples. Genotypes of other samples are not decoded
+    bool Open(const char* a_pVcfPath, const std::vector<std::string>& a_rSampleNames);
+    
+    ///Restricts reading to the given BED regions using the index of the input. Returns FALSE if the input has no index
+    bool SetRegions(const CSimpleBEDParser& a_rBedParser);
+    
+    ///Reads all records of the vcf in a single pass and fans the genotypes out to the sample lists
+    bool Load(const SConfig& a_rConfig);
+    
+    ///Returns the index of the sample in the store. -1 if the sample is not selected
+    int GetSampleIndex(const std::string& a_rSampleName) const;
+    
+    ///Returns the number of stored genotypes of the sample
+    int GetGenotypeCount(int a_nSampleIndex) const;
+    
+    ///Generates the variant of the k-th stored genotype of the sample. Returns FALSE if k is out of range. Thread safe
+    bool GetSampleVariant(int a_nSampleIndex, int a_nGenotypeIndex, int a_nId, const SConfig& a_rConfig, CVariant* a_pVariant) const;
+    
+    ///Frees the genotypes of the sample. Called when all families that contains the sample are processed
+    void ReleaseSample(int a_nSampleIndex);
+    
+    ///Returns the reader of the joint vcf (header, contigs and info arena of the records)
+    const CVcfReader& GetReader() const {return m_vcfReader;};
+    
+private:
+    
+    //Reader of the joint vcf
+    CVcfReader m_vcfReader;
+    
+    //Selected samples in the order of vcf header
+    std::vector<std::string> m_aSampleNames;
+    
+    //Sample independent columns of records which has at least one stored genotype
+    std::vector<SSharedRecord> m_aRecords;
+    
+    //Stored genotypes of each sample [sample][k]
+    std::vector<std::vector<SSampleGenotype>> m_aSampleGenotypes;
+};
+
+#endif // _C_JOINT_VCF_STORE_H_
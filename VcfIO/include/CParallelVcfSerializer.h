@@ -0,0 +1,49 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CParallelVcfSerializer.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_PARALLEL_VCF_SERIALIZER_H_
+#define _C_PARALLEL_VCF_SERIALIZER_H_
+
+#include "CVcfWriter.h"
+#include <functional>
+
+/**
+ * @brief Serializes output chunks concurrently and writes them in order
+ *
+ * Each job (eg. a file-chromosome pair) is serialized into its own SVcfChunk by the worker threads. The calling thread writes
+ * the finished chunks in job order as soon as they are ready. Workers can only run a limited number of jobs ahead of the writer
+ * so that only a few serialized chunks are kept in memory at a time
+ */
+class CParallelVcfSerializer
+{
+    
+public:
+    
+    ///Serialize a_nJobCount jobs with a_rSerializeFunction on a_nThreadCount threads and pass each chunk to a_rWriteFunction in job order
+    static void Run(int a_nJobCount,
+                    int a_nThreadCount,
+                    const std::function<void(int, SVcfChunk&)>& a_rSerializeFunction,
+                    const std::function<void(int, SVcfChunk&)>& a_rWriteFunction);
+};
+
+#endif // _C_PARALLEL_VCF_SERIALIZER_H_
@@ -52,13 +52,21 @@ public:
     
     ///Reads the bed file and save it inside. If there is an unknown region format, it returns FALSE
     bool InitBEDFile(const std::string& a_rBEDFilePath);
+    
+    ///Returns the sorted and merged region list of given contig (Empty list if contig has no region)
+    const std::vector<SBedRegion>& GetRegions(const std::string& a_rChrName) const;
         
-    ///Bed Region map use chromosome name as key [This one is not accesible with GetNextRegion]
+    ///Bed Region map use chromosome name as key. Regions of each contig are sorted by start position and overlapping regions are merged
     std::unordered_map<std::string, std::vector<SBedRegion>> m_regionMap;
     
     //Total number of contigs in BED file
     unsigned int m_nTotalContigCount;
     
+private:
+    
+    //Sort the regions of each contig and merge the overlapping/adjacent ones
+    void MergeRegions();
+    
 };
 
 #endif // _C_SIMPLE_BED_PARSER_H_
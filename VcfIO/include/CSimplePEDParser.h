@@ -42,6 +42,19 @@ struct SPerson
     std::string m_motherId;
 };
 
+/**
+ * @brief Mother, father and child sample ids of a trio found in the pedigree
+ *
+ */
+struct SFamilyTrio
+{
+    std::string m_familyId;
+    std::string m_motherId;
+    std::string m_fatherId;
+    std::string m_childId;
+};
+
+
 
 /**
  * @brief Parse pedigree(PED) files for trio analysis where the input is a trio rather than 3 single individual
@@ -62,6 +75,9 @@ public:
                                        const std::vector<std::string> fatherList,
                                        const std::vector<std::string> childList);
     
+    ///Returns all trios of the pedigree whose mother, father and child exist in the given sample list. Trios are ordered by family and child id
+    std::vector<SFamilyTrio> GetTrios(const std::vector<std::string>& a_rSampleNames) const;
+    
 private:
 
 ///A Family pedigree tree constructed as the PED file is parsed
@@ -0,0 +1,88 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CStratificationIndex.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_STRATIFICATION_INDEX_H_
+#define _C_STRATIFICATION_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief Shared interval index of all stratifications of a single contig
+ *
+ * Region boundaries of all strata are merged into a single sorted breakpoint list. Each elementary segment [bp[i], bp[i+1])
+ * stores the ids of strata covering it in a flat array, so the strata of a position are found with one binary search.
+ */
+struct SStratifiedContig
+{
+    //Sorted unique region boundaries of all strata
+    std::vector<int> m_aBreakpoints;
+    
+    //Segment i owns m_aStrata[m_aSegmentOffsets[i] .. m_aSegmentOffsets[i+1])
+    std::vector<int> m_aSegmentOffsets;
+    
+    //Stratum ids of all segments
+    std::vector<int> m_aStrata;
+};
+
+/**
+ * @brief Reads a list of BED stratifications and annotates positions with the strata they belong to
+ *
+ * The stratification file is a TSV where each line is <stratum_name> <bed_path>. Relative BED paths are resolved from the
+ * directory of the TSV file.
+ */
+class CStratificationIndex
+{
+    
+public:
+    
+    ///Reads the stratification TSV and all BED files in it and builds the index. Returns FALSE if any file cannot be read
+    bool Init(const std::string& a_rStratificationFilePath);
+    
+    ///Number of strata
+    int GetStratumCount() const;
+    
+    ///Name of the given stratum as written in the TSV file
+    const std::string& GetStratumName(int a_nStratumId) const;
+    
+    ///Returns the index of given contig. NULL if none of the strata has a region in that contig
+    const SStratifiedContig* GetContig(const std::string& a_rChrName) const;
+    
+    ///Returns the stratum ids which contain the given 0-based position as [a_rpBegin, a_rpEnd)
+    static void GetStrata(const SStratifiedContig& a_rContig, int a_nPosition, const int*& a_rpBegin, const int*& a_rpEnd);
+    
+private:
+    
+    //Builds the breakpoint/segment index of a contig from the merged regions of each stratum
+    void BuildContigIndex(const std::string& a_rChrName, const std::vector<std::vector<std::pair<int,int>>>& a_rRegions);
+    
+    //Names of the strata ordered by stratum id
+    std::vector<std::string> m_aStratumNames;
+    
+    //Index of each contig
+    std::unordered_map<std::string, SStratifiedContig> m_contigMap;
+    
+};
+
+#endif // _C_STRATIFICATION_INDEX_H_
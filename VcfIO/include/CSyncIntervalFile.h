@@ -0,0 +1,107 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CSyncIntervalFile.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_SYNC_INTERVAL_FILE_H_
+#define _C_SYNC_INTERVAL_FILE_H_
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+/**
+ * @brief Region between two consecutive sync points and the variant id ranges of both sides inside the region
+ *
+ * Variant ids are inclusive. -1 means the side has no variant in the region
+ */
+struct SSyncInterval
+{
+    int32_t m_nStartPosition;
+    int32_t m_nEndPosition;
+    int32_t m_nBaseFirstId;
+    int32_t m_nBaseLastId;
+    int32_t m_nCalledFirstId;
+    int32_t m_nCalledLastId;
+};
+
+/**
+ * @brief Binary sync point interval file with a per contig index
+ *
+ * Layout: magic, version, SSyncInterval records of each contig (contiguous), contig index (name, record offset, record count) and
+ * the offset of the index at the end of the file. File is memory mapped while reading so the intervals of a contig are accessed without parsing
+ */
+class CSyncIntervalFile
+{
+    
+public:
+    
+    CSyncIntervalFile();
+    ~CSyncIntervalFile();
+    
+    ///Creates the file for writing
+    bool Create(const std::string& a_rFilePath);
+    
+    ///Appends the intervals of the given contig. Each contig should be written once
+    bool WriteContig(const std::string& a_rChrName, const std::vector<SSyncInterval>& a_rIntervals);
+    
+    ///Opens the given file for reading (memory mapped). Returns FALSE if the file is not a sync interval file
+    bool Open(const std::string& a_rFilePath);
+    
+    ///Closes the file. Index is written if the file is opened for writing
+    bool Close();
+    
+    ///Returns true if the given file starts with the sync interval file signature
+    static bool IsSyncIntervalFile(const std::string& a_rFilePath);
+    
+    ///Returns the names of the contigs in the order of the file
+    std::vector<std::string> GetContigNames() const;
+    
+    ///Access to the intervals of the given contig. Returns FALSE if the contig is not in the file
+    bool GetIntervals(const std::string& a_rChrName, const SSyncInterval*& a_rpIntervals, unsigned int& a_rCount) const;
+    
+private:
+    
+    //Index entry of a contig
+    struct SContigEntry
+    {
+        std::string m_name;
+        uint64_t m_nOffset;
+        uint64_t m_nCount;
+    };
+    
+    //Reads the contig index of the mapped file
+    bool ReadIndex();
+    
+    //Output file (write mode)
+    FILE* m_pFile;
+    uint64_t m_nWriteOffset;
+    
+    //Mapped file (read mode)
+    const char* m_pMapped;
+    uint64_t m_nMappedSize;
+    
+    //Contig index
+    std::vector<SContigEntry> m_contigs;
+};
+
+#endif // _C_SYNC_INTERVAL_FILE_H_
@@ -0,0 +1,83 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CTaskScheduler.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_TASK_SCHEDULER_H_
+#define _C_TASK_SCHEDULER_H_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+/**
+ * @brief Work-stealing scheduler of independent tasks with estimated costs
+ *
+ * Tasks are seeded largest-first: each task (in descending cost order) is appended to the queue of the worker with the least
+ * total cost. A worker runs the tasks of its own queue from the front (largest first). When its queue is empty, it steals the
+ * smallest remaining task from the back of another worker's queue, so no worker exits while there is work left. Tasks can be of any
+ * granularity (chromosomes, blocks of a chromosome, output jobs).
+ */
+class CTaskScheduler
+{
+    
+public:
+    
+    ///Creates the scheduler for a_rTaskCosts.size() tasks. Thread count is limited by the number of tasks
+    CTaskScheduler(const std::vector<double>& a_rTaskCosts, int a_nThreadCount);
+    
+    ///Runs a_rTaskFunction(taskId, workerId) for every task and returns after all tasks are completed. Calling thread is worker 0
+    void Run(const std::function<void(int, int)>& a_rTaskFunction);
+    
+    ///Returns the tasks waiting in the queue of given worker in execution order (they may still be stolen by other workers)
+    std::vector<int> GetQueuedTasks(int a_nWorkerId) const;
+    
+    ///Number of workers
+    int GetThreadCount() const {return m_nThreadCount;};
+    
+    ///Estimated cost of a chromosome task: variant count x (1 + variant density per kb)
+    static double EstimateCost(int a_nVariantCount, int a_nSpanLength);
+    
+private:
+    
+    //Task queue of a worker
+    struct SWorkerQueue
+    {
+        std::deque<int> m_aTasks;
+        std::mutex m_mutex;
+    };
+    
+    //Pops the next task from the front of worker's own queue
+    bool PopTask(int a_nWorkerId, int& a_rTask);
+    
+    //Steals a task from the back of the other workers' queues
+    bool StealTask(int a_nWorkerId, int& a_rTask);
+    
+    //Executes the tasks until all queues are empty
+    void Work(int a_nWorkerId, const std::function<void(int, int)>& a_rTaskFunction);
+    
+    std::vector<std::unique_ptr<SWorkerQueue>> m_aQueues;
+    int m_nThreadCount;
+};
+
+#endif // _C_TASK_SCHEDULER_H_
@@ -161,6 +161,12 @@ class CVariant
     //Quality of variant
     float m_fQuality;
     
+    ///Score of the variant that is used for ROC output (QUAL, INFO or FORMAT value). NaN if it is missing or not read
+    float m_fScore;
+    
+    ///Virtual file offset (bgzf_tell) of the original record in the input file. -1 if it is not known
+    int64_t m_nFileOffset;
+    
     mutable EVariantMatch m_variantStatus;
     
     ///True if the variant genotype is phased
@@ -0,0 +1,74 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CVariantCache.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_VARIANT_CACHE_H_
+#define _C_VARIANT_CACHE_H_
+
+#include <string>
+#include <vector>
+#include "CVariant.h"
+#include "SConfig.h"
+
+/**
+ * @brief Binary on-disk cache of parsed and trimmed variant lists of a single sample
+ *
+ * Cache file is versioned and keyed by the checksum of the input files and the config fields that affect parsing/trimming.
+ * A cache is only accepted if its version and key are identical to the current run. Files are memory mapped while loading.
+ */
+class CVariantCache
+{
+
+public:
+
+    ///Generates the cache key of given vcf sample with the current parsing configuration
+    static std::string GenerateKey(const char* a_pVcfPath, const std::string& a_rSampleName, const SConfig& a_rConfig);
+
+    ///Returns the cache file path for given vcf and sample under the cache directory
+    static std::string GetCachePath(const char* a_pCacheDirectory, const char* a_pVcfPath, const std::string& a_rSampleName);
+
+    ///Loads the variant lists from the cache file. Returns FALSE if the file does not exist or version/key does not match
+    bool Load(const std::string& a_rCachePath,
+              const std::string& a_rKey,
+              std::vector<std::vector<CVariant>>& a_rVariantList,
+              std::vector<std::vector<CVariant>>& a_rNotAssessedVariantList);
+
+    ///Writes the variant lists to the cache file
+    bool Save(const std::string& a_rCachePath,
+              const std::string& a_rKey,
+              const std::vector<std::vector<CVariant>>& a_rVariantList,
+              const std::vector<std::vector<CVariant>>& a_rNotAssessedVariantList);
+
+private:
+
+    //Computes the crc32 checksum of whole file. Returns FALSE if file cannot be read
+    static bool GetFileChecksum(const char* a_pFilePath, unsigned long& a_rChecksum, long long& a_rFileSize);
+
+    //Serialize/Deserialize helpers
+    void WriteVariantList(std::string& a_rBuffer, const std::vector<std::vector<CVariant>>& a_rVariantList);
+    bool ReadVariantList(const char*& a_rpCursor, const char* a_pEnd, std::vector<std::vector<CVariant>>& a_rVariantList);
+    void WriteVariant(std::string& a_rBuffer, const CVariant& a_rVariant);
+    bool ReadVariant(const char*& a_rpCursor, const char* a_pEnd, CVariant& a_rVariant);
+
+};
+
+#endif // _C_VARIANT_CACHE_H_
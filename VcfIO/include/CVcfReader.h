@@ -28,8 +28,10 @@
 #include <string>
 #include <vector>
 #include "htslib/vcf.h"
+#include "htslib/tbx.h"
 #include "CVariant.h"
 #include "SConfig.h"
+#include "SSharedRecord.h"
 #include <map>
 
 /**
@@ -42,6 +44,19 @@ struct SVcfContig
     int length;
 };
 
+class CSimpleBEDParser;
+
+/**
+ * @brief Interval query of the reader when the input is restricted to BED regions
+ *
+ */
+struct SRegionQuery
+{
+    int m_nTid;
+    int m_nStartPos;
+    int m_nEndPos;
+};
+
 /**
  * @brief VCF parser that is based on htslib
  *
@@ -63,10 +78,28 @@ public:
     
     ///Get next record in the file. a_nId sets the id of variant (no need to be set)
     bool GetNextRecord(CVariant* a_pVariant, int a_nId, const SConfig& a_rConfig);
+    
+    ///Get next record in the file for all selected samples. Sample independent columns are decoded once to a_rRecord and genotype of each sample (in header order) to a_rGenotypes
+    bool GetNextSharedRecord(SSharedRecord& a_rRecord, std::vector<SSampleGenotype>& a_rGenotypes, const SConfig& a_rConfig);
+    
+    ///Decodes the INFO columns of the record last read by GetNextSharedRecord to a_rRecord. Only called for kept records so dropped records do not use the info arena
+    void ReadSharedRecordInfo(SSharedRecord& a_rRecord);
+    
+    ///Generates the variant of a sample from a record read by GetNextSharedRecord. It is identical to the variant GetNextRecord returns when only that sample is selected
+    void FillSampleVariant(const SSharedRecord& a_rRecord, const SSampleGenotype& a_rGenotype, int a_nId, const SConfig& a_rConfig, CVariant* a_pVariant) const;
         
+    ///Restricts reading to the given BED regions using the tabix/CSI index of the input. Returns FALSE if the input has no index
+    bool SetRegions(const CSimpleBEDParser& a_rBedParser);
+    
     ///Selects the sample name from multi sample VCF file and ignore other samples
     bool SelectSample(std::string a_sampleName);
     
+    ///Selects the given samples from multi sample VCF file and ignore other samples. Genotypes are read in the sample order of the header
+    bool SelectSamples(const std::vector<std::string>& a_rSampleNames);
+    
+    ///Returns the sample selected by SelectSample (empty if no sample is selected)
+    std::string GetSelectedSample() const {return m_selectedSample;};
+    
     ///Fills the a_PatientList with sample names
     void GetSampleNames(std::vector<std::string>& a_PatientList);
     
@@ -77,6 +110,9 @@ public:
     ///Get the filename
     std::string GetFilename() const {return m_filename;};
     
+    ///Returns true if the input is detected as (compressed or uncompressed) BCF
+    bool IsBcf() const {return m_bIsBcf;};
+    
     ///Get the number of samples in vcf
     int GetNumberOfSamples() const;
     
@@ -116,26 +152,58 @@ public:
     ///Returns Record Pointer of htslib
     bcf1_t* GetRecordPointer();
     
+    ///Reads the original record at the given virtual file offset (CVariant::m_nFileOffset) into the record pointer. Returns FALSE if the input is not seekable
+    bool ReadRecordAt(int64_t a_nFileOffset);
+    
+    ///Creates a copy of the header which contains only the selected sample. Records read by this reader can be written with it as they are
+    bcf_hdr_t* CreateSampleHeader() const;
+    
     ///Store chromosome name indexes
     std::map<std::string, int> m_chrIndexMap;
     
 private:
 
     /// Trimms the alt string that contains ref allele
-    void TrimAllele(SAllele& a_rAllele);
+    void TrimAllele(SAllele& a_rAllele) const;
         
     /// Return whether given allele can be trimmed more than one way
-    bool HasMultipleTrimming(SAllele& a_rAllele);
+    bool HasMultipleTrimming(const SAllele& a_rAllele, const char* a_pRefSequence) const;
     
     ///Check if the first nucleotide for alleles are redundant (for indels)
-    bool HasRedundantFirstNucleotide() const;
+    bool HasRedundantFirstNucleotide(const char* const* a_pAlleles, int a_nAlleleCount) const;
+    
+    ///Fills the sample dependent columns of the variant (alleles, zygosity, trimming, start/end positions and genotypes) from decoded allele indexes of the sample
+    void FillGenotypeColumns(CVariant* a_pVariant,
+                             const char* const* a_pAlleles,
+                             int a_nAlleleCount,
+                             int a_nPosition,
+                             const int* a_pGenotype,
+                             int a_nZygotCount,
+                             bool a_bHasSamples,
+                             const SConfig& a_rConfig) const;
     
     ///Return the chromosome number [0 to 24]
     int GetChromosomeNumber(const std::string& a_chrName) const;
     
+    ///Reads the next record into m_pRecord (Reads through the region iterators if regions are set). Returns negative value at the end of file
+    int ReadRecord();
+    
+    ///Reads the next record from the record stream and stores its virtual offset
+    int ReadStreamRecord();
+    
+    ///Opens the stream that sequential reads are done through. For text vcf, header lines are skipped
+    bool OpenRecordStream();
+    
+    ///Decodes the selected info columns of current record into the info arena of its chromosome
+    void ReadInfoColumns(CVariant* a_pVariant);
+    
+    ///Reads the ROC score field of current record. Returns NaN if the value is missing
+    float ReadScore(const char* a_pScoreField);
+    
     
     std::string m_filename;
     bool m_bIsOpen;
+    bool m_bIsBcf;
     htsFile *   m_pHtsFile;
     bcf_hdr_t * m_pHeader;
     bcf1_t *    m_pRecord;  
@@ -145,6 +213,56 @@ private:
   
     
     std::vector<std::string> m_infoNames;
+    
+    //Decoded INFO values of each contig. Variants refer to their slice by SInfo
+    std::vector<std::vector<char>> m_aInfoArena;
+    
+    //Reusable buffers for bcf_get_info_values. String sizes are counted in bytes and numeric sizes in values by htslib, so they are kept separate
+    void* m_pInfoBuffer;
+    int m_nInfoBufferSize;
+    void* m_pInfoStringBuffer;
+    int m_nInfoStringBufferSize;
+    
+    //Reusable buffer for bcf_get_genotypes
+    int* m_pGenotypeBuffer;
+    int m_nGenotypeBufferSize;
+    
+    //Decoded allele indexes of the selected sample at the current record
+    std::vector<int> m_aGenotypeIndexes;
+    
+    //Index of the input and the region iterator which are used if the reader is restricted to BED regions
+    bool m_bIsRegionMode;
+    hts_idx_t* m_pIndex;
+    tbx_t* m_pTabix;
+    hts_itr_t* m_pRegionItr;
+    std::vector<SRegionQuery> m_regionQueries;
+    unsigned int m_nRegionIndex;
+    kstring_t m_lineBuffer;
+    
+    //Stream that records are read sequentially (bgzf stream of htslib for BCF, a separate stream for text vcf)
+    BGZF* m_pRecordStream;
+    //First record line of text vcf which is read while skipping the header
+    bool m_bHasPendingLine;
+    int64_t m_nPendingLineOffset;
+    //Virtual offset of the last record read (-1 if it is read through a region iterator)
+    int64_t m_nRecordOffset;
+    
+    //Sample that is selected by SelectSample (empty if all samples are read)
+    std::string m_selectedSample;
+    
+    //Filter name that is checked for PASS decision and its key in the header
+    const char* m_pFilterName;
+    int m_nFilterKey;
+    
+    //Score field that is read for ROC output, its column (BCF_HL_INFO/BCF_HL_FMT, -1 for QUAL), tag and value type
+    const char* m_pScoreField;
+    int m_nScoreColumn;
+    std::string m_scoreTag;
+    int m_nScoreType;
+    
+    //Reusable buffer for score values
+    void* m_pScoreBuffer;
+    int m_nScoreBufferSize;
 };
 
 #endif //VCF_READER_H_
@@ -27,8 +27,11 @@
 #define _C_VCF_WRITER_H_
 
 #include "htslib/vcf.h"
+#include "htslib/kstring.h"
 #include "CVariant.h"
+#include "EVcfOutputFormat.h"
 #include <string>
+#include <vector>
 
 /**
  * @brief Stores FORMAT column of vcf record
@@ -83,7 +86,26 @@ struct SVcfRecord
     ///Sample Data (Data to store for each sample)
     std::vector<SPerSampleData> m_aSampleData;
     ///All info data that is stored for VCF Record (here is the priority from which sample the info columns are taken(for 3 single-sample vcf input): child > father > mother)
-    SInfo* m_pInfo = NULL;
+    const SInfo* m_pInfo = NULL;
+};
+
+/**
+ * @brief Serialized records of a part of the output (eg. a chromosome)
+ *
+ * Chunks of a writer can be filled concurrently by different threads. They are appended to the output file in order by CVcfWriter::WriteChunk
+ */
+struct SVcfChunk
+{
+    ///Formatted vcf lines. For VCF.GZ output, only the lines which are not compressed into a BGZF block yet
+    kstring_t m_text = {0, 0, NULL};
+    ///Compressed BGZF blocks (VCF.GZ output)
+    std::string m_compressed;
+    ///Encoded records (BCF output)
+    std::vector<bcf1_t*> m_aRecords;
+    ///Record that is used while encoding
+    bcf1_t* m_pRecord = NULL;
+    ///Filter ids and genotypes of the record that is encoded. Reused for all records of the chunk
+    std::vector<int32_t> m_aEncodeBuffer;
 };
 
 /**
@@ -98,19 +120,46 @@ public:
     
     CVcfWriter();
     
-    ///Creates VCF file at the given path
+    ///Set the format of the output file. Compression level [0-9] and thread count are only used for compressed formats. Should be called before CreateVcf
+    void SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount);
+    
+    ///Creates VCF file at the given path. Extension of the path is adjusted according to the output format (.vcf.gz / .bcf)
     void CreateVcf(const char* a_pFileName);
+    
+    ///Returns the path of the created file
+    const std::string& GetFileName() const;
         
     ///Append the given variant to the opened vcf file
     void AddRecord(const SVcfRecord& a_rVcfRecord);
     
+    ///Prepare the chunk for serializing records. Header should be written before records are added to the chunks
+    void InitChunk(SVcfChunk& a_rChunk) const;
+    
+    ///Serialize the given variant into the chunk. Can be called concurrently for different chunks
+    void AddRecord(const SVcfRecord& a_rVcfRecord, SVcfChunk& a_rChunk) const;
+    
+    ///Serialize the genotype record of the given variant into the chunk directly (single sample outputs). Can be called concurrently for different chunks
+    void AddRecord(const CVariant& a_rVariant, SVcfChunk& a_rChunk) const;
+    
+    ///Serialize the given variant into the chunk for Mendelian Trio Mode. Can be called concurrently for different chunks
+    void AddMendelianRecord(const SVcfRecord& a_rVcfRecord, SVcfChunk& a_rChunk) const;
+    
+    ///Complete the serialization of the chunk (compresses the remaining lines for VCF.GZ output)
+    void FinalizeChunk(SVcfChunk& a_rChunk) const;
+    
+    ///Append the serialized records of the chunk to the opened vcf file and release the chunk
+    void WriteChunk(SVcfChunk& a_rChunk);
+    
     ///Append the given raw variant to the opened vcf file
     void AddRawRecord(bcf1_t* a_rRecord);
     
+    ///Serialize the given raw record into the chunk as it is. Record should be read with a header that has the same definitions as the output header (see CVcfReader::CreateSampleHeader)
+    void AddRawRecord(bcf1_t* a_pRecord, SVcfChunk& a_rChunk) const;
+    
     ///Append the given variant to the opned vcf file for Mendelian Trio Mode
     void AddMendelianRecord(const SVcfRecord& a_rVcfRecord);
     
-    ///Close the VCF file
+    ///Close the VCF file. Compressed outputs are indexed (tabix for .vcf.gz, CSI for .bcf) after closing
     void CloseVcf();
   
     ///Add line to the header of vcf file
@@ -136,7 +185,40 @@ public:
 private:
     
     //Write info columns to the vcf record
-    void WriteInfoColumns(const SInfo* pInfo);
+    void WriteInfoColumns(const SInfo* pInfo, bcf1_t* a_pRecord) const;
+    
+    //Encode CHROM, POS, ID, QUAL, REF/ALT and FILTER columns directly into the shared buffer of the record
+    void EncodeSite(bcf1_t* a_pRecord,
+                    const std::string& a_rChrName,
+                    int a_nPosition,
+                    float a_fQuality,
+                    const std::string& a_rAlleles,
+                    const std::vector<std::string>& a_rFilters,
+                    std::vector<int32_t>& a_rBuffer) const;
+    
+    //Encode GT column of all samples into the individual buffer of the record. Missing samples are written as ./.
+    void EncodeGenotypes(bcf1_t* a_pRecord, const SPerSampleData* a_pSamples, int a_nSampleCount, std::vector<int32_t>& a_rBuffer) const;
+    
+    //Encode the given string field of the samples as a FORMAT column into the individual buffer of the record
+    void EncodeFormatString(bcf1_t* a_pRecord,
+                            int a_nKey,
+                            std::string SPerSampleData::* a_pField,
+                            const std::vector<SPerSampleData>& a_rSamples) const;
+    
+    //Fill the given htslib record with the variant. Buffer is the scratch space of integer columns
+    void EncodeRecord(const SVcfRecord& a_rVcfRecord, bcf1_t* a_pRecord, std::vector<int32_t>& a_rBuffer) const;
+    
+    //Fill the given htslib record with the variant for Mendelian Trio Mode
+    void EncodeMendelianRecord(const SVcfRecord& a_rVcfRecord, bcf1_t* a_pRecord, std::vector<int32_t>& a_rBuffer) const;
+    
+    //Append the given encoded record to the serialized data of the chunk
+    void AppendToChunk(bcf1_t* a_pRecord, SVcfChunk& a_rChunk) const;
+    
+    //Compress the next BGZF block of the pending lines of the chunk
+    void CompressChunkBlock(SVcfChunk& a_rChunk) const;
+    
+    //Build the index of the closed compressed output
+    void BuildIndex();
     
     ///Return the current time in YYYYMMDD format
     std::string GetTime();
@@ -150,6 +232,23 @@ private:
     
     //Stores sample count added
     int m_nSampleCount;
+    
+    //Output file format, BGZF compression level and number of compression threads
+    EVcfOutputFormat m_outputFormat;
+    int m_nCompressionLevel;
+    int m_nThreadCount;
+    
+    //Path of the created output file
+    std::string m_fileName;
+    
+    //Header ids of GT, BD, BK and MD tags (-1 if the tag is not in the header)
+    int m_nGenotypeKey;
+    int m_nDecisionKey;
+    int m_nMatchTypeKey;
+    int m_nMendelianDecisionKey;
+    
+    //Filter ids and genotypes of the record that is written by AddRecord/AddMendelianRecord
+    std::vector<int32_t> m_aEncodeBuffer;
 };
 
 
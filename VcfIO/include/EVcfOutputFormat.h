@@ -0,0 +1,38 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  EVcfOutputFormat.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _E_VCF_OUTPUT_FORMAT_H_
+#define _E_VCF_OUTPUT_FORMAT_H_
+
+/**
+ * @brief ENUM of file formats that CVcfWriter can generate
+ *
+ */
+enum EVcfOutputFormat
+{
+    eVCF_TEXT,  //Uncompressed vcf (.vcf)
+    eVCF_BGZF,  //Bgzip compressed vcf indexed with tabix (.vcf.gz + .tbi)
+    eBCF        //Compressed bcf indexed with CSI (.bcf + .csi)
+};
+
+#endif // _E_VCF_OUTPUT_FORMAT_H_
@@ -27,6 +27,7 @@
 #define _S_CONFIG_H_
 
 #include "Constants.h"
+#include "EVcfOutputFormat.h"
 
 /**
  * @brief Any configuration that will be used will be distributed over classes via this object
@@ -60,6 +61,13 @@ struct SConfig
     ///Output Mode
     const char* m_pOutputMode = "SPLIT";
     
+    ///File format of the output vcfs and BGZF compression level used for compressed formats
+    EVcfOutputFormat m_outputFormat = eVCF_TEXT;
+    int m_nCompressionLevel = DEFAULT_COMPRESSION_LEVEL;
+    
+    ///Write the original input records to the SPLIT outputs instead of re-encoding them
+    bool m_bIsPassThrough = false;
+    
     ///Comparison engine mode
     bool m_bIsGenotypeMatch = true;
     
@@ -76,6 +84,10 @@ struct SConfig
     //Threshold value of the variants
     float m_fQualityThreshold;
     
+    ///Enable ROC output. Score field is QUAL, INFO/<TAG> or FORMAT/<TAG> (value of the selected sample)
+    bool m_bIsRocEnabled = false;
+    const char* m_pRocScoreField = "QUAL";
+    
     ///If Base sample name choosing is enabled
     bool m_bBaseSampleEnabled = false;
     ///Name of the base sample to be selected
@@ -103,6 +115,20 @@ struct SConfig
     
     ///Enable generating syncpoint files which is the intermediate output of core module
     bool m_bGenerateSyncPoints = false;
+    ///Also export the sync points as text (chromosome, start, end per line)
+    bool m_bIsSyncPointTextEnabled = false;
+    
+    ///Enable stratified statistics. Stratification TSV contains <stratum_name> <bed_path> per line
+    bool m_bIsStratificationEnabled = false;
+    const char* m_pStratificationFile;
+    
+    ///Enable binary cache of parsed and trimmed variant lists. Cache files are stored under the given directory
+    bool m_bUseVariantCache = false;
+    const char* m_pVariantCacheDirectory;
+    
+    ///Enable memory mapped reference cache. The cache file of the FASTA is generated once under the given directory and shared by later runs
+    bool m_bUseReferenceCache = false;
+    const char* m_pReferenceCacheDirectory;
     
     ///Enable reading whole info format into a structure while parsing VCF file
     bool m_bIsReadINFO = false;
@@ -111,6 +137,9 @@ struct SConfig
     ///Number of thread to use during execution
     int m_nThreadCount = DEFAULT_THREAD_COUNT;
     
+    ///Size of the reference prefetch window of each thread in MB (0 disables prefetching)
+    int m_nPrefetchWindowSize = DEFAULT_PREFETCH_WINDOW_MB;
+    
     ///Maximum number of path that variant comparison core can store at a time [History Table for Dynamic Programming]
     int m_nMaxPathSize = DEFAULT_MAX_PATH_SIZE;
 
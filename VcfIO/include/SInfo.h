@@ -10,24 +10,44 @@
 #define _S_INFO_H_
 
 #include <vector>
+#include <string>
 
+/**
+ * @brief Header of a single INFO value stored in the info arena. Decoded values (n * element size bytes) follow the header
+ *
+ * Payloads are padded to 4 bytes so that int32/float values can be read in place by htslib
+ */
 struct SInfoEntry
 {
-    int n; //Len
-    int type; //Info Type
-    std::string key = ""; //Info Tag
-    void* values = NULL; //Data
+    int m_nKeyIndex; //Index of the tag in reader's info name list
+    int m_nType; //Info Type (BCF_HT_*)
+    int m_nCount; //Number of values (string length including null terminator for BCF_HT_STR)
+    int m_nByteSize; //Size of the payload including padding
 };
 
+/**
+ * @brief Lightweight view of the INFO columns of a variant.
+ *
+ * The decoded INFO values of all variants of a chromosome are stored contiguously in a byte arena owned by CVcfReader.
+ * SInfo only points to the slice of its record so copying variants does not copy/allocate any INFO data
+ */
 struct SInfo
 {
-    SInfo() {};
-    
-    SInfo(const SInfo& a_rInfo) {m_infoArray = std::vector<SInfoEntry>(a_rInfo.m_infoArray);};
-    
-    void Clear() {m_infoArray.clear();};
-    
-    std::vector<SInfoEntry> m_infoArray;
+    void Clear() {m_pArena = NULL; m_pKeys = NULL; m_nOffset = 0; m_nLength = 0;};
+
+    bool IsEmpty() const {return m_pArena == NULL || m_nLength == 0;};
+
+    //Per chromosome byte arena which contains the entries
+    const std::vector<char>* m_pArena = NULL;
+
+    //Tag names which are referred by SInfoEntry::m_nKeyIndex
+    const std::vector<std::string>* m_pKeys = NULL;
+
+    //Start of the slice of this record within the arena
+    unsigned int m_nOffset = 0;
+
+    //Byte length of the slice
+    unsigned int m_nLength = 0;
 };
 
 
@@ -0,0 +1,87 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  SSharedRecord.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _S_SHARED_RECORD_H_
+#define _S_SHARED_RECORD_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "SInfo.h"
+
+/**
+ * @brief Sample independent columns of a vcf record
+ *
+ * Used when a multi-sample vcf is decoded once for all samples. Variants of each sample are generated from the shared record and
+ * the genotype of the sample (see CVcfReader::FillSampleVariant)
+ */
+struct SSharedRecord
+{
+    ///Chromosome id of the record in the vcf header
+    int m_nChrId;
+    
+    ///0-based position of the record
+    int m_nPosition;
+    
+    ///QUAL column
+    float m_fQuality;
+    
+    ///True if the record has no filter or it contains the selected filter
+    bool m_bIsFilterPASS;
+    
+    ///Virtual offset of the record (-1 if it is read through a region iterator)
+    int64_t m_nFileOffset;
+    
+    ///REF and ALT alleles of the record
+    std::vector<std::string> m_alleles;
+    
+    ///FILTER column
+    std::vector<std::string> m_filterString;
+    
+    ///ID column
+    std::string m_variantID;
+    
+    ///Slice of the selected INFO columns in the info arena of the reader
+    SInfo m_info;
+};
+
+/**
+ * @brief Genotype of a single sample at a shared record
+ *
+ */
+struct SSampleGenotype
+{
+    ///Index of the shared record that genotype belongs to
+    int m_nRecordIndex;
+    
+    ///Allele indexes of the first two haplotypes (-1 for missing alleles)
+    int m_aGenotype[2];
+    
+    ///Ploidy of the sample at the record (alleles before the vector_end padding)
+    int m_nZygotCount;
+    
+    ///True if any of the alleles is phased
+    bool m_bIsPhased;
+};
+
+#endif // _S_SHARED_RECORD_H_
@@ -0,0 +1,50 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  SVariantSpan.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _S_VARIANT_SPAN_H_
+#define _S_VARIANT_SPAN_H_
+
+#include <vector>
+#include "CVariant.h"
+
+/**
+ * @brief Read-only view of the variants of a chromosome in a precomputed order
+ *
+ * The order is an index array into the variant list which is computed once at load time. Copying the span does not copy any variant or index
+ */
+struct SVariantSpan
+{
+    ///Return the number of variants in the span
+    unsigned int size() const {return m_pOrder == NULL ? 0 : static_cast<unsigned int>(m_pOrder->size());};
+    
+    ///Return the variant at the given position of the order
+    const CVariant* operator[](unsigned int a_nIndex) const {return &(*m_pVariants)[(*m_pOrder)[a_nIndex]];};
+    
+    //Variant list of the chromosome
+    const std::vector<CVariant>* m_pVariants = NULL;
+    
+    //Indexes of the variants in the variant list in the order of the span
+    const std::vector<unsigned int>* m_pOrder = NULL;
+};
+
+#endif // _S_VARIANT_SPAN_H_
@@ -28,8 +28,23 @@
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-bool CFastaParser::OpenFastaFile(const char *fn)
+namespace
+{
+    const char REFERENCE_CACHE_MAGIC[8] = {'V','B','T','R','E','F','0','2'};
+    
+    //Magic, FASTA size, FASTA modification time and contig count
+    const long long REFERENCE_CACHE_HEADER_SIZE = sizeof(REFERENCE_CACHE_MAGIC) + 2 * sizeof(long long) + sizeof(int);
+}
+
+bool CFastaParser::OpenFastaFile(const char *fn, const char* a_pCacheDirectory)
 {
     bool bIsSuccess = true;
     
@@ -41,6 +56,10 @@ bool CFastaParser::OpenFastaFile(const char *fn)
     if(fai == 0)
         bIsSuccess = false;
     
+    //Reference cache is optional. If it is not enabled or can not be generated, contigs are fetched by faidx
+    if(true == bIsSuccess && a_pCacheDirectory != NULL && !OpenReferenceCache(fn, a_pCacheDirectory))
+        std::cout << "Reference cache is not available for " << fn << ". Contigs will be read from FASTA." << std::endl;
+    
     return bIsSuccess;
 }
 
@@ -48,6 +67,195 @@ CFastaParser::~CFastaParser()
 {
     if(fai != 0)
         fai_destroy(fai);
+    if(m_pCache != 0)
+        munmap((void*)m_pCache, m_nCacheSize);
+}
+
+bool CFastaParser::OpenReferenceCache(const char *fn, const char* a_pCacheDirectory)
+{
+    std::string fastaName(fn);
+    size_t slashPos = fastaName.find_last_of('/');
+    if(slashPos != std::string::npos)
+        fastaName = fastaName.substr(slashPos + 1);
+    std::string cachePath = std::string(a_pCacheDirectory) + "/" + fastaName + ".vbtref";
+    
+    struct stat fastaStat;
+    if(stat(fn, &fastaStat) != 0)
+        return false;
+    
+    if(LoadReferenceCache(cachePath, fastaStat))
+        return true;
+    
+    std::cout << "Generating reference cache " << cachePath << "..." << std::endl;
+    if(!GenerateReferenceCache(cachePath, fastaStat))
+        return false;
+    
+    return LoadReferenceCache(cachePath, fastaStat);
+}
+
+bool CFastaParser::LoadReferenceCache(const std::string& a_rCachePath, const struct stat& a_rFastaStat)
+{
+    int fd = open(a_rCachePath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)REFERENCE_CACHE_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+    
+    void* pMapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(pMapped == MAP_FAILED)
+        return false;
+    
+    const char* pCache = static_cast<const char*>(pMapped);
+    const char* pCursor = pCache;
+    const char* pEnd = pCache + fileStat.st_size;
+    
+    long long fastaSize;
+    long long fastaModificationTime;
+    int contigCount;
+    bool bIsCurrent = memcmp(pCursor, REFERENCE_CACHE_MAGIC, sizeof(REFERENCE_CACHE_MAGIC)) == 0;
+    pCursor += sizeof(REFERENCE_CACHE_MAGIC);
+    memcpy(&fastaSize, pCursor, sizeof(long long));
+    pCursor += sizeof(long long);
+    memcpy(&fastaModificationTime, pCursor, sizeof(long long));
+    pCursor += sizeof(long long);
+    memcpy(&contigCount, pCursor, sizeof(int));
+    pCursor += sizeof(int);
+    
+    //Cache of an older format or of another version of the FASTA file is regenerated
+    bIsCurrent = bIsCurrent && fastaSize == (long long)a_rFastaStat.st_size && fastaModificationTime == (long long)a_rFastaStat.st_mtime;
+    if(!bIsCurrent)
+    {
+        munmap(pMapped, fileStat.st_size);
+        return false;
+    }
+    
+    //Read contig table
+    bool bIsValid = true;
+    for(int k = 0; k < contigCount && bIsValid; k++)
+    {
+        unsigned int nameLength;
+        SReferenceCacheEntry entry;
+        
+        if(pEnd - pCursor < (long)sizeof(unsigned int))
+        {
+            bIsValid = false;
+            break;
+        }
+        memcpy(&nameLength, pCursor, sizeof(unsigned int));
+        pCursor += sizeof(unsigned int);
+        
+        if(pEnd - pCursor < (long)(nameLength + sizeof(long long) + sizeof(int)))
+        {
+            bIsValid = false;
+            break;
+        }
+        std::string name(pCursor, nameLength);
+        pCursor += nameLength;
+        memcpy(&entry.m_nOffset, pCursor, sizeof(long long));
+        pCursor += sizeof(long long);
+        memcpy(&entry.m_nLength, pCursor, sizeof(int));
+        pCursor += sizeof(int);
+        
+        if(entry.m_nOffset + entry.m_nLength > (long long)fileStat.st_size)
+            bIsValid = false;
+        else
+            m_cacheEntries[name] = entry;
+    }
+    
+    if(!bIsValid)
+    {
+        std::cerr << "Reference cache is corrupted: " << a_rCachePath << std::endl;
+        munmap(pMapped, fileStat.st_size);
+        m_cacheEntries.clear();
+        return false;
+    }
+    
+    m_pCache = pCache;
+    m_nCacheSize = fileStat.st_size;
+    return true;
+}
+
+bool CFastaParser::GenerateReferenceCache(const std::string& a_rCachePath, const struct stat& a_rFastaStat)
+{
+    int contigCount = faidx_nseq(fai);
+    long long fastaSize = a_rFastaStat.st_size;
+    long long fastaModificationTime = a_rFastaStat.st_mtime;
+    
+    //Compute the size of the contig table to find the sequence offsets
+    long long offset = REFERENCE_CACHE_HEADER_SIZE;
+    for(int k = 0; k < contigCount; k++)
+        offset += sizeof(unsigned int) + strlen(faidx_iseq(fai, k)) + sizeof(long long) + sizeof(int);
+    
+    //Each run writes its own temporary file so that concurrent runs never mix their writes. The last rename wins
+    std::string tmpPath = a_rCachePath + ".XXXXXX";
+    std::vector<char> tmpPathBuffer(tmpPath.begin(), tmpPath.end());
+    tmpPathBuffer.push_back('\0');
+    int fd = mkstemp(tmpPathBuffer.data());
+    if(fd < 0)
+        return false;
+    tmpPath = tmpPathBuffer.data();
+    
+    //mkstemp creates the file only readable by the owner. The cache is shared by all runs
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    
+    FILE* pFile = fdopen(fd, "wb");
+    if(pFile == NULL)
+    {
+        close(fd);
+        remove(tmpPath.c_str());
+        return false;
+    }
+    
+    bool bIsSuccess = true;
+    bIsSuccess = bIsSuccess && fwrite(REFERENCE_CACHE_MAGIC, 1, sizeof(REFERENCE_CACHE_MAGIC), pFile) == sizeof(REFERENCE_CACHE_MAGIC);
+    bIsSuccess = bIsSuccess && fwrite(&fastaSize, sizeof(long long), 1, pFile) == 1;
+    bIsSuccess = bIsSuccess && fwrite(&fastaModificationTime, sizeof(long long), 1, pFile) == 1;
+    bIsSuccess = bIsSuccess && fwrite(&contigCount, sizeof(int), 1, pFile) == 1;
+    
+    for(int k = 0; k < contigCount && bIsSuccess; k++)
+    {
+        const char* pName = faidx_iseq(fai, k);
+        unsigned int nameLength = static_cast<unsigned int>(strlen(pName));
+        int length = faidx_seq_len(fai, pName);
+        
+        bIsSuccess = bIsSuccess && fwrite(&nameLength, sizeof(unsigned int), 1, pFile) == 1;
+        bIsSuccess = bIsSuccess && fwrite(pName, 1, nameLength, pFile) == nameLength;
+        bIsSuccess = bIsSuccess && fwrite(&offset, sizeof(long long), 1, pFile) == 1;
+        bIsSuccess = bIsSuccess && fwrite(&length, sizeof(int), 1, pFile) == 1;
+        offset += length;
+    }
+    
+    //Write sequences in the same order with the table
+    for(int k = 0; k < contigCount && bIsSuccess; k++)
+    {
+        const char* pName = faidx_iseq(fai, k);
+        int expectedLength = faidx_seq_len(fai, pName);
+        int length = 0;
+        char* pSequence = faidx_fetch_seq(fai, pName, 0, 0x7fffffff, &length);
+        
+        if(pSequence == NULL || length != expectedLength)
+            bIsSuccess = false;
+        else
+            bIsSuccess = fwrite(pSequence, 1, length, pFile) == (size_t)length;
+        
+        free(pSequence);
+    }
+    
+    bIsSuccess = (fclose(pFile) == 0) && bIsSuccess;
+    
+    if(bIsSuccess)
+        bIsSuccess = rename(tmpPath.c_str(), a_rCachePath.c_str()) == 0;
+    
+    if(!bIsSuccess)
+        remove(tmpPath.c_str());
+    
+    return bIsSuccess;
 }
 
 
@@ -81,11 +289,32 @@ bool CFastaParser::FetchNewChromosome(std::string chromosome, SContig& a_rContig
 {
     bool bIsSuccess = true;
     
+    a_rContig.m_chromosomeName = chromosome;
+    
+    //Return a shared view of the memory mapped cache. The table is read-only after opening so no lock is needed
+    if(m_pCache != 0)
+    {
+        auto it = m_cacheEntries.find(chromosome);
+        if(it == m_cacheEntries.end())
+        {
+            std::cout << "Specified chromosome" << chromosome  << " could not found in FASTA file" << std::endl;
+            a_rContig.m_nRefLength = -2;
+            return false;
+        }
+        
+        a_rContig.m_pRefSeq = m_pCache + it->second.m_nOffset;
+        a_rContig.m_nRefLength = it->second.m_nLength;
+        a_rContig.m_bIsShared = true;
+        return true;
+    }
+    
     char chrom_num[80] = {0};
     strcpy(chrom_num, chromosome.c_str());
-    a_rContig.m_chromosomeName = chromosome;
     
+    m_faidxMutex.lock();
     a_rContig.m_pRefSeq = faidx_fetch_seq(fai, chrom_num, 0, 0x7fffffff, &a_rContig.m_nRefLength);
+    m_faidxMutex.unlock();
+    a_rContig.m_bIsShared = false;
     
     if(a_rContig.m_nRefLength == -1)
     {
@@ -101,13 +330,39 @@ bool CFastaParser::FetchNewChromosome(std::string chromosome, SContig& a_rContig
     return bIsSuccess;
 }
 
+int CFastaParser::GetCachedContigLength(const std::string& a_rChromosome) const
+{
+    if(m_pCache == 0)
+        return -1;
+    
+    auto it = m_cacheEntries.find(a_rChromosome);
+    return it == m_cacheEntries.end() ? -1 : it->second.m_nLength;
+}
+
+bool CFastaParser::PrefetchChromosome(const std::string& a_rChromosome) const
+{
+    if(m_pCache == 0)
+        return false;
+    
+    auto it = m_cacheEntries.find(a_rChromosome);
+    if(it == m_cacheEntries.end())
+        return false;
+    
+    //madvise requires a page aligned start address
+    long long pageSize = sysconf(_SC_PAGESIZE);
+    long long alignedBegin = (it->second.m_nOffset / pageSize) * pageSize;
+    long long length = it->second.m_nOffset + it->second.m_nLength - alignedBegin;
+    
+    return 0 == madvise((void*)(m_pCache + alignedBegin), length, MADV_WILLNEED);
+}
+
 bool SContig::Clean()
 {
     bool bIsSuccess = true;
-    if(m_pRefSeq != NULL)
-        free(m_pRefSeq);
-    else
+    if(m_pRefSeq == NULL)
         bIsSuccess = false;
+    else if(!m_bIsShared)
+        free((void*)m_pRefSeq);
     
     m_pRefSeq = NULL;
     return bIsSuccess;
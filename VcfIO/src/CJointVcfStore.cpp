@@ -0,0 +1,139 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CJointVcfStore.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CJointVcfStore.h"
+#include "CSimpleBEDParser.h"
+#include <iostream>
+#include <algorithm>
+
+bool CJointVcfStore::Open(const char* a_pVcfPath, const std::vector<std::string>& a_rSampleNames)
+{
+    if(!m_vcfReader.Open(a_pVcfPath))
+    {
+        std::cerr << "Joint VCF file is unable to open!: " << a_pVcfPath << std::endl;
+        return false;
+    }
+    
+    if(!m_vcfReader.SelectSamples(a_rSampleNames))
+    {
+        std::cerr << "Samples could not be selected from the joint VCF: " << a_pVcfPath << std::endl;
+        return false;
+    }
+    
+    //Genotypes are returned in the sample order of the header
+    m_aSampleNames.clear();
+    m_vcfReader.GetSampleNames(m_aSampleNames);
+    m_aSampleGenotypes = std::vector<std::vector<SSampleGenotype>>(m_aSampleNames.size());
+    
+    return true;
+}
+
+bool CJointVcfStore::SetRegions(const CSimpleBEDParser& a_rBedParser)
+{
+    return m_vcfReader.SetRegions(a_rBedParser);
+}
+
+bool CJointVcfStore::Load(const SConfig& a_rConfig)
+{
+    if(true == a_rConfig.m_bIsReadINFO)
+        m_vcfReader.GetInfoNames(a_rConfig.m_infotags);
+    
+    SSharedRecord record;
+    std::vector<SSampleGenotype> genotypes;
+    int recordCount = 0;
+    
+    while(m_vcfReader.GetNextSharedRecord(record, genotypes, a_rConfig))
+    {
+        recordCount++;
+        bool bIsStored = false;
+        
+        for(unsigned int sample = 0; sample < genotypes.size(); sample++)
+        {
+            SSampleGenotype& rGenotype = genotypes[sample];
+            int ploidy = std::min(rGenotype.m_nZygotCount, 2);
+            
+            //Homozygous reference genotypes are eliminated by the variant providers, they are not stored (No calls are kept)
+            bool bIsAllMissing = true;
+            bool bHasAlt = false;
+            for(int k = 0; k < ploidy; k++)
+            {
+                bIsAllMissing = bIsAllMissing && rGenotype.m_aGenotype[k] == -1;
+                bHasAlt = bHasAlt || rGenotype.m_aGenotype[k] > 0;
+            }
+            
+            if(!bIsAllMissing && !bHasAlt)
+                continue;
+            
+            rGenotype.m_nRecordIndex = static_cast<int>(m_aRecords.size());
+            m_aSampleGenotypes[sample].push_back(rGenotype);
+            bIsStored = true;
+        }
+        
+        if(bIsStored)
+        {
+            if(true == a_rConfig.m_bIsReadINFO)
+                m_vcfReader.ReadSharedRecordInfo(record);
+            m_aRecords.push_back(record);
+        }
+    }
+    
+    m_aRecords.shrink_to_fit();
+    for(std::vector<SSampleGenotype>& rGenotypes : m_aSampleGenotypes)
+        rGenotypes.shrink_to_fit();
+    
+    std::cerr << "[stderr] Joint VCF is decoded: " << recordCount << " records, " << m_aRecords.size() << " records are kept for " << m_aSampleNames.size() << " samples" << std::endl;
+    
+    return true;
+}
+
+int CJointVcfStore::GetSampleIndex(const std::string& a_rSampleName) const
+{
+    for(unsigned int k = 0; k < m_aSampleNames.size(); k++)
+    {
+        if(m_aSampleNames[k] == a_rSampleName)
+            return static_cast<int>(k);
+    }
+    return -1;
+}
+
+int CJointVcfStore::GetGenotypeCount(int a_nSampleIndex) const
+{
+    return static_cast<int>(m_aSampleGenotypes[a_nSampleIndex].size());
+}
+
+bool CJointVcfStore::GetSampleVariant(int a_nSampleIndex, int a_nGenotypeIndex, int a_nId, const SConfig& a_rConfig, CVariant* a_pVariant) const
+{
+    const std::vector<SSampleGenotype>& rGenotypes = m_aSampleGenotypes[a_nSampleIndex];
+    
+    if(a_nGenotypeIndex >= static_cast<int>(rGenotypes.size()))
+        return false;
+    
+    const SSampleGenotype& rGenotype = rGenotypes[a_nGenotypeIndex];
+    m_vcfReader.FillSampleVariant(m_aRecords[rGenotype.m_nRecordIndex], rGenotype, a_nId, a_rConfig, a_pVariant);
+    return true;
+}
+
+void CJointVcfStore::ReleaseSample(int a_nSampleIndex)
+{
+    std::vector<SSampleGenotype>().swap(m_aSampleGenotypes[a_nSampleIndex]);
+}
@@ -0,0 +1,107 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CParallelVcfSerializer.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CParallelVcfSerializer.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void CParallelVcfSerializer::Run(int a_nJobCount,
+                                 int a_nThreadCount,
+                                 const std::function<void(int, SVcfChunk&)>& a_rSerializeFunction,
+                                 const std::function<void(int, SVcfChunk&)>& a_rWriteFunction)
+{
+    int threadCount = std::min(a_nThreadCount, a_nJobCount);
+    
+    //Nothing to parallelize
+    if(threadCount <= 1)
+    {
+        for(int k = 0; k < a_nJobCount; k++)
+        {
+            SVcfChunk chunk;
+            a_rSerializeFunction(k, chunk);
+            a_rWriteFunction(k, chunk);
+        }
+        return;
+    }
+    
+    //Number of jobs that workers can serialize ahead of the writer
+    const int windowSize = 2 * threadCount;
+    
+    std::vector<SVcfChunk> chunks(a_nJobCount);
+    std::vector<bool> isReady(a_nJobCount, false);
+    std::atomic<int> nextJob(0);
+    int nextJobToWrite = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+    
+    auto worker = [&]()
+    {
+        while(true)
+        {
+            int job = nextJob++;
+            if(job >= a_nJobCount)
+                break;
+            
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&](){ return job < nextJobToWrite + windowSize; });
+            }
+            
+            a_rSerializeFunction(job, chunks[job]);
+            
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                isReady[job] = true;
+            }
+            cv.notify_all();
+        }
+    };
+    
+    std::vector<std::thread> threadPool;
+    for(int k = 0; k < threadCount; k++)
+        threadPool.push_back(std::thread(worker));
+    
+    //Write the chunks in order as they are completed
+    for(int k = 0; k < a_nJobCount; k++)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&](){ return isReady[k]; });
+        }
+        
+        a_rWriteFunction(k, chunks[k]);
+        
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            nextJobToWrite = k + 1;
+        }
+        cv.notify_all();
+    }
+    
+    for(unsigned int k = 0; k < threadPool.size(); k++)
+        threadPool[k].join();
+}
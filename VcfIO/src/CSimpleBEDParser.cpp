@@ -27,6 +27,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 bool CSimpleBEDParser::InitBEDFile(const std::string& a_rBEDFilePath)
 {
@@ -78,6 +79,8 @@ bool CSimpleBEDParser::InitBEDFile(const std::string& a_rBEDFilePath)
     }
         
     bedFile.close();
+    
+    MergeRegions();
 
     //Specify the total contig count
     m_nTotalContigCount = 0;
@@ -87,6 +90,33 @@ bool CSimpleBEDParser::InitBEDFile(const std::string& a_rBEDFilePath)
     return bIsSuccess;
 }
 
+void CSimpleBEDParser::MergeRegions()
+{
+    for (auto it = m_regionMap.begin(); it != m_regionMap.end(); ++it)
+    {
+        std::vector<SBedRegion>& regions = it->second;
+        std::sort(regions.begin(), regions.end(), [](const SBedRegion& r1, const SBedRegion& r2){return r1.m_nStartPos < r2.m_nStartPos;});
+        
+        std::vector<SBedRegion> mergedRegions;
+        for(const SBedRegion& region : regions)
+        {
+            if(mergedRegions.size() > 0 && region.m_nStartPos <= mergedRegions.back().m_nEndPos)
+                mergedRegions.back().m_nEndPos = std::max(mergedRegions.back().m_nEndPos, region.m_nEndPos);
+            else
+                mergedRegions.push_back(region);
+        }
+        
+        regions.swap(mergedRegions);
+    }
+}
 
-
-
+const std::vector<SBedRegion>& CSimpleBEDParser::GetRegions(const std::string& a_rChrName) const
+{
+    static const std::vector<SBedRegion> emptyRegions;
+    
+    auto it = m_regionMap.find(a_rChrName);
+    if(it == m_regionMap.end())
+        return emptyRegions;
+    else
+        return it->second;
+}
@@ -165,3 +165,33 @@ std::vector<std::string> CSimplePEDParser::GetIdsMFC(const std::string& id1, con
     return res;
 }
 
+std::vector<SFamilyTrio> CSimplePEDParser::GetTrios(const std::vector<std::string>& a_rSampleNames) const
+{
+    std::vector<SFamilyTrio> trios;
+    
+    for (auto it = m_familyMap.begin(); it != m_familyMap.end(); ++it )
+    {
+        for(const SPerson& person : it->second)
+        {
+            if(std::find(a_rSampleNames.begin(), a_rSampleNames.end(), person.m_id) == a_rSampleNames.end()
+               || std::find(a_rSampleNames.begin(), a_rSampleNames.end(), person.m_fatherId) == a_rSampleNames.end()
+               || std::find(a_rSampleNames.begin(), a_rSampleNames.end(), person.m_motherId) == a_rSampleNames.end())
+                continue;
+            
+            SFamilyTrio trio;
+            trio.m_familyId = it->first;
+            trio.m_motherId = person.m_motherId;
+            trio.m_fatherId = person.m_fatherId;
+            trio.m_childId = person.m_id;
+            trios.push_back(trio);
+        }
+    }
+    
+    //Family map is unordered, sort the trios so that output order does not depend on hashing
+    std::sort(trios.begin(), trios.end(), [](const SFamilyTrio& t1, const SFamilyTrio& t2)
+              {
+                  return t1.m_familyId != t2.m_familyId ? t1.m_familyId < t2.m_familyId : t1.m_childId < t2.m_childId;
+              });
+    
+    return trios;
+}
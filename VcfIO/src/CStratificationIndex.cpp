@@ -0,0 +1,190 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CStratificationIndex.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CStratificationIndex.h"
+#include "CSimpleBEDParser.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+bool CStratificationIndex::Init(const std::string& a_rStratificationFilePath)
+{
+    std::ifstream stratificationFile(a_rStratificationFilePath.c_str());
+    if(!stratificationFile.is_open())
+    {
+        std::cerr << "Stratification file cannot be opened: " << a_rStratificationFilePath << std::endl;
+        return false;
+    }
+    
+    //Relative BED paths are resolved from the directory of the TSV file
+    std::size_t slashPos = a_rStratificationFilePath.find_last_of('/');
+    std::string baseDirectory = slashPos == std::string::npos ? "" : a_rStratificationFilePath.substr(0, slashPos + 1);
+    
+    //Merged regions of each contig per stratum
+    std::unordered_map<std::string, std::vector<std::vector<std::pair<int,int>>>> regionsPerContig;
+    
+    std::string line;
+    while(std::getline(stratificationFile, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        
+        std::size_t tabPos = line.find('\t');
+        if(tabPos == std::string::npos)
+        {
+            std::cerr << "Invalid stratification line (expected <name><TAB><bed_path>): " << line << std::endl;
+            return false;
+        }
+        
+        std::string stratumName = line.substr(0, tabPos);
+        std::string bedPath = line.substr(tabPos + 1);
+        while(!bedPath.empty() && (bedPath.back() == '\r' || bedPath.back() == ' ' || bedPath.back() == '\t'))
+            bedPath.pop_back();
+        if(!bedPath.empty() && bedPath[0] != '/')
+            bedPath = baseDirectory + bedPath;
+        
+        std::ifstream bedFile(bedPath.c_str());
+        if(!bedFile.is_open())
+        {
+            std::cerr << "BED file of stratum " << stratumName << " cannot be opened: " << bedPath << std::endl;
+            return false;
+        }
+        bedFile.close();
+        
+        CSimpleBEDParser bedParser;
+        if(!bedParser.InitBEDFile(bedPath))
+        {
+            std::cerr << "BED file of stratum " << stratumName << " cannot be parsed: " << bedPath << std::endl;
+            return false;
+        }
+        
+        int stratumId = static_cast<int>(m_aStratumNames.size());
+        m_aStratumNames.push_back(stratumName);
+        
+        for(auto it = bedParser.m_regionMap.begin(); it != bedParser.m_regionMap.end(); ++it)
+        {
+            std::vector<std::vector<std::pair<int,int>>>& contigRegions = regionsPerContig[it->first];
+            contigRegions.resize(stratumId + 1);
+            for(const SBedRegion& region : it->second)
+            {
+                if(region.m_nStartPos < region.m_nEndPos)
+                    contigRegions[stratumId].push_back(std::make_pair(region.m_nStartPos, region.m_nEndPos));
+            }
+        }
+    }
+    
+    if(m_aStratumNames.empty())
+    {
+        std::cerr << "Stratification file does not contain any stratum: " << a_rStratificationFilePath << std::endl;
+        return false;
+    }
+    
+    for(auto it = regionsPerContig.begin(); it != regionsPerContig.end(); ++it)
+        BuildContigIndex(it->first, it->second);
+    
+    return true;
+}
+
+void CStratificationIndex::BuildContigIndex(const std::string& a_rChrName, const std::vector<std::vector<std::pair<int,int>>>& a_rRegions)
+{
+    //Region boundary events (position, stratum id, is start)
+    struct SEvent
+    {
+        int m_nPosition;
+        int m_nStratumId;
+        bool m_bIsStart;
+    };
+    
+    std::vector<SEvent> events;
+    for(unsigned int stratumId = 0; stratumId < a_rRegions.size(); stratumId++)
+    {
+        for(const std::pair<int,int>& region : a_rRegions[stratumId])
+        {
+            events.push_back({region.first, static_cast<int>(stratumId), true});
+            events.push_back({region.second, static_cast<int>(stratumId), false});
+        }
+    }
+    
+    if(events.empty())
+        return;
+    
+    std::sort(events.begin(), events.end(), [](const SEvent& l, const SEvent& r){ return l.m_nPosition < r.m_nPosition; });
+    
+    SStratifiedContig& contig = m_contigMap[a_rChrName];
+    
+    //Regions of a stratum are merged, so a stratum never ends and starts at the same breakpoint
+    std::vector<int> activeStrata;
+    unsigned int eventIt = 0;
+    while(eventIt < events.size())
+    {
+        int breakpoint = events[eventIt].m_nPosition;
+        for(; eventIt < events.size() && events[eventIt].m_nPosition == breakpoint; eventIt++)
+        {
+            auto pos = std::lower_bound(activeStrata.begin(), activeStrata.end(), events[eventIt].m_nStratumId);
+            if(events[eventIt].m_bIsStart)
+                activeStrata.insert(pos, events[eventIt].m_nStratumId);
+            else
+                activeStrata.erase(pos);
+        }
+        
+        contig.m_aBreakpoints.push_back(breakpoint);
+        contig.m_aSegmentOffsets.push_back(static_cast<int>(contig.m_aStrata.size()));
+        contig.m_aStrata.insert(contig.m_aStrata.end(), activeStrata.begin(), activeStrata.end());
+    }
+    
+    //Segment after the last breakpoint is always empty. Close the offset list
+    contig.m_aSegmentOffsets.push_back(static_cast<int>(contig.m_aStrata.size()));
+}
+
+int CStratificationIndex::GetStratumCount() const
+{
+    return static_cast<int>(m_aStratumNames.size());
+}
+
+const std::string& CStratificationIndex::GetStratumName(int a_nStratumId) const
+{
+    return m_aStratumNames[a_nStratumId];
+}
+
+const SStratifiedContig* CStratificationIndex::GetContig(const std::string& a_rChrName) const
+{
+    auto it = m_contigMap.find(a_rChrName);
+    if(it == m_contigMap.end())
+        return NULL;
+    else
+        return &it->second;
+}
+
+void CStratificationIndex::GetStrata(const SStratifiedContig& a_rContig, int a_nPosition, const int*& a_rpBegin, const int*& a_rpEnd)
+{
+    a_rpBegin = a_rpEnd = NULL;
+    
+    auto it = std::upper_bound(a_rContig.m_aBreakpoints.begin(), a_rContig.m_aBreakpoints.end(), a_nPosition);
+    if(it == a_rContig.m_aBreakpoints.begin())
+        return;
+    
+    int segmentId = static_cast<int>(it - a_rContig.m_aBreakpoints.begin()) - 1;
+    const int* pStrata = a_rContig.m_aStrata.data();
+    a_rpBegin = pStrata + a_rContig.m_aSegmentOffsets[segmentId];
+    a_rpEnd = pStrata + a_rContig.m_aSegmentOffsets[segmentId + 1];
+}
@@ -0,0 +1,260 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CSyncIntervalFile.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CSyncIntervalFile.h"
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    //Increment whenever the file layout changes
+    const uint32_t SYNC_INTERVAL_FILE_VERSION = 1;
+    const char SYNC_INTERVAL_FILE_MAGIC[8] = {'V','B','T','S','Y','N','C','\0'};
+    const uint64_t SYNC_INTERVAL_HEADER_SIZE = sizeof(SYNC_INTERVAL_FILE_MAGIC) + sizeof(uint32_t);
+    
+    template<typename T>
+    bool ReadPod(const char*& a_rpCursor, const char* a_pEnd, T& a_rValue)
+    {
+        if(a_pEnd - a_rpCursor < (long)sizeof(T))
+            return false;
+        memcpy(&a_rValue, a_rpCursor, sizeof(T));
+        a_rpCursor += sizeof(T);
+        return true;
+    }
+    
+    template<typename T>
+    void WritePod(std::string& a_rBuffer, const T& a_rValue)
+    {
+        a_rBuffer.append(reinterpret_cast<const char*>(&a_rValue), sizeof(T));
+    }
+}
+
+CSyncIntervalFile::CSyncIntervalFile()
+{
+    m_pFile = NULL;
+    m_nWriteOffset = 0;
+    m_pMapped = NULL;
+    m_nMappedSize = 0;
+}
+
+CSyncIntervalFile::~CSyncIntervalFile()
+{
+    Close();
+}
+
+bool CSyncIntervalFile::Create(const std::string& a_rFilePath)
+{
+    Close();
+    
+    m_pFile = fopen(a_rFilePath.c_str(), "wb");
+    if(m_pFile == NULL)
+    {
+        std::cerr << "Unable to create sync interval file: " << a_rFilePath << std::endl;
+        return false;
+    }
+    
+    std::string header(SYNC_INTERVAL_FILE_MAGIC, sizeof(SYNC_INTERVAL_FILE_MAGIC));
+    WritePod(header, SYNC_INTERVAL_FILE_VERSION);
+    m_nWriteOffset = header.size();
+    
+    return fwrite(header.data(), 1, header.size(), m_pFile) == header.size();
+}
+
+bool CSyncIntervalFile::WriteContig(const std::string& a_rChrName, const std::vector<SSyncInterval>& a_rIntervals)
+{
+    if(m_pFile == NULL)
+        return false;
+    
+    SContigEntry entry;
+    entry.m_name = a_rChrName;
+    entry.m_nOffset = m_nWriteOffset;
+    entry.m_nCount = a_rIntervals.size();
+    m_contigs.push_back(entry);
+    
+    if(a_rIntervals.empty())
+        return true;
+    
+    m_nWriteOffset += a_rIntervals.size() * sizeof(SSyncInterval);
+    return fwrite(a_rIntervals.data(), sizeof(SSyncInterval), a_rIntervals.size(), m_pFile) == a_rIntervals.size();
+}
+
+bool CSyncIntervalFile::Close()
+{
+    bool bIsSuccess = true;
+    
+    if(m_pFile != NULL)
+    {
+        //Contig index and its offset are written at the end
+        std::string index;
+        WritePod(index, static_cast<uint32_t>(m_contigs.size()));
+        for(const SContigEntry& entry : m_contigs)
+        {
+            WritePod(index, static_cast<uint32_t>(entry.m_name.length()));
+            index.append(entry.m_name);
+            WritePod(index, entry.m_nOffset);
+            WritePod(index, entry.m_nCount);
+        }
+        WritePod(index, m_nWriteOffset);
+        
+        bIsSuccess = fwrite(index.data(), 1, index.size(), m_pFile) == index.size();
+        bIsSuccess = (fclose(m_pFile) == 0) && bIsSuccess;
+        m_pFile = NULL;
+        
+        if(!bIsSuccess)
+            std::cerr << "A problem occured with saving the sync interval file." << std::endl;
+    }
+    
+    if(m_pMapped != NULL)
+    {
+        munmap(const_cast<char*>(m_pMapped), m_nMappedSize);
+        m_pMapped = NULL;
+        m_nMappedSize = 0;
+    }
+    
+    m_contigs.clear();
+    m_nWriteOffset = 0;
+    return bIsSuccess;
+}
+
+bool CSyncIntervalFile::IsSyncIntervalFile(const std::string& a_rFilePath)
+{
+    FILE* pFile = fopen(a_rFilePath.c_str(), "rb");
+    if(pFile == NULL)
+        return false;
+    
+    char magic[sizeof(SYNC_INTERVAL_FILE_MAGIC)];
+    bool bIsSyncFile = fread(magic, 1, sizeof(magic), pFile) == sizeof(magic) && memcmp(magic, SYNC_INTERVAL_FILE_MAGIC, sizeof(magic)) == 0;
+    fclose(pFile);
+    return bIsSyncFile;
+}
+
+bool CSyncIntervalFile::Open(const std::string& a_rFilePath)
+{
+    Close();
+    
+    int fd = open(a_rFilePath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)(SYNC_INTERVAL_HEADER_SIZE + sizeof(uint64_t)))
+    {
+        close(fd);
+        return false;
+    }
+    
+    void* pMapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(pMapped == MAP_FAILED)
+        return false;
+    
+    m_pMapped = static_cast<const char*>(pMapped);
+    m_nMappedSize = fileStat.st_size;
+    
+    if(!ReadIndex())
+    {
+        std::cerr << "Invalid sync interval file: " << a_rFilePath << std::endl;
+        Close();
+        return false;
+    }
+    
+    return true;
+}
+
+bool CSyncIntervalFile::ReadIndex()
+{
+    const char* pCursor = m_pMapped;
+    const char* pEnd = m_pMapped + m_nMappedSize;
+    
+    char magic[sizeof(SYNC_INTERVAL_FILE_MAGIC)];
+    uint32_t version;
+    if(!ReadPod(pCursor, pEnd, magic) || memcmp(magic, SYNC_INTERVAL_FILE_MAGIC, sizeof(magic)) != 0)
+        return false;
+    if(!ReadPod(pCursor, pEnd, version) || version != SYNC_INTERVAL_FILE_VERSION)
+        return false;
+    
+    //Offset of the index is stored at the end of the file
+    uint64_t indexOffset;
+    const char* pFooter = pEnd - sizeof(uint64_t);
+    if(!ReadPod(pFooter, pEnd, indexOffset) || indexOffset < SYNC_INTERVAL_HEADER_SIZE || indexOffset > m_nMappedSize - sizeof(uint64_t))
+        return false;
+    
+    pCursor = m_pMapped + indexOffset;
+    pEnd = m_pMapped + m_nMappedSize - sizeof(uint64_t);
+    
+    uint32_t contigCount;
+    if(!ReadPod(pCursor, pEnd, contigCount))
+        return false;
+    
+    for(uint32_t k = 0; k < contigCount; k++)
+    {
+        SContigEntry entry;
+        uint32_t nameLength;
+        if(!ReadPod(pCursor, pEnd, nameLength) || pEnd - pCursor < (long)nameLength)
+            return false;
+        entry.m_name.assign(pCursor, nameLength);
+        pCursor += nameLength;
+        
+        if(!ReadPod(pCursor, pEnd, entry.m_nOffset) || !ReadPod(pCursor, pEnd, entry.m_nCount))
+            return false;
+        
+        //Records of the contig should be inside the record section
+        if(entry.m_nOffset < SYNC_INTERVAL_HEADER_SIZE || entry.m_nOffset + entry.m_nCount * sizeof(SSyncInterval) > indexOffset)
+            return false;
+        
+        m_contigs.push_back(entry);
+    }
+    
+    return true;
+}
+
+std::vector<std::string> CSyncIntervalFile::GetContigNames() const
+{
+    std::vector<std::string> names;
+    for(const SContigEntry& entry : m_contigs)
+        names.push_back(entry.m_name);
+    return names;
+}
+
+bool CSyncIntervalFile::GetIntervals(const std::string& a_rChrName, const SSyncInterval*& a_rpIntervals, unsigned int& a_rCount) const
+{
+    if(m_pMapped == NULL)
+        return false;
+    
+    for(const SContigEntry& entry : m_contigs)
+    {
+        if(entry.m_name == a_rChrName)
+        {
+            //Records start right after the 12 byte header, so they are 4 byte aligned in the mapped file
+            a_rpIntervals = reinterpret_cast<const SSyncInterval*>(m_pMapped + entry.m_nOffset);
+            a_rCount = static_cast<unsigned int>(entry.m_nCount);
+            return true;
+        }
+    }
+    
+    return false;
+}
@@ -0,0 +1,111 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CTaskScheduler.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CTaskScheduler.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+CTaskScheduler::CTaskScheduler(const std::vector<double>& a_rTaskCosts, int a_nThreadCount)
+{
+    m_nThreadCount = std::max(1, std::min(a_nThreadCount, static_cast<int>(a_rTaskCosts.size())));
+    
+    for(int k = 0; k < m_nThreadCount; k++)
+        m_aQueues.push_back(std::unique_ptr<SWorkerQueue>(new SWorkerQueue()));
+    
+    //Largest tasks first. Equal costs keep the task order
+    std::vector<int> taskOrder(a_rTaskCosts.size());
+    std::iota(taskOrder.begin(), taskOrder.end(), 0);
+    std::stable_sort(taskOrder.begin(), taskOrder.end(), [&a_rTaskCosts](int l, int r){ return a_rTaskCosts[l] > a_rTaskCosts[r]; });
+    
+    //Each task goes to the least loaded worker
+    std::vector<double> workerLoads(m_nThreadCount, 0.0);
+    for(int task : taskOrder)
+    {
+        int worker = static_cast<int>(std::min_element(workerLoads.begin(), workerLoads.end()) - workerLoads.begin());
+        workerLoads[worker] += a_rTaskCosts[task];
+        m_aQueues[worker]->m_aTasks.push_back(task);
+    }
+}
+
+double CTaskScheduler::EstimateCost(int a_nVariantCount, int a_nSpanLength)
+{
+    double density = static_cast<double>(a_nVariantCount) * 1000.0 / static_cast<double>(std::max(1, a_nSpanLength));
+    return static_cast<double>(a_nVariantCount) * (1.0 + density);
+}
+
+void CTaskScheduler::Run(const std::function<void(int, int)>& a_rTaskFunction)
+{
+    std::vector<std::thread> threads;
+    for(int k = 1; k < m_nThreadCount; k++)
+        threads.push_back(std::thread(&CTaskScheduler::Work, this, k, std::cref(a_rTaskFunction)));
+    
+    Work(0, a_rTaskFunction);
+    
+    for(std::thread& t : threads)
+        t.join();
+}
+
+std::vector<int> CTaskScheduler::GetQueuedTasks(int a_nWorkerId) const
+{
+    SWorkerQueue& queue = *m_aQueues[a_nWorkerId];
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    return std::vector<int>(queue.m_aTasks.begin(), queue.m_aTasks.end());
+}
+
+bool CTaskScheduler::PopTask(int a_nWorkerId, int& a_rTask)
+{
+    SWorkerQueue& queue = *m_aQueues[a_nWorkerId];
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    if(queue.m_aTasks.empty())
+        return false;
+    
+    a_rTask = queue.m_aTasks.front();
+    queue.m_aTasks.pop_front();
+    return true;
+}
+
+bool CTaskScheduler::StealTask(int a_nWorkerId, int& a_rTask)
+{
+    for(int k = 1; k < m_nThreadCount; k++)
+    {
+        SWorkerQueue& victim = *m_aQueues[(a_nWorkerId + k) % m_nThreadCount];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        if(victim.m_aTasks.empty())
+            continue;
+        
+        a_rTask = victim.m_aTasks.back();
+        victim.m_aTasks.pop_back();
+        return true;
+    }
+    
+    return false;
+}
+
+void CTaskScheduler::Work(int a_nWorkerId, const std::function<void(int, int)>& a_rTaskFunction)
+{
+    //No task is added while running, so the work is done when all queues are empty
+    int task;
+    while(PopTask(a_nWorkerId, task) || StealTask(a_nWorkerId, task))
+        a_rTaskFunction(task, a_nWorkerId);
+}
@@ -26,6 +26,7 @@
 #include "CVariant.h"
 #include <iostream>
 #include <sstream>
+#include <cmath>
 #include "Constants.h"
 
 
@@ -49,6 +50,8 @@ CVariant::CVariant(): m_nVcfId(-1),
     m_bHaveMultipleTrimOption = false;
     m_variantIDfromVcf = "";
     m_fQuality = 0.0f;
+    m_fScore = NAN;
+    m_nFileOffset = -1;
 }
 
 CVariant::CVariant(const CVariant& a_rObj)
@@ -79,6 +82,8 @@ CVariant::CVariant(const CVariant& a_rObj)
     m_bHaveMultipleTrimOption = a_rObj.m_bHaveMultipleTrimOption;
     
     m_fQuality = a_rObj.m_fQuality;
+    m_fScore = a_rObj.m_fScore;
+    m_nFileOffset = a_rObj.m_nFileOffset;
     m_info = a_rObj.m_info;
     m_filterString = a_rObj.m_filterString;
     m_allelesStr = a_rObj.m_allelesStr;
@@ -115,6 +120,8 @@ bool CVariant::Clear()
     m_variantStatus = eNOT_ASSESSED;
     m_nOriginalPos = -1;
     m_fQuality = 0.0f;
+    m_fScore = NAN;
+    m_nFileOffset = -1;
     m_alleles[0].m_bIsIgnored = false;
     m_alleles[1].m_bIsIgnored = false;
     m_alleles[0].m_bIsTrimmed = false;
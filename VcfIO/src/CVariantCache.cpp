@@ -0,0 +1,356 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CVariantCache.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CVariantCache.h"
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <zlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    //Increment whenever the serialized CVariant layout changes
+    const uint32_t VARIANT_CACHE_VERSION = 3;
+    const char VARIANT_CACHE_MAGIC[8] = {'V','B','T','C','A','C','H','E'};
+
+    template<typename T>
+    void WritePod(std::string& a_rBuffer, const T& a_rValue)
+    {
+        a_rBuffer.append(reinterpret_cast<const char*>(&a_rValue), sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadPod(const char*& a_rpCursor, const char* a_pEnd, T& a_rValue)
+    {
+        if(a_pEnd - a_rpCursor < (long)sizeof(T))
+            return false;
+        memcpy(&a_rValue, a_rpCursor, sizeof(T));
+        a_rpCursor += sizeof(T);
+        return true;
+    }
+
+    void WriteString(std::string& a_rBuffer, const std::string& a_rValue)
+    {
+        WritePod(a_rBuffer, static_cast<uint32_t>(a_rValue.length()));
+        a_rBuffer.append(a_rValue);
+    }
+
+    bool ReadString(const char*& a_rpCursor, const char* a_pEnd, std::string& a_rValue)
+    {
+        uint32_t length;
+        if(!ReadPod(a_rpCursor, a_pEnd, length) || a_pEnd - a_rpCursor < (long)length)
+            return false;
+        a_rValue.assign(a_rpCursor, length);
+        a_rpCursor += length;
+        return true;
+    }
+}
+
+bool CVariantCache::GetFileChecksum(const char* a_pFilePath, unsigned long& a_rChecksum, long long& a_rFileSize)
+{
+    FILE* pFile = fopen(a_pFilePath, "rb");
+    if(pFile == NULL)
+        return false;
+
+    std::vector<unsigned char> buffer(1 << 20);
+    a_rChecksum = crc32(0L, Z_NULL, 0);
+    a_rFileSize = 0;
+
+    size_t readSize;
+    while((readSize = fread(&buffer[0], 1, buffer.size(), pFile)) > 0)
+    {
+        a_rChecksum = crc32(a_rChecksum, &buffer[0], static_cast<uInt>(readSize));
+        a_rFileSize += readSize;
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+std::string CVariantCache::GenerateKey(const char* a_pVcfPath, const std::string& a_rSampleName, const SConfig& a_rConfig)
+{
+    unsigned long checksum;
+    long long fileSize;
+    std::stringstream key;
+
+    if(!GetFileChecksum(a_pVcfPath, checksum, fileSize))
+        return "";
+
+    key << "vcf=" << std::hex << checksum << std::dec << ":" << fileSize;
+    key << ";sample=" << a_rSampleName;
+    key << ";refoverlap=" << a_rConfig.m_bIsRefOverlap;
+    key << ";trimbegin=" << a_rConfig.m_bTrimBeginningFirst;
+    key << ";maxbp=" << a_rConfig.m_nMaxVariantSize;
+    key << ";filter=" << (a_rConfig.m_bIsFilterEnabled ? a_rConfig.m_pFilterName : "none");
+    key << ";snponly=" << a_rConfig.m_bSNPOnly;
+    key << ";indelonly=" << a_rConfig.m_bINDELOnly;
+    key << ";score=" << (a_rConfig.m_bIsRocEnabled ? a_rConfig.m_pRocScoreField : "none");
+
+    //BED regions filters the variants so they are part of the key as well
+    if(true == a_rConfig.m_bInitializeFromBed)
+    {
+        if(!GetFileChecksum(a_rConfig.m_pBedFileName, checksum, fileSize))
+            return "";
+        key << ";bed=" << std::hex << checksum << std::dec << ":" << fileSize;
+    }
+
+    return key.str();
+}
+
+std::string CVariantCache::GetCachePath(const char* a_pCacheDirectory, const char* a_pVcfPath, const std::string& a_rSampleName)
+{
+    std::string vcfName(a_pVcfPath);
+    std::size_t slashPos = vcfName.find_last_of('/');
+    if(slashPos != std::string::npos)
+        vcfName = vcfName.substr(slashPos + 1);
+
+    return std::string(a_pCacheDirectory) + "/" + vcfName + "." + a_rSampleName + ".vbtcache";
+}
+
+bool CVariantCache::Load(const std::string& a_rCachePath,
+                         const std::string& a_rKey,
+                         std::vector<std::vector<CVariant>>& a_rVariantList,
+                         std::vector<std::vector<CVariant>>& a_rNotAssessedVariantList)
+{
+    if(a_rKey.empty())
+        return false;
+
+    int fd = open(a_rCachePath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* pMapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(pMapped == MAP_FAILED)
+        return false;
+
+    const char* pCursor = static_cast<const char*>(pMapped);
+    const char* pEnd = pCursor + fileStat.st_size;
+
+    bool bIsSuccess = true;
+    char magic[8];
+    uint32_t version;
+    std::string key;
+
+    if(!ReadPod(pCursor, pEnd, magic) || memcmp(magic, VARIANT_CACHE_MAGIC, sizeof(magic)) != 0)
+        bIsSuccess = false;
+    else if(!ReadPod(pCursor, pEnd, version) || version != VARIANT_CACHE_VERSION)
+        bIsSuccess = false;
+    else if(!ReadString(pCursor, pEnd, key) || key != a_rKey)
+        bIsSuccess = false;
+    else
+    {
+        std::vector<std::vector<CVariant>> variantList;
+        std::vector<std::vector<CVariant>> notAssessedVariantList;
+
+        if(ReadVariantList(pCursor, pEnd, variantList) && ReadVariantList(pCursor, pEnd, notAssessedVariantList))
+        {
+            a_rVariantList.swap(variantList);
+            a_rNotAssessedVariantList.swap(notAssessedVariantList);
+        }
+        else
+        {
+            std::cerr << "Variant cache is corrupted, it will be regenerated: " << a_rCachePath << std::endl;
+            bIsSuccess = false;
+        }
+    }
+
+    munmap(pMapped, fileStat.st_size);
+    return bIsSuccess;
+}
+
+bool CVariantCache::Save(const std::string& a_rCachePath,
+                         const std::string& a_rKey,
+                         const std::vector<std::vector<CVariant>>& a_rVariantList,
+                         const std::vector<std::vector<CVariant>>& a_rNotAssessedVariantList)
+{
+    if(a_rKey.empty())
+        return false;
+
+    std::string buffer;
+    buffer.append(VARIANT_CACHE_MAGIC, sizeof(VARIANT_CACHE_MAGIC));
+    WritePod(buffer, VARIANT_CACHE_VERSION);
+    WriteString(buffer, a_rKey);
+    WriteVariantList(buffer, a_rVariantList);
+    WriteVariantList(buffer, a_rNotAssessedVariantList);
+
+    //Write into a temporary file first so that an interrupted run never leaves a partial cache behind
+    std::string tmpPath = a_rCachePath + ".tmp";
+    FILE* pFile = fopen(tmpPath.c_str(), "wb");
+    if(pFile == NULL)
+    {
+        std::cerr << "Unable to create variant cache: " << a_rCachePath << std::endl;
+        return false;
+    }
+
+    bool bIsSuccess = fwrite(buffer.data(), 1, buffer.size(), pFile) == buffer.size();
+    bIsSuccess = (fclose(pFile) == 0) && bIsSuccess;
+
+    if(bIsSuccess)
+        bIsSuccess = rename(tmpPath.c_str(), a_rCachePath.c_str()) == 0;
+
+    if(!bIsSuccess)
+    {
+        std::cerr << "Unable to write variant cache: " << a_rCachePath << std::endl;
+        remove(tmpPath.c_str());
+    }
+
+    return bIsSuccess;
+}
+
+void CVariantCache::WriteVariantList(std::string& a_rBuffer, const std::vector<std::vector<CVariant>>& a_rVariantList)
+{
+    WritePod(a_rBuffer, static_cast<uint32_t>(a_rVariantList.size()));
+    for(const std::vector<CVariant>& chrList : a_rVariantList)
+    {
+        WritePod(a_rBuffer, static_cast<uint32_t>(chrList.size()));
+        for(const CVariant& variant : chrList)
+            WriteVariant(a_rBuffer, variant);
+    }
+}
+
+bool CVariantCache::ReadVariantList(const char*& a_rpCursor, const char* a_pEnd, std::vector<std::vector<CVariant>>& a_rVariantList)
+{
+    uint32_t chrCount;
+    if(!ReadPod(a_rpCursor, a_pEnd, chrCount))
+        return false;
+
+    a_rVariantList = std::vector<std::vector<CVariant>>(chrCount);
+    for(uint32_t k = 0; k < chrCount; k++)
+    {
+        uint32_t variantCount;
+        if(!ReadPod(a_rpCursor, a_pEnd, variantCount))
+            return false;
+
+        a_rVariantList[k] = std::vector<CVariant>(variantCount);
+        for(uint32_t m = 0; m < variantCount; m++)
+        {
+            if(!ReadVariant(a_rpCursor, a_pEnd, a_rVariantList[k][m]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void CVariantCache::WriteVariant(std::string& a_rBuffer, const CVariant& a_rVariant)
+{
+    WritePod(a_rBuffer, a_rVariant.m_nVcfId);
+    WritePod(a_rBuffer, a_rVariant.m_nChrId);
+    WritePod(a_rBuffer, a_rVariant.m_nId);
+    WritePod(a_rBuffer, a_rVariant.m_nAlleleCount);
+    WritePod(a_rBuffer, a_rVariant.m_nStartPos);
+    WritePod(a_rBuffer, a_rVariant.m_nEndPos);
+    WritePod(a_rBuffer, a_rVariant.m_genotype);
+    WritePod(a_rBuffer, a_rVariant.m_nZygotCount);
+    WritePod(a_rBuffer, a_rVariant.m_nOriginalPos);
+    WritePod(a_rBuffer, a_rVariant.m_fQuality);
+    WritePod(a_rBuffer, a_rVariant.m_fScore);
+    WritePod(a_rBuffer, a_rVariant.m_nFileOffset);
+    WritePod(a_rBuffer, static_cast<int>(a_rVariant.m_variantStatus));
+    WritePod(a_rBuffer, a_rVariant.m_bIsPhased);
+    WritePod(a_rBuffer, a_rVariant.m_bIsHeterozygous);
+    WritePod(a_rBuffer, a_rVariant.m_bIsFirstNucleotideTrimmed);
+    WritePod(a_rBuffer, a_rVariant.m_bIsNoCall);
+    WritePod(a_rBuffer, a_rVariant.m_bHaveMultipleTrimOption);
+    WritePod(a_rBuffer, a_rVariant.m_bIsFilterPASS);
+
+    for(int k = 0; k < 2; k++)
+    {
+        WriteString(a_rBuffer, a_rVariant.m_alleles[k].m_sequence);
+        WritePod(a_rBuffer, a_rVariant.m_alleles[k].m_nStartPos);
+        WritePod(a_rBuffer, a_rVariant.m_alleles[k].m_nEndPos);
+        WritePod(a_rBuffer, a_rVariant.m_alleles[k].m_bIsIgnored);
+        WritePod(a_rBuffer, a_rVariant.m_alleles[k].m_bIsTrimmed);
+    }
+
+    WriteString(a_rBuffer, a_rVariant.m_refSequence);
+    WritePod(a_rBuffer, static_cast<uint32_t>(a_rVariant.m_filterString.size()));
+    for(const std::string& filter : a_rVariant.m_filterString)
+        WriteString(a_rBuffer, filter);
+    WriteString(a_rBuffer, a_rVariant.m_variantIDfromVcf);
+    WriteString(a_rBuffer, a_rVariant.m_chrName);
+    WriteString(a_rBuffer, a_rVariant.m_allelesStr);
+}
+
+bool CVariantCache::ReadVariant(const char*& a_rpCursor, const char* a_pEnd, CVariant& a_rVariant)
+{
+    bool bIsSuccess = true;
+    int variantStatus = 0;
+
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nVcfId);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nChrId);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nId);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nAlleleCount);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nStartPos);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nEndPos);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_genotype);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nZygotCount);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nOriginalPos);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_fQuality);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_fScore);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_nFileOffset);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, variantStatus);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bIsPhased);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bIsHeterozygous);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bIsFirstNucleotideTrimmed);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bIsNoCall);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bHaveMultipleTrimOption);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_bIsFilterPASS);
+
+    for(int k = 0; k < 2 && bIsSuccess; k++)
+    {
+        bIsSuccess = bIsSuccess && ReadString(a_rpCursor, a_pEnd, a_rVariant.m_alleles[k].m_sequence);
+        bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_alleles[k].m_nStartPos);
+        bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_alleles[k].m_nEndPos);
+        bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_alleles[k].m_bIsIgnored);
+        bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, a_rVariant.m_alleles[k].m_bIsTrimmed);
+    }
+
+    uint32_t filterCount = 0;
+    bIsSuccess = bIsSuccess && ReadString(a_rpCursor, a_pEnd, a_rVariant.m_refSequence);
+    bIsSuccess = bIsSuccess && ReadPod(a_rpCursor, a_pEnd, filterCount);
+    if(bIsSuccess)
+        a_rVariant.m_filterString = std::vector<std::string>(filterCount);
+    for(uint32_t k = 0; k < filterCount && bIsSuccess; k++)
+        bIsSuccess = ReadString(a_rpCursor, a_pEnd, a_rVariant.m_filterString[k]);
+    bIsSuccess = bIsSuccess && ReadString(a_rpCursor, a_pEnd, a_rVariant.m_variantIDfromVcf);
+    bIsSuccess = bIsSuccess && ReadString(a_rpCursor, a_pEnd, a_rVariant.m_chrName);
+    bIsSuccess = bIsSuccess && ReadString(a_rpCursor, a_pEnd, a_rVariant.m_allelesStr);
+
+    a_rVariant.m_variantStatus = static_cast<EVariantMatch>(variantStatus);
+    return bIsSuccess;
+}
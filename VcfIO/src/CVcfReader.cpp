@@ -25,17 +25,73 @@
 
 #include <stdio.h>
 #include "CVcfReader.h"
+#include "CSimpleBEDParser.h"
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include "htslib/bgzf.h"
 
 CVcfReader::CVcfReader()
 {
     m_bIsOpen = false;
+    m_bIsBcf = false;
+    m_pInfoBuffer = NULL;
+    m_nInfoBufferSize = 0;
+    m_pInfoStringBuffer = NULL;
+    m_nInfoStringBufferSize = 0;
+    m_pGenotypeBuffer = NULL;
+    m_nGenotypeBufferSize = 0;
+    m_pFilterName = NULL;
+    m_nFilterKey = -1;
+    m_pScoreField = NULL;
+    m_nScoreColumn = -1;
+    m_nScoreType = BCF_HT_REAL;
+    m_pScoreBuffer = NULL;
+    m_nScoreBufferSize = 0;
+    m_bIsRegionMode = false;
+    m_pIndex = NULL;
+    m_pTabix = NULL;
+    m_pRegionItr = NULL;
+    m_nRegionIndex = 0;
+    m_lineBuffer.l = m_lineBuffer.m = 0;
+    m_lineBuffer.s = NULL;
+    m_pRecordStream = NULL;
+    m_bHasPendingLine = false;
+    m_nPendingLineOffset = -1;
+    m_nRecordOffset = -1;
 }
 
 CVcfReader::CVcfReader(const char * a_pFilename)
 {
     m_bIsOpen = false;
+    m_bIsBcf = false;
+    m_pInfoBuffer = NULL;
+    m_nInfoBufferSize = 0;
+    m_pInfoStringBuffer = NULL;
+    m_nInfoStringBufferSize = 0;
+    m_pGenotypeBuffer = NULL;
+    m_nGenotypeBufferSize = 0;
+    m_pFilterName = NULL;
+    m_nFilterKey = -1;
+    m_pScoreField = NULL;
+    m_nScoreColumn = -1;
+    m_nScoreType = BCF_HT_REAL;
+    m_pScoreBuffer = NULL;
+    m_nScoreBufferSize = 0;
+    m_bIsRegionMode = false;
+    m_pIndex = NULL;
+    m_pTabix = NULL;
+    m_pRegionItr = NULL;
+    m_nRegionIndex = 0;
+    m_lineBuffer.l = m_lineBuffer.m = 0;
+    m_lineBuffer.s = NULL;
+    m_pRecordStream = NULL;
+    m_bHasPendingLine = false;
+    m_nPendingLineOffset = -1;
+    m_nRecordOffset = -1;
     Open(a_pFilename);
 }
 
@@ -61,6 +117,10 @@ bool CVcfReader::Open(const char * a_pFilename)
         return false;
     }
     
+    //Detect the input format. BCF records are already binary encoded so we only unpack the blocks we need
+    m_bIsBcf = hts_get_format(m_pHtsFile)->format == bcf;
+    m_filename = std::string(a_pFilename);
+    
     // Read header
     m_pHeader = bcf_hdr_read(m_pHtsFile);
     if (m_pHeader == NULL)
@@ -78,11 +138,20 @@ bool CVcfReader::Open(const char * a_pFilename)
             m_contigs.push_back(contig);
             m_chrIndexMap[contig.name] = i;
         }
+        
+        //One info arena per contig. The outer vector is never resized afterwards so SInfo can safely point to its elements
+        m_aInfoArena = std::vector<std::vector<char>>(m_contigs.size());
     }
         
     m_pRecord  = bcf_init();
     assert(m_pRecord);
     
+    if(!OpenRecordStream())
+    {
+        fprintf(stderr, "ERROR: Cannot open the record stream of vcf: %s.\n", a_pFilename);
+        return false;
+    }
+    
     m_bIsOpen = true;
     return true;
 }
@@ -93,9 +162,40 @@ bool CVcfReader::Close()
     {
         bcf_hdr_destroy(m_pHeader);
         bcf_destroy(m_pRecord);
+        if(!m_bIsBcf && m_pRecordStream != NULL)
+            bgzf_close(m_pRecordStream);
         bcf_close(m_pHtsFile);
         m_bIsOpen = false;
     }
+    m_pRecordStream = NULL;
+    m_bHasPendingLine = false;
+    free(m_pInfoBuffer);
+    free(m_pInfoStringBuffer);
+    m_pInfoBuffer = NULL;
+    m_nInfoBufferSize = 0;
+    m_pInfoStringBuffer = NULL;
+    m_nInfoStringBufferSize = 0;
+    free(m_pGenotypeBuffer);
+    m_pGenotypeBuffer = NULL;
+    m_nGenotypeBufferSize = 0;
+    free(m_pScoreBuffer);
+    m_pScoreBuffer = NULL;
+    m_nScoreBufferSize = 0;
+    
+    if(m_pRegionItr != NULL)
+        hts_itr_destroy(m_pRegionItr);
+    if(m_pIndex != NULL)
+        hts_idx_destroy(m_pIndex);
+    if(m_pTabix != NULL)
+        tbx_destroy(m_pTabix);
+    free(m_lineBuffer.s);
+    m_pRegionItr = NULL;
+    m_pIndex = NULL;
+    m_pTabix = NULL;
+    m_lineBuffer.l = m_lineBuffer.m = 0;
+    m_lineBuffer.s = NULL;
+    m_bIsRegionMode = false;
+    m_regionQueries.clear();
     m_pHeader = NULL;
     m_pRecord = NULL;
     m_pHtsFile = NULL;
@@ -109,23 +209,30 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
     a_pVariant->Clear();
     a_pVariant->m_nVcfId = m_nVcfId;
     int* gt_arr = NULL;
-    int ngt_arr = 0;
 
     int samplenumber = GetNumberOfSamples();
     int zygotCount = 0;
     
     bcf_clear(m_pRecord);
     m_pRecord->d.m_allele = 0;
-    const int ok = bcf_read(m_pHtsFile, m_pHeader, m_pRecord);
-    bcf_unpack(m_pRecord, BCF_UN_ALL);
+    const int ok = ReadRecord();
+    
+    //Unpack shared fields up to FILTER (INFO only if it is requested). Genotypes are decoded on demand by bcf_get_genotypes
+    bcf_unpack(m_pRecord, a_rConfig.m_bIsReadINFO ? BCF_UN_SHR : BCF_UN_FLT);
     
     if (ok == 0)
     {
         a_pVariant->m_nId = a_nId;
         a_pVariant->m_chrName = m_pHeader->id[BCF_DT_CTG][m_pRecord->rid].key;
-        a_pVariant->m_nChrId = m_chrIndexMap[m_pHeader->id[BCF_DT_CTG][m_pRecord->rid].key];
+        a_pVariant->m_nChrId = m_pRecord->rid;
+        
+        //READ FILTER DATA (Filter name is resolved to header key once, records are compared by integer key)
+        if(m_pFilterName != a_rConfig.m_pFilterName)
+        {
+            m_pFilterName = a_rConfig.m_pFilterName;
+            m_nFilterKey = getFilterKey(a_rConfig.m_pFilterName);
+        }
         
-        //READ FILTER DATA
         bool isPassed = false;
         
         if(m_pRecord->d.n_flt == 0)
@@ -135,7 +242,7 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
         {
             a_pVariant->m_filterString.push_back(std::string(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key));
                 
-            if(0 == strcmp(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key, a_rConfig.m_pFilterName))
+            if(m_pRecord->d.flt[k] == m_nFilterKey)
                 isPassed = true;
         }
         a_pVariant->m_bIsFilterPASS = isPassed;
@@ -148,159 +255,444 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
         
         //READ INFO DATA
         if(true == a_rConfig.m_bIsReadINFO)
-        {
-            for(int k = 0; k < (int)m_infoNames.size(); k++)
-            {
-                bcf_info_t* pInfo = bcf_get_info(m_pHeader, m_pRecord, m_infoNames[k].c_str());
-                SInfoEntry infoEntry;
-            
-                if(pInfo == NULL)
-                    continue;
-                
-                infoEntry.n = 0;
-                infoEntry.key = m_infoNames[k];
-                if(pInfo->type == BCF_BT_INT8 || pInfo->type == BCF_BT_INT16 || pInfo->type == BCF_BT_INT32)
-                    infoEntry.type = BCF_HT_INT;
-                if(pInfo->type == BCF_BT_FLOAT)
-                    infoEntry.type = BCF_HT_REAL;
-                if(pInfo->type == BCF_BT_CHAR)
-                    infoEntry.type = BCF_HT_STR;
-                if(pInfo->type == BCF_BT_NULL)
-                    infoEntry.type = BCF_HT_FLAG;
-                
-                infoEntry.values = malloc(pInfo->vptr_len);
-                int isSuccessToStructure = bcf_get_info_values(m_pHeader, m_pRecord, m_infoNames[k].c_str(),
-                                                           (void**)(&infoEntry.values), &infoEntry.n, infoEntry.type);
-                
-                if(isSuccessToStructure <= 0)
-                    std::cerr << "BCF info failed while reading tag:" << m_infoNames[k] << std::endl;
-                else
-                    a_pVariant->m_info.m_infoArray.push_back(infoEntry);
-            }
-        }
+            ReadInfoColumns(a_pVariant);
+        
+        //READ ROC SCORE
+        if(true == a_rConfig.m_bIsRocEnabled)
+            a_pVariant->m_fScore = ReadScore(a_rConfig.m_pRocScoreField);
         
         //READ GENOTYPE DATA
         if(samplenumber != 0)
         {
-            bcf_get_genotypes(m_pHeader, m_pRecord, &gt_arr, &ngt_arr);
-            zygotCount = ngt_arr / samplenumber;
-            a_pVariant->m_nAlleleCount = zygotCount;
+            //Genotype buffer is reused between records, it is only reallocated by htslib when it needs to grow
+            int ngt_arr = bcf_get_genotypes(m_pHeader, m_pRecord, &m_pGenotypeBuffer, &m_nGenotypeBufferSize);
+            gt_arr = m_pGenotypeBuffer;
+            zygotCount = ngt_arr > 0 ? ngt_arr / samplenumber : 0;
+            
+            //Ploidy of the sample is the number of alleles before the vector_end padding (BCF subsetting keeps the ploidy of unselected samples)
+            while(zygotCount > 0 && gt_arr[zygotCount-1] == bcf_int32_vector_end)
+                zygotCount--;
+            
             if(zygotCount == 2)
                 a_pVariant->m_bIsPhased = bcf_gt_is_phased(gt_arr[0]) || bcf_gt_is_phased(gt_arr[1]);
             else if(zygotCount == 1)
                 a_pVariant->m_bIsPhased = bcf_gt_is_phased(gt_arr[0]);
         }
         
-        //READ SEQUENCE DATA AND FILL ALLELES
-        a_pVariant->m_refSequence = std::string(m_pRecord->d.allele[0]);
+        //Decoded allele indexes of the sample (-1 for missing alleles)
+        m_aGenotypeIndexes.resize(zygotCount);
+        for(int k = 0; k < zygotCount; k++)
+            m_aGenotypeIndexes[k] = bcf_gt_allele(gt_arr[k]);
         
-        for (int i = 0; i < zygotCount; ++i)
-        {
-            int index = bcf_gt_allele(gt_arr[i]) == -1 ? 0 : bcf_gt_allele(gt_arr[i]);
-            a_pVariant->m_alleles[i].m_sequence = m_pRecord->d.allele[index];
-            a_pVariant->m_alleles[i].m_nStartPos = m_pRecord->pos;
-            a_pVariant->m_alleles[i].m_nEndPos = static_cast<int>(m_pRecord->pos + a_pVariant->m_refSequence.length());
-        }
+        FillGenotypeColumns(a_pVariant, m_pRecord->d.allele, m_pRecord->n_allele, m_pRecord->pos, m_aGenotypeIndexes.data(), zygotCount, samplenumber != 0, a_rConfig);
+        
+        //Set original position
+        a_pVariant->m_nOriginalPos = m_pRecord->pos;
+        a_pVariant->m_nFileOffset = m_nRecordOffset;
+        
+        
+        return true;
+    }
+    else 
+    {
+        a_pVariant = 0;
+        return false;
+    }
+}
+
+bool CVcfReader::GetNextSharedRecord(SSharedRecord& a_rRecord, std::vector<SSampleGenotype>& a_rGenotypes, const SConfig& a_rConfig)
+{
+    int samplenumber = GetNumberOfSamples();
+    
+    bcf_clear(m_pRecord);
+    m_pRecord->d.m_allele = 0;
+    const int ok = ReadRecord();
+    
+    if (ok != 0)
+        return false;
+    
+    //Unpack shared fields up to FILTER (INFO only if it is requested). Genotypes of all selected samples are decoded once below
+    bcf_unpack(m_pRecord, a_rConfig.m_bIsReadINFO ? BCF_UN_SHR : BCF_UN_FLT);
+    
+    a_rRecord.m_nChrId = m_pRecord->rid;
+    a_rRecord.m_nPosition = static_cast<int>(m_pRecord->pos);
+    a_rRecord.m_fQuality = m_pRecord->qual;
+    a_rRecord.m_nFileOffset = m_nRecordOffset;
+    a_rRecord.m_variantID = std::string(m_pRecord->d.id);
+    a_rRecord.m_info.Clear();
+    
+    a_rRecord.m_alleles.clear();
+    for(int k = 0; k < m_pRecord->n_allele; k++)
+        a_rRecord.m_alleles.push_back(std::string(m_pRecord->d.allele[k]));
+    
+    //READ FILTER DATA
+    if(m_pFilterName != a_rConfig.m_pFilterName)
+    {
+        m_pFilterName = a_rConfig.m_pFilterName;
+        m_nFilterKey = getFilterKey(a_rConfig.m_pFilterName);
+    }
+    
+    a_rRecord.m_filterString.clear();
+    a_rRecord.m_bIsFilterPASS = m_pRecord->d.n_flt == 0;
+    for(int k = 0; k < m_pRecord->d.n_flt; k++)
+    {
+        a_rRecord.m_filterString.push_back(std::string(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key));
+        if(m_pRecord->d.flt[k] == m_nFilterKey)
+            a_rRecord.m_bIsFilterPASS = true;
+    }
+    
+    //INFO is decoded by ReadSharedRecordInfo only if the record is kept
+    
+    //READ GENOTYPE DATA OF ALL SAMPLES
+    a_rGenotypes.resize(samplenumber);
+    int ngt_arr = samplenumber == 0 ? 0 : bcf_get_genotypes(m_pHeader, m_pRecord, &m_pGenotypeBuffer, &m_nGenotypeBufferSize);
+    int maxPloidy = ngt_arr > 0 ? ngt_arr / samplenumber : 0;
+    
+    for(int sample = 0; sample < samplenumber; sample++)
+    {
+        const int* gt_arr = m_pGenotypeBuffer + sample * maxPloidy;
+        SSampleGenotype& rGenotype = a_rGenotypes[sample];
+        
+        //Samples with lower ploidy than the record (eg. haploid chrX call of a male) are padded with vector_end
+        int ploidy = 0;
+        while(ploidy < maxPloidy && gt_arr[ploidy] != bcf_int32_vector_end)
+            ploidy++;
         
-        //SET ZYGOSITY OF THE VARIANT (HOMOZYGOUS or HETEROZYGOUS)
-        if(zygotCount == 2)
+        rGenotype.m_nZygotCount = ploidy;
+        rGenotype.m_bIsPhased = false;
+        for(int k = 0; k < 2; k++)
         {
-            if(a_pVariant->m_alleles[0].m_sequence == a_pVariant->m_alleles[1].m_sequence)
-            {
-                a_pVariant->m_nAlleleCount = 1;
-                a_pVariant->m_bIsHeterozygous = false;
-            }
-            else
-            {
-                a_pVariant->m_nAlleleCount = 2;
-                a_pVariant->m_bIsHeterozygous = true;
-            }
+            rGenotype.m_aGenotype[k] = (k >= ploidy || bcf_gt_is_missing(gt_arr[k])) ? -1 : bcf_gt_allele(gt_arr[k]);
+            rGenotype.m_bIsPhased = rGenotype.m_bIsPhased || (k < ploidy && bcf_gt_is_phased(gt_arr[k]));
         }
-        else if(zygotCount == 1)
+    }
+    
+    return true;
+}
+
+void CVcfReader::ReadSharedRecordInfo(SSharedRecord& a_rRecord)
+{
+    //Stored once for all samples at the info arena of the chromosome
+    CVariant infoHolder;
+    ReadInfoColumns(&infoHolder);
+    a_rRecord.m_info = infoHolder.m_info;
+}
+
+void CVcfReader::FillSampleVariant(const SSharedRecord& a_rRecord, const SSampleGenotype& a_rGenotype, int a_nId, const SConfig& a_rConfig, CVariant* a_pVariant) const
+{
+    a_pVariant->Clear();
+    a_pVariant->m_nVcfId = m_nVcfId;
+    a_pVariant->m_nId = a_nId;
+    a_pVariant->m_chrName = m_pHeader->id[BCF_DT_CTG][a_rRecord.m_nChrId].key;
+    a_pVariant->m_nChrId = a_rRecord.m_nChrId;
+    a_pVariant->m_filterString = a_rRecord.m_filterString;
+    a_pVariant->m_bIsFilterPASS = a_rRecord.m_bIsFilterPASS;
+    a_pVariant->m_variantIDfromVcf = a_rRecord.m_variantID;
+    a_pVariant->m_fQuality = a_rRecord.m_fQuality;
+    a_pVariant->m_info = a_rRecord.m_info;
+    a_pVariant->m_bIsPhased = a_rGenotype.m_bIsPhased;
+    
+    std::vector<const char*> alleles(a_rRecord.m_alleles.size());
+    for(unsigned int k = 0; k < a_rRecord.m_alleles.size(); k++)
+        alleles[k] = a_rRecord.m_alleles[k].c_str();
+    
+    //Only haploid and diploid genotypes are kept by the shared record. Other ploidies are marked by the zygot count only
+    int zygotCount = a_rGenotype.m_nZygotCount;
+    if(zygotCount > 2)
+    {
+        a_pVariant->m_nZygotCount = zygotCount;
+        a_pVariant->m_nOriginalPos = a_rRecord.m_nPosition;
+        a_pVariant->m_nFileOffset = a_rRecord.m_nFileOffset;
+        return;
+    }
+    
+    FillGenotypeColumns(a_pVariant, alleles.data(), static_cast<int>(alleles.size()), a_rRecord.m_nPosition, a_rGenotype.m_aGenotype, zygotCount, true, a_rConfig);
+    
+    a_pVariant->m_nOriginalPos = a_rRecord.m_nPosition;
+    a_pVariant->m_nFileOffset = a_rRecord.m_nFileOffset;
+}
+
+void CVcfReader::FillGenotypeColumns(CVariant* a_pVariant,
+                                     const char* const* a_pAlleles,
+                                     int a_nAlleleCount,
+                                     int a_nPosition,
+                                     const int* a_pGenotype,
+                                     int a_nZygotCount,
+                                     bool a_bHasSamples,
+                                     const SConfig& a_rConfig) const
+{
+    int zygotCount = a_nZygotCount;
+    
+    if(a_bHasSamples)
+        a_pVariant->m_nAlleleCount = zygotCount;
+    
+    //READ SEQUENCE DATA AND FILL ALLELES
+    a_pVariant->m_refSequence = std::string(a_pAlleles[0]);
+    
+    for (int i = 0; i < zygotCount; ++i)
+    {
+        int index = a_pGenotype[i] == -1 ? 0 : a_pGenotype[i];
+        a_pVariant->m_alleles[i].m_sequence = a_pAlleles[index];
+        a_pVariant->m_alleles[i].m_nStartPos = a_nPosition;
+        a_pVariant->m_alleles[i].m_nEndPos = static_cast<int>(a_nPosition + a_pVariant->m_refSequence.length());
+    }
+    
+    //SET ZYGOSITY OF THE VARIANT (HOMOZYGOUS or HETEROZYGOUS)
+    if(zygotCount == 2)
+    {
+        if(a_pVariant->m_alleles[0].m_sequence == a_pVariant->m_alleles[1].m_sequence)
         {
             a_pVariant->m_nAlleleCount = 1;
             a_pVariant->m_bIsHeterozygous = false;
         }
-        
-        //TRIM ALL REDUNDANT NUCLEOTIDES FROM BEGINNING AND END TO ALLOW MORE REFERENCE OVERLAPING
-        if(a_rConfig.m_bIsRefOverlap)
+        else
+        {
+            a_pVariant->m_nAlleleCount = 2;
+            a_pVariant->m_bIsHeterozygous = true;
+        }
+    }
+    else if(zygotCount == 1)
+    {
+        a_pVariant->m_nAlleleCount = 1;
+        a_pVariant->m_bIsHeterozygous = false;
+    }
+    
+    //TRIM ALL REDUNDANT NUCLEOTIDES FROM BEGINNING AND END TO ALLOW MORE REFERENCE OVERLAPING
+    if(a_rConfig.m_bIsRefOverlap)
+    {
+        for (int i = 0; i < zygotCount; ++i)
         {
-            for (int i = 0; i < zygotCount; ++i)
+            int curGT = a_pGenotype[i];
+            
+            if(curGT == 0 || curGT == -1)
+                a_pVariant->m_alleles[i].m_bIsIgnored = true;
+            else if(HasMultipleTrimming(a_pVariant->m_alleles[i], a_pAlleles[0]))
+                a_pVariant->m_bHaveMultipleTrimOption = true;
+            else
+                a_pVariant->TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
+        }
+    }
+    
+    //TRIM FIRST NUCLEOTIDES IF THEY EXIST IN BOTH ALLELE AND IN REFERENCE
+    if(!a_rConfig.m_bIsRefOverlap && HasRedundantFirstNucleotide(a_pAlleles, a_nAlleleCount))
+    {
+        a_pVariant->m_bIsFirstNucleotideTrimmed = true;
+        for (int i = 0; i < zygotCount; ++i)
+        {
+            TrimAllele(a_pVariant->m_alleles[i]);
+        }
+    }
+    
+    //SET START AND END POSITION OF VARIANT
+    if(a_bHasSamples)
+    {
+        int maxEnd = -1;
+        int minStart = INT_MAX;
+        for(int k=0; k < a_pVariant->m_nAlleleCount; k++)
+        {
+            if(!a_pVariant->m_alleles[k].m_bIsIgnored)
             {
-                int curGT = bcf_gt_allele(gt_arr[i]);
-                
-                if(curGT == 0 || curGT == -1)
-                    a_pVariant->m_alleles[i].m_bIsIgnored = true;
-                else if(HasMultipleTrimming(a_pVariant->m_alleles[i]))
-                    a_pVariant->m_bHaveMultipleTrimOption = true;
-                else
-                    a_pVariant->TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
+                maxEnd = std::max(maxEnd, static_cast<int>(a_pVariant->m_alleles[k].m_nEndPos));
+                minStart = std::min(minStart, static_cast<int>(a_pVariant->m_alleles[k].m_nStartPos));
             }
         }
+        a_pVariant->m_nEndPos = maxEnd == -1 ? a_nPosition : maxEnd;
+        a_pVariant->m_nStartPos = minStart == INT_MAX ? a_nPosition : minStart;
+    }
+    else
+    {
+        a_pVariant->m_nStartPos = a_nPosition;
+        a_pVariant->m_nEndPos = a_nPosition + static_cast<int>(a_pVariant->m_refSequence.length());
+    }
+    
+    //FILL ORIGINAL ALLELE STR AND GENOTYPE FOR LATER ACCESS
+    a_pVariant->m_nZygotCount = zygotCount;
+    for(int k = 0; k < a_nAlleleCount; k++)
+    {
+        if(k != 0)
+            a_pVariant->m_allelesStr += ",";
+        a_pVariant->m_allelesStr += std::string(a_pAlleles[k]);
+    }
+    
+    //Set original genotypes
+    a_pVariant->m_bIsNoCall = true;
+    for(int k = 0; k < zygotCount; k++)
+    {
+        if(a_pGenotype[k] != -1)
+            a_pVariant->m_bIsNoCall = false;
         
-        //TRIM FIRST NUCLEOTIDES IF THEY EXIST IN BOTH ALLELE AND IN REFERENCE
-        if(!a_rConfig.m_bIsRefOverlap && HasRedundantFirstNucleotide())
+        a_pVariant->m_genotype[k] = a_pGenotype[k] == -1 ? 0 : a_pGenotype[k];
+    }
+}
+
+bool CVcfReader::SetRegions(const CSimpleBEDParser& a_rBedParser)
+{
+    if(!m_bIsOpen)
+        return false;
+    
+    //Check the index file first, htslib prints an error if it can not find the index
+    std::ifstream csiFile((m_filename + ".csi").c_str());
+    std::ifstream tbiFile((m_filename + ".tbi").c_str());
+    if(!csiFile.good() && !tbiFile.good())
+        return false;
+    
+    if(m_bIsBcf)
+        m_pIndex = bcf_index_load(m_filename.c_str());
+    else
+        m_pTabix = tbx_index_load(m_filename.c_str());
+    
+    if(m_pIndex == NULL && m_pTabix == NULL)
+        return false;
+    
+    //Queries are generated in the contig order of the header so records are returned in the same order as a full scan
+    m_regionQueries.clear();
+    for(unsigned int k = 0; k < m_contigs.size(); k++)
+    {
+        int tid = m_bIsBcf ? static_cast<int>(k) : tbx_name2id(m_pTabix, m_contigs[k].name.c_str());
+        if(tid < 0)
+            continue;
+        
+        for(const SBedRegion& region : a_rBedParser.GetRegions(m_contigs[k].name))
         {
-            a_pVariant->m_bIsFirstNucleotideTrimmed = true;
-            for (int i = 0; i < zygotCount; ++i)
-            {
-                TrimAllele(a_pVariant->m_alleles[i]);
-            }
+            SRegionQuery query;
+            query.m_nTid = tid;
+            query.m_nStartPos = region.m_nStartPos;
+            query.m_nEndPos = region.m_nEndPos;
+            m_regionQueries.push_back(query);
         }
+    }
+    
+    m_nRegionIndex = 0;
+    m_bIsRegionMode = true;
+    return true;
+}
+
+int CVcfReader::ReadRecord()
+{
+    //Offset of the record is only known if the file is read sequentially (region iterators may skip records)
+    m_nRecordOffset = -1;
+    
+    if(!m_bIsRegionMode)
+        return ReadStreamRecord();
+    
+    while(m_nRegionIndex < m_regionQueries.size())
+    {
+        const SRegionQuery& query = m_regionQueries[m_nRegionIndex];
         
-        //SET START AND END POSITION OF VARIANT
-        if(samplenumber != 0)
+        if(m_pRegionItr == NULL)
         {
-            int maxEnd = -1;
-            int minStart = INT_MAX;
-            for(int k=0; k < a_pVariant->m_nAlleleCount; k++)
+            if(m_bIsBcf)
+                m_pRegionItr = bcf_itr_queryi(m_pIndex, query.m_nTid, query.m_nStartPos, query.m_nEndPos);
+            else
+                m_pRegionItr = tbx_itr_queryi(m_pTabix, query.m_nTid, query.m_nStartPos, query.m_nEndPos);
+            
+            if(m_pRegionItr == NULL)
             {
-                if(!a_pVariant->m_alleles[k].m_bIsIgnored)
-                {
-                    maxEnd = std::max(maxEnd, static_cast<int>(a_pVariant->m_alleles[k].m_nEndPos));
-                    minStart = std::min(minStart, static_cast<int>(a_pVariant->m_alleles[k].m_nStartPos));
-                }
+                m_nRegionIndex++;
+                continue;
             }
-            a_pVariant->m_nEndPos = maxEnd == -1 ? m_pRecord->pos : maxEnd;
-            a_pVariant->m_nStartPos = minStart == INT_MAX ? m_pRecord->pos : minStart;
+        }
+        
+        int result;
+        if(m_bIsBcf)
+        {
+            result = bcf_itr_next(m_pHtsFile, m_pRegionItr, m_pRecord);
+            //Records read with iterator are not subset by htslib
+            if(result >= 0 && m_pHeader->keep_samples)
+                bcf_subset_format(m_pHeader, m_pRecord);
         }
         else
         {
-            a_pVariant->m_nStartPos = m_pRecord->pos;
-            a_pVariant->m_nEndPos = m_pRecord->pos + static_cast<int>(a_pVariant->m_refSequence.length());
+            result = tbx_itr_next(m_pHtsFile, m_pTabix, m_pRegionItr, &m_lineBuffer);
+            if(result >= 0)
+                result = vcf_parse(&m_lineBuffer, m_pHeader, m_pRecord);
         }
         
-        //FILL ORIGINAL ALLELE STR AND GENOTYPE FOR LATER ACCESS
-        a_pVariant->m_nZygotCount = zygotCount;
-        for(int k = 0; k < m_pRecord->n_allele; k++)
+        if(result < 0)
         {
-            if(k != 0)
-                a_pVariant->m_allelesStr += ",";
-            a_pVariant->m_allelesStr += std::string(m_pRecord->d.allele[k]);
+            hts_itr_destroy(m_pRegionItr);
+            m_pRegionItr = NULL;
+            m_nRegionIndex++;
+            continue;
         }
         
-        //Set original genotypes
-        a_pVariant->m_bIsNoCall = true;
-        for(int k = 0; k < zygotCount; k++)
+        //A record spanning two regions is already returned by the previous region query
+        if(m_nRegionIndex > 0
+           && m_regionQueries[m_nRegionIndex-1].m_nTid == query.m_nTid
+           && m_pRecord->pos < m_regionQueries[m_nRegionIndex-1].m_nEndPos)
+            continue;
+        
+        return 0;
+    }
+    
+    return -1;
+}
+
+void CVcfReader::ReadInfoColumns(CVariant* a_pVariant)
+{
+    std::vector<char>& arena = m_aInfoArena[m_pRecord->rid];
+    const unsigned int recordOffset = static_cast<unsigned int>(arena.size());
+    
+    for(int k = 0; k < (int)m_infoNames.size(); k++)
+    {
+        bcf_info_t* pInfo = bcf_get_info(m_pHeader, m_pRecord, m_infoNames[k].c_str());
+        
+        if(pInfo == NULL)
+            continue;
+        
+        SInfoEntry infoEntry;
+        infoEntry.m_nKeyIndex = k;
+        if(pInfo->type == BCF_BT_INT8 || pInfo->type == BCF_BT_INT16 || pInfo->type == BCF_BT_INT32)
+            infoEntry.m_nType = BCF_HT_INT;
+        else if(pInfo->type == BCF_BT_FLOAT)
+            infoEntry.m_nType = BCF_HT_REAL;
+        else if(pInfo->type == BCF_BT_CHAR)
+            infoEntry.m_nType = BCF_HT_STR;
+        else
+            infoEntry.m_nType = BCF_HT_FLAG;
+        
+        //Decode into the reusable buffer of the type, it only grows when a larger value is encountered
+        void** ppBuffer = infoEntry.m_nType == BCF_HT_STR ? &m_pInfoStringBuffer : &m_pInfoBuffer;
+        int* pBufferSize = infoEntry.m_nType == BCF_HT_STR ? &m_nInfoStringBufferSize : &m_nInfoBufferSize;
+        int valueCount = bcf_get_info_values(m_pHeader, m_pRecord, m_infoNames[k].c_str(), ppBuffer, pBufferSize, infoEntry.m_nType);
+        
+        if(valueCount <= 0)
         {
-            if(bcf_gt_allele(gt_arr[k]) != -1)
-                a_pVariant->m_bIsNoCall = false;
-            
-            a_pVariant->m_genotype[k] = bcf_gt_allele(gt_arr[k]) == -1 ? 0 : bcf_gt_allele(gt_arr[k]);
+            std::cerr << "BCF info failed while reading tag:" << m_infoNames[k] << std::endl;
+            continue;
         }
         
-        //Set original position
-        a_pVariant->m_nOriginalPos = m_pRecord->pos;
-        
+        int payloadSize;
+        if(infoEntry.m_nType == BCF_HT_FLAG)
+        {
+            infoEntry.m_nCount = 1;
+            payloadSize = 0;
+        }
+        else if(infoEntry.m_nType == BCF_HT_STR)
+        {
+            infoEntry.m_nCount = valueCount + 1;
+            payloadSize = valueCount + 1;
+        }
+        else
+        {
+            infoEntry.m_nCount = valueCount;
+            payloadSize = valueCount * 4;
+        }
+        infoEntry.m_nByteSize = (payloadSize + 3) & ~3;
         
-        //FREE BUFFERS
-        free(gt_arr);
-        return true;
+        const size_t entryOffset = arena.size();
+        arena.resize(entryOffset + sizeof(SInfoEntry) + infoEntry.m_nByteSize, 0);
+        memcpy(&arena[entryOffset], &infoEntry, sizeof(SInfoEntry));
+        if(payloadSize > 0)
+            memcpy(&arena[entryOffset + sizeof(SInfoEntry)], *ppBuffer, payloadSize);
     }
-    else 
+    
+    if(arena.size() > recordOffset)
     {
-        a_pVariant = 0;
-        return false;
+        a_pVariant->m_info.m_pArena = &arena;
+        a_pVariant->m_info.m_pKeys = &m_infoNames;
+        a_pVariant->m_info.m_nOffset = recordOffset;
+        a_pVariant->m_info.m_nLength = static_cast<unsigned int>(arena.size()) - recordOffset;
     }
 }
 
@@ -309,12 +701,31 @@ bool CVcfReader::SelectSample(std::string a_sampleName)
     int res = bcf_hdr_set_samples(m_pHeader, a_sampleName.c_str(), 0);
     
     if(res == 0)
+    {
+        m_selectedSample = a_sampleName;
         return true;
+    }
     else
         return false;
     
 }
 
+bool CVcfReader::SelectSamples(const std::vector<std::string>& a_rSampleNames)
+{
+    std::string sampleList;
+    for(unsigned int k = 0; k < a_rSampleNames.size(); k++)
+    {
+        if(k != 0)
+            sampleList += ",";
+        sampleList += a_rSampleNames[k];
+    }
+    
+    int res = bcf_hdr_set_samples(m_pHeader, sampleList.c_str(), 0);
+    
+    //Single sample header subset (CreateSampleHeader) is not used for multiple samples, so m_selectedSample is not set
+    return res == 0;
+}
+
 int CVcfReader::GetNumberOfSamples() const
 {
 
@@ -345,6 +756,76 @@ int CVcfReader::GetContigId(std::string a_name) const
     return -1;
 }
 
+float CVcfReader::ReadScore(const char* a_pScoreField)
+{
+    //Score field is resolved once, records only check the resolved column/tag
+    if(m_pScoreField != a_pScoreField)
+    {
+        m_pScoreField = a_pScoreField;
+        m_nScoreColumn = -1;
+        m_nScoreType = BCF_HT_REAL;
+        m_scoreTag.clear();
+        
+        //QUAL is read from the record itself [m_nScoreColumn = -1]
+        if(0 == strcmp(a_pScoreField, "QUAL"))
+            m_nScoreType = BCF_HT_REAL;
+        else if(0 == strncmp(a_pScoreField, "INFO/", 5))
+        {
+            m_nScoreColumn = BCF_HL_INFO;
+            m_scoreTag = std::string(a_pScoreField + 5);
+        }
+        else if(0 == strncmp(a_pScoreField, "FORMAT/", 7))
+        {
+            m_nScoreColumn = BCF_HL_FMT;
+            m_scoreTag = std::string(a_pScoreField + 7);
+        }
+        else
+        {
+            std::cerr << "Invalid score field " << a_pScoreField << ". Score field should be QUAL, INFO/<TAG> or FORMAT/<TAG>" << std::endl;
+            m_nScoreType = -1;
+        }
+        
+        if(m_nScoreColumn != -1)
+        {
+            int tagId = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, m_scoreTag.c_str());
+            if(tagId < 0 || !bcf_hdr_idinfo_exists(m_pHeader, m_nScoreColumn, tagId))
+            {
+                std::cerr << "Score field " << a_pScoreField << " is not defined in the header of " << m_filename << std::endl;
+                m_nScoreType = -1;
+            }
+            else
+                m_nScoreType = bcf_hdr_id2type(m_pHeader, m_nScoreColumn, tagId) == BCF_HT_INT ? BCF_HT_INT : BCF_HT_REAL;
+        }
+    }
+    
+    if(m_nScoreType == -1)
+        return NAN;
+    
+    if(m_nScoreColumn == -1)
+        return bcf_float_is_missing(m_pRecord->qual) ? NAN : m_pRecord->qual;
+    
+    int valueCount;
+    if(m_nScoreColumn == BCF_HL_INFO)
+        valueCount = bcf_get_info_values(m_pHeader, m_pRecord, m_scoreTag.c_str(), &m_pScoreBuffer, &m_nScoreBufferSize, m_nScoreType);
+    else
+        valueCount = bcf_get_format_values(m_pHeader, m_pRecord, m_scoreTag.c_str(), &m_pScoreBuffer, &m_nScoreBufferSize, m_nScoreType);
+    
+    //First value of the field (of the selected sample for FORMAT fields)
+    if(valueCount <= 0)
+        return NAN;
+    
+    if(m_nScoreType == BCF_HT_INT)
+    {
+        int32_t value = static_cast<int32_t*>(m_pScoreBuffer)[0];
+        return (value == bcf_int32_missing || value == bcf_int32_vector_end) ? NAN : static_cast<float>(value);
+    }
+    else
+    {
+        float value = static_cast<float*>(m_pScoreBuffer)[0];
+        return bcf_float_is_missing(value) || bcf_float_is_vector_end(value) ? NAN : value;
+    }
+}
+
 const char* CVcfReader::getFilterString(int a_nFilterKey)
 {
     return m_pHeader->id[BCF_DT_ID][a_nFilterKey].key;
@@ -361,17 +842,17 @@ int CVcfReader::getFilterKey(const char* a_pFilterValue)
     return -1;
 }
 
-void CVcfReader::TrimAllele(SAllele& a_rAllele)
+void CVcfReader::TrimAllele(SAllele& a_rAllele) const
 {
     a_rAllele.m_sequence = a_rAllele.m_sequence.substr(1, a_rAllele.m_sequence.length() - 1);
     a_rAllele.m_nStartPos += 1;
 }
 
-bool CVcfReader::HasRedundantFirstNucleotide() const
+bool CVcfReader::HasRedundantFirstNucleotide(const char* const* a_pAlleles, int a_nAlleleCount) const
 {
-    for(int k= 0; k < m_pRecord->n_allele; k++)
+    for(int k= 0; k < a_nAlleleCount; k++)
     {
-        if(m_pRecord->d.allele[0][0] != m_pRecord->d.allele[k][0])
+        if(a_pAlleles[0][0] != a_pAlleles[k][0])
             return false;
     }
     return true;
@@ -400,13 +881,13 @@ void CVcfReader::GetFilterInfo(std::vector<std::string> &a_rFilterNames, std::ve
     }
 }
 
-bool CVcfReader::HasMultipleTrimming(SAllele& a_rAllele)
+bool CVcfReader::HasMultipleTrimming(const SAllele& a_rAllele, const char* a_pRefSequence) const
 {
     if(a_rAllele.m_sequence == "*" || a_rAllele.m_sequence.length() < 2)
         return false;
     
     //Ref string
-    std::string refString = m_pRecord->d.allele[0];
+    std::string refString = a_pRefSequence;
     
     //We do not need to check insertion
     if(refString.length() < a_rAllele.m_sequence.length() || refString.length() < 2)
@@ -484,6 +965,116 @@ bcf1_t* CVcfReader::GetRecordPointer()
     return m_pRecord;
 }
 
+int CVcfReader::ReadStreamRecord()
+{
+    if(m_pRecordStream == NULL)
+        return -1;
+    
+    m_nRecordOffset = bgzf_tell(m_pRecordStream);
+    
+    if(m_bIsBcf)
+        return bcf_read(m_pHtsFile, m_pHeader, m_pRecord);
+    
+    //First record line is already read while skipping the header
+    if(m_bHasPendingLine)
+    {
+        m_bHasPendingLine = false;
+        m_nRecordOffset = m_nPendingLineOffset;
+    }
+    else if(bgzf_getline(m_pRecordStream, '\n', &m_lineBuffer) < 0)
+        return -1;
+    
+    return vcf_parse(&m_lineBuffer, m_pHeader, m_pRecord);
+}
+
+bool CVcfReader::OpenRecordStream()
+{
+    //BCF records are read from the bgzf stream of htslib directly
+    if(m_bIsBcf)
+    {
+        m_pRecordStream = m_pHtsFile->fp.bgzf;
+        return true;
+    }
+    
+    //htslib reads text vcf through a line buffer so the position of its stream is not the position of the record.
+    //Lines are read from a separate stream instead (as htslib does while building tabix index)
+    m_pRecordStream = bgzf_open(m_filename.c_str(), "r");
+    if(m_pRecordStream == NULL)
+        return false;
+    
+    while(true)
+    {
+        int64_t lineOffset = bgzf_tell(m_pRecordStream);
+        if(bgzf_getline(m_pRecordStream, '\n', &m_lineBuffer) < 0)
+            break;
+        
+        if(m_lineBuffer.l == 0 || m_lineBuffer.s[0] != '#')
+        {
+            m_bHasPendingLine = true;
+            m_nPendingLineOffset = lineOffset;
+            break;
+        }
+    }
+    
+    return true;
+}
+
+bool CVcfReader::ReadRecordAt(int64_t a_nFileOffset)
+{
+    if(!m_bIsOpen || m_bIsRegionMode || m_pRecordStream == NULL || a_nFileOffset < 0)
+        return false;
+    
+    bcf_clear(m_pRecord);
+    
+    //First record line of text vcf is already in the line buffer
+    if(m_bHasPendingLine)
+    {
+        m_bHasPendingLine = false;
+        if(a_nFileOffset == m_nPendingLineOffset)
+        {
+            m_nRecordOffset = m_nPendingLineOffset;
+            return vcf_parse(&m_lineBuffer, m_pHeader, m_pRecord) == 0;
+        }
+    }
+    
+    int64_t currentOffset = bgzf_tell(m_pRecordStream);
+    
+    if(a_nFileOffset != currentOffset)
+    {
+        //Records of the outputs are in file order. If the record is in the current block, skip forward without decompressing the block again
+        if((a_nFileOffset >> 16) == (currentOffset >> 16) && a_nFileOffset > currentOffset)
+        {
+            char skipBuffer[4096];
+            int64_t remaining = a_nFileOffset - currentOffset;
+            while(remaining > 0)
+            {
+                ssize_t readSize = bgzf_read(m_pRecordStream, skipBuffer, std::min(remaining, static_cast<int64_t>(sizeof(skipBuffer))));
+                if(readSize <= 0)
+                    return false;
+                remaining -= readSize;
+            }
+        }
+        else if(bgzf_seek(m_pRecordStream, a_nFileOffset, SEEK_SET) < 0)
+            return false;
+    }
+    
+    return ReadStreamRecord() == 0;
+}
+
+bcf_hdr_t* CVcfReader::CreateSampleHeader() const
+{
+    if(!m_bIsOpen)
+        return NULL;
+    
+    if(m_selectedSample.empty())
+        return bcf_hdr_dup(m_pHeader);
+    
+    //Header that contains all the definitions of the input and only the selected sample
+    char* pSampleName = const_cast<char*>(m_selectedSample.c_str());
+    int sampleIndex;
+    return bcf_hdr_subset(m_pHeader, 1, &pSampleName, &sampleIndex);
+}
+
 
 void CVcfReader::GetInfoNames(const std::string& a_rInfoColumns)
 {
@@ -24,20 +24,73 @@
  */
  
 #include "CVcfWriter.h"
+#include "htslib/tbx.h"
+#include "htslib/bgzf.h"
+#include "htslib/hfile.h"
+#include "Constants.h"
 #include <ctime>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
 
 CVcfWriter::CVcfWriter()
 {
     m_HEADER_GUARD = 0;
     m_nSampleCount = 0;
+    m_outputFormat = eVCF_TEXT;
+    m_nCompressionLevel = DEFAULT_COMPRESSION_LEVEL;
+    m_nThreadCount = 1;
+    m_nGenotypeKey = -1;
+    m_nDecisionKey = -1;
+    m_nMatchTypeKey = -1;
+    m_nMendelianDecisionKey = -1;
+}
+
+void CVcfWriter::SetOutputFormat(EVcfOutputFormat a_format, int a_nCompressionLevel, int a_nThreadCount)
+{
+    m_outputFormat = a_format;
+    m_nCompressionLevel = std::min(std::max(0, a_nCompressionLevel), 9);
+    m_nThreadCount = std::max(1, a_nThreadCount);
 }
 
 void CVcfWriter::CreateVcf(const char* a_pFileName)
 {
-    m_pHtsFile = hts_open(a_pFileName,"w");
+    m_fileName = std::string(a_pFileName);
+    std::string mode = "w";
+    
+    if(m_outputFormat == eVCF_BGZF)
+    {
+        m_fileName += ".gz";
+        mode += "z" + std::to_string(m_nCompressionLevel);
+    }
+    else if(m_outputFormat == eBCF)
+    {
+        //Replace .vcf extension with .bcf
+        if(m_fileName.size() > 4 && m_fileName.compare(m_fileName.size() - 4, 4, ".vcf") == 0)
+            m_fileName.replace(m_fileName.size() - 4, 4, ".bcf");
+        else
+            m_fileName += ".bcf";
+        mode += "b" + std::to_string(m_nCompressionLevel);
+    }
+    
+    m_pHtsFile = hts_open(m_fileName.c_str(), mode.c_str());
     m_pRecord  = bcf_init1();
+    
+    if(m_pHtsFile == NULL)
+    {
+        std::cerr << "Unable to create the output file " << m_fileName << std::endl;
+        return;
+    }
+    
+    //BGZF blocks are compressed by the htslib thread pool
+    if(m_outputFormat != eVCF_TEXT && m_nThreadCount > 1)
+        hts_set_threads(m_pHtsFile, m_nThreadCount);
+}
+
+const std::string& CVcfWriter::GetFileName() const
+{
+    return m_fileName;
 }
 
 void CVcfWriter::CloseVcf()
@@ -54,6 +107,21 @@ void CVcfWriter::CloseVcf()
     {
         std::cerr << "A problem occured with saving the VCF file." << std::endl;
     }
+    else if(m_outputFormat != eVCF_TEXT)
+        BuildIndex();
+}
+
+void CVcfWriter::BuildIndex()
+{
+    int ret;
+    
+    if(m_outputFormat == eBCF)
+        ret = bcf_index_build(m_fileName.c_str(), 14);
+    else
+        ret = tbx_index_build(m_fileName.c_str(), 0, &tbx_conf_vcf);
+    
+    if(ret != 0)
+        std::cerr << "Unable to build the index of " << m_fileName << std::endl;
 }
 
 void CVcfWriter::AddHeaderLine(const std::string& a_rLine)
@@ -85,6 +153,12 @@ void CVcfWriter::WriteHeaderToVcf()
         
         bcf_hdr_write(m_pHtsFile, m_pHeader);
         m_HEADER_GUARD = -1;
+        
+        //Header ids of the tags that are written to every record
+        m_nGenotypeKey = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, "GT");
+        m_nDecisionKey = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, "BD");
+        m_nMatchTypeKey = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, "BK");
+        m_nMendelianDecisionKey = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, "MD");
     }
     else
         std::cerr << "Invalid Operation. Header cannot be writtten into file" << std::endl;
@@ -104,229 +178,347 @@ void CVcfWriter::AddSampleName(const std::string &a_rSampleName)
 
 void CVcfWriter::AddRecord(const SVcfRecord& a_rVcfRecord)
 {
-    int success = 0;
-    
     if(m_HEADER_GUARD != -1)
     {
         std::cerr << "Invalid Operation. Cannot add record before submitting header" << std::endl;
         return;
     }
     
-    //Clear previous record
-    bcf_clear1(m_pRecord);
+    EncodeRecord(a_rVcfRecord, m_pRecord, m_aEncodeBuffer);
     
-    //Set chromosome name
-    m_pRecord->rid = bcf_hdr_name2id(m_pHeader, a_rVcfRecord.m_chrName.c_str());
-    
-    //Set start position
-    m_pRecord->pos = a_rVcfRecord.m_nPosition;
-    
-    //Set Quality
-    if(a_rVcfRecord.m_fQuality != 0.0f)
-        m_pRecord->qual = a_rVcfRecord.m_fQuality;
+    //Write record to created VCF File
+    if(bcf_write1(m_pHtsFile, m_pHeader, m_pRecord) < 0)
+        std::cerr << "Failed to write Record to the file: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+}
+
+void CVcfWriter::AddMendelianRecord(const SVcfRecord& a_rVcfRecord)
+{
+    if(m_HEADER_GUARD != -1)
+    {
+        std::cerr << "Invalid Operation. Cannot add record before submitting header" << std::endl;
+        return;
+    }
     
-    //Set alleles
-    success = bcf_update_alleles_str(m_pHeader, m_pRecord, a_rVcfRecord.m_alleles.c_str());
+    EncodeMendelianRecord(a_rVcfRecord, m_pRecord, m_aEncodeBuffer);
     
-    if(success < 0)
-        std::cerr << "Failed to update Alleles string for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    //Write record to created VCF File
+    if(bcf_write1(m_pHtsFile, m_pHeader, m_pRecord) < 0)
+        std::cerr << "Failed to write Record to the file: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+}
+
+void CVcfWriter::InitChunk(SVcfChunk& a_rChunk) const
+{
+    a_rChunk.m_pRecord = bcf_init1();
+}
+
+void CVcfWriter::AddRecord(const SVcfRecord& a_rVcfRecord, SVcfChunk& a_rChunk) const
+{
+    EncodeRecord(a_rVcfRecord, a_rChunk.m_pRecord, a_rChunk.m_aEncodeBuffer);
+    AppendToChunk(a_rChunk.m_pRecord, a_rChunk);
+}
+
+void CVcfWriter::AddMendelianRecord(const SVcfRecord& a_rVcfRecord, SVcfChunk& a_rChunk) const
+{
+    EncodeMendelianRecord(a_rVcfRecord, a_rChunk.m_pRecord, a_rChunk.m_aEncodeBuffer);
+    AppendToChunk(a_rChunk.m_pRecord, a_rChunk);
+}
+
+void CVcfWriter::AddRawRecord(bcf1_t* a_pRecord, SVcfChunk& a_rChunk) const
+{
+    AppendToChunk(a_pRecord, a_rChunk);
+}
+
+void CVcfWriter::AppendToChunk(bcf1_t* a_pRecord, SVcfChunk& a_rChunk) const
+{
+    //BCF records are kept encoded and written by htslib in WriteChunk
+    if(m_outputFormat == eBCF)
+    {
+        a_rChunk.m_aRecords.push_back(bcf_dup(a_pRecord));
+        return;
+    }
     
-    //Set filter
-    if(a_rVcfRecord.m_aFilterString.size() != 0)
+    if(vcf_format(m_pHeader, a_pRecord, &a_rChunk.m_text) < 0)
     {
-        int32_t* tmpi = new int[a_rVcfRecord.m_aFilterString.size()];
-        for(int k = 0; k < (int)a_rVcfRecord.m_aFilterString.size(); k++)
-            tmpi[k] = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, a_rVcfRecord.m_aFilterString[k].c_str());
-        success = bcf_update_filter(m_pHeader, m_pRecord, tmpi, static_cast<int>(a_rVcfRecord.m_aFilterString.size()));
-        
-        if(success < 0)
-            std::cerr << "Failed to update Filter for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+        std::cerr << "Failed to format Record of the chromosome " << bcf_hdr_id2name(m_pHeader, a_pRecord->rid) << " Position: " << a_pRecord->pos << std::endl;
+        return;
     }
     
-    //==Set Per Sample Data==
-
-    //1.Genotype Set (GT)
-    std::vector<int> genotypes;
-    for(int k = 0; k < (int)a_rVcfRecord.m_aSampleData.size(); k++)
+    //Compress completed BGZF blocks to keep the pending text small
+    if(m_outputFormat == eVCF_BGZF)
     {
-        for(int p = 0; p < a_rVcfRecord.m_aSampleData[k].m_nHaplotypeCount; p++)
-        {
-            if(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p] == -1 || a_rVcfRecord.m_aSampleData[k].m_bIsNoCallVariant)
-                genotypes.push_back(bcf_gt_missing);
-            else if(a_rVcfRecord.m_aSampleData[k].m_bIsPhased)
-                genotypes.push_back(bcf_gt_phased(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p]));
-            else
-                genotypes.push_back(bcf_gt_unphased(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p]));
-        }
-        
-        if(a_rVcfRecord.m_aSampleData[k].m_nHaplotypeCount == 1)
-            genotypes.push_back(bcf_int32_vector_end);
+        while(a_rChunk.m_text.l >= BGZF_BLOCK_SIZE)
+            CompressChunkBlock(a_rChunk);
     }
+}
 
+void CVcfWriter::CompressChunkBlock(SVcfChunk& a_rChunk) const
+{
+    size_t blockLength = std::min(a_rChunk.m_text.l, static_cast<size_t>(BGZF_BLOCK_SIZE));
+    size_t compressedLength = BGZF_MAX_BLOCK_SIZE;
+    size_t offset = a_rChunk.m_compressed.size();
+    
+    a_rChunk.m_compressed.resize(offset + BGZF_MAX_BLOCK_SIZE);
+    if(bgzf_compress(&a_rChunk.m_compressed[offset], &compressedLength, a_rChunk.m_text.s, blockLength, m_nCompressionLevel) != 0)
+        std::cerr << "Failed to compress the output block of " << m_fileName << std::endl;
+    a_rChunk.m_compressed.resize(offset + compressedLength);
+    
+    //Shift the remaining text to the beginning of the buffer
+    memmove(a_rChunk.m_text.s, a_rChunk.m_text.s + blockLength, a_rChunk.m_text.l - blockLength);
+    a_rChunk.m_text.l -= blockLength;
+}
+
+void CVcfWriter::FinalizeChunk(SVcfChunk& a_rChunk) const
+{
+    if(m_outputFormat == eVCF_BGZF)
+    {
+        while(a_rChunk.m_text.l > 0)
+            CompressChunkBlock(a_rChunk);
+    }
     
-    if(m_nSampleCount != (int)a_rVcfRecord.m_aSampleData.size())
+    //Scratch record and buffer are not needed anymore
+    if(a_rChunk.m_pRecord != NULL)
     {
-        genotypes.push_back(bcf_gt_missing);
-        genotypes.push_back(bcf_gt_missing);
+        bcf_destroy1(a_rChunk.m_pRecord);
+        a_rChunk.m_pRecord = NULL;
+    }
+    std::vector<int32_t>().swap(a_rChunk.m_aEncodeBuffer);
+}
+
+void CVcfWriter::WriteChunk(SVcfChunk& a_rChunk)
+{
+    if(m_HEADER_GUARD != -1)
+    {
+        std::cerr << "Invalid Operation. Cannot add record before submitting header" << std::endl;
+        return;
     }
     
+    bool bIsSuccess = true;
     
-    success = bcf_update_genotypes(m_pHeader, m_pRecord, static_cast<int*>(&genotypes[0]), bcf_hdr_nsamples(m_pHeader)*2);
-    if(success < 0)
-        std::cerr << "Failed to update Genotypes for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
-
-
-    if(a_rVcfRecord.m_aSampleData.size() > 1)
+    if(m_outputFormat == eBCF)
     {
-        //2.Decision Set (BD)
-        char* tmpstr[m_nSampleCount];
-        int k;
-        for(k = 0; k < (int)a_rVcfRecord.m_aSampleData.size(); k++)
-        {
-            tmpstr[k] = new char[a_rVcfRecord.m_aSampleData[k].m_decisionBD.size()];
-            strcpy(tmpstr[k], a_rVcfRecord.m_aSampleData[k].m_decisionBD.c_str());
-        }
-        
-        if((int)a_rVcfRecord.m_aSampleData.size() != m_nSampleCount)
-        {
-            tmpstr[k] = new char[1];
-            tmpstr[k][0] = bcf_str_missing;
-        }
-        success = bcf_update_format_string(m_pHeader, m_pRecord, "BD", (const char**)tmpstr, m_nSampleCount);
-
-        if(success < 0)
-            std::cerr << "Failed to update BD for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
-        
-        //3.Match Type Set (BK)
-        char* tmpstr2[m_nSampleCount];
-        for(k = 0; k < (int)a_rVcfRecord.m_aSampleData.size(); k++)
+        for(bcf1_t* pRecord : a_rChunk.m_aRecords)
         {
-            tmpstr2[k] = new char[a_rVcfRecord.m_aSampleData[k].m_matchTypeBK.size()];
-            strcpy(tmpstr2[k], a_rVcfRecord.m_aSampleData[k].m_matchTypeBK.c_str());
-        }
-        
-        if((int)a_rVcfRecord.m_aSampleData.size() != m_nSampleCount)
-        {
-            tmpstr2[k] = new char[1];
-            tmpstr2[k][0] = bcf_str_missing;
-        }
-        
-        success = bcf_update_format_string(m_pHeader, m_pRecord, "BK", (const char**)tmpstr2, m_nSampleCount);
-
-        if(success < 0)
-            std::cerr << "Failed to update BK for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
-
-        //Write record to created VCF File
-        success = bcf_write1(m_pHtsFile, m_pHeader, m_pRecord);
-        
-        if(success < 0)
-            std::cerr << "Failed to write Record to the file: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
-
-        //Clean Temporary strings we used
-        for(int k = 0; k < (int)a_rVcfRecord.m_aSampleData.size(); k++)
-        {
-            delete[] tmpstr[k];
-            delete[] tmpstr2[k];
+            bIsSuccess = bIsSuccess && bcf_write1(m_pHtsFile, m_pHeader, pRecord) >= 0;
+            bcf_destroy1(pRecord);
         }
     }
-    else
+    else if(m_outputFormat == eVCF_BGZF)
     {
-        bcf_write1(m_pHtsFile, m_pHeader, m_pRecord);
+        //Blocks are already compressed. Flush the blocks written through htslib before appending them
+        if(a_rChunk.m_compressed.size() > 0)
+            bIsSuccess = bgzf_flush(m_pHtsFile->fp.bgzf) == 0 && bgzf_raw_write(m_pHtsFile->fp.bgzf, a_rChunk.m_compressed.data(), a_rChunk.m_compressed.size()) == (ssize_t)a_rChunk.m_compressed.size();
+    }
+    else if(a_rChunk.m_text.l > 0)
+        bIsSuccess = hwrite(m_pHtsFile->fp.hfile, a_rChunk.m_text.s, a_rChunk.m_text.l) == (ssize_t)a_rChunk.m_text.l;
+    
+    if(!bIsSuccess)
+        std::cerr << "Failed to write records to the file: " << m_fileName << std::endl;
+    
+    //Release the chunk
+    free(a_rChunk.m_text.s);
+    a_rChunk.m_text.s = NULL;
+    a_rChunk.m_text.l = a_rChunk.m_text.m = 0;
+    std::string().swap(a_rChunk.m_compressed);
+    std::vector<bcf1_t*>().swap(a_rChunk.m_aRecords);
+    std::vector<int32_t>().swap(a_rChunk.m_aEncodeBuffer);
+    if(a_rChunk.m_pRecord != NULL)
+    {
+        bcf_destroy1(a_rChunk.m_pRecord);
+        a_rChunk.m_pRecord = NULL;
     }
- 
 }
 
-void CVcfWriter::AddMendelianRecord(const SVcfRecord& a_rVcfRecord)
+void CVcfWriter::EncodeRecord(const SVcfRecord& a_rVcfRecord, bcf1_t* a_pRecord, std::vector<int32_t>& a_rBuffer) const
 {
-    int success = 0;
+    EncodeSite(a_pRecord, a_rVcfRecord.m_chrName, a_rVcfRecord.m_nPosition, a_rVcfRecord.m_fQuality, a_rVcfRecord.m_alleles, a_rVcfRecord.m_aFilterString, a_rBuffer);
     
+    //==Set Per Sample Data==
+    int sampleCount = static_cast<int>(a_rVcfRecord.m_aSampleData.size());
+    EncodeGenotypes(a_pRecord, sampleCount > 0 ? &a_rVcfRecord.m_aSampleData[0] : NULL, sampleCount, a_rBuffer);
     
-    if(m_HEADER_GUARD != -1)
+    if(sampleCount > 1)
     {
-        std::cerr << "Invalid Operation. Cannot add record before submitting header" << std::endl;
-        return;
+        //Decision (BD) and Match Type (BK)
+        EncodeFormatString(a_pRecord, m_nDecisionKey, &SPerSampleData::m_decisionBD, a_rVcfRecord.m_aSampleData);
+        EncodeFormatString(a_pRecord, m_nMatchTypeKey, &SPerSampleData::m_matchTypeBK, a_rVcfRecord.m_aSampleData);
+    }
+}
+
+void CVcfWriter::EncodeMendelianRecord(const SVcfRecord& a_rVcfRecord, bcf1_t* a_pRecord, std::vector<int32_t>& a_rBuffer) const
+{
+    EncodeSite(a_pRecord, a_rVcfRecord.m_chrName, a_rVcfRecord.m_nPosition, a_rVcfRecord.m_fQuality, a_rVcfRecord.m_alleles, a_rVcfRecord.m_aFilterString, a_rBuffer);
+    
+    //Write Info tags to the vcf record
+    WriteInfoColumns(a_rVcfRecord.m_pInfo, a_pRecord);
+    
+    //Set Decision
+    if(m_nMendelianDecisionKey < 0)
+        std::cerr << "Failed to update MD INFO for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    else
+    {
+        bcf_enc_int1(&a_pRecord->shared, m_nMendelianDecisionKey);
+        bcf_enc_int1(&a_pRecord->shared, atoi(a_rVcfRecord.m_mendelianDecision.c_str()));
+        a_pRecord->n_info++;
     }
     
-    //Clear previous record
-    bcf_clear1(m_pRecord);
+    //==Set Per Sample Data==
+    int sampleCount = static_cast<int>(a_rVcfRecord.m_aSampleData.size());
+    EncodeGenotypes(a_pRecord, sampleCount > 0 ? &a_rVcfRecord.m_aSampleData[0] : NULL, sampleCount, a_rBuffer);
+}
+
+void CVcfWriter::AddRecord(const CVariant& a_rVariant, SVcfChunk& a_rChunk) const
+{
+    EncodeSite(a_rChunk.m_pRecord, a_rVariant.m_chrName, a_rVariant.m_nOriginalPos, 0.0f, a_rVariant.m_allelesStr, a_rVariant.m_filterString, a_rChunk.m_aEncodeBuffer);
+    
+    //Genotype of the single sample
+    SPerSampleData data;
+    data.m_bIsPhased = a_rVariant.m_bIsPhased;
+    data.m_nHaplotypeCount = a_rVariant.m_nZygotCount;
+    data.m_bIsNoCallVariant = a_rVariant.m_bIsNoCall;
+    for(int k = 0; k < data.m_nHaplotypeCount; k++)
+        data.m_aGenotype[k] = a_rVariant.m_genotype[k];
+    EncodeGenotypes(a_rChunk.m_pRecord, &data, 1, a_rChunk.m_aEncodeBuffer);
+    
+    AppendToChunk(a_rChunk.m_pRecord, a_rChunk);
+}
+
+void CVcfWriter::EncodeSite(bcf1_t* a_pRecord,
+                            const std::string& a_rChrName,
+                            int a_nPosition,
+                            float a_fQuality,
+                            const std::string& a_rAlleles,
+                            const std::vector<std::string>& a_rFilters,
+                            std::vector<int32_t>& a_rBuffer) const
+{
+    //Clear previous record. Shared and individual buffers of the record are kept and reused
+    bcf_clear1(a_pRecord);
+    a_pRecord->n_sample = bcf_hdr_nsamples(m_pHeader);
     
     //Set chromosome name
-    m_pRecord->rid = bcf_hdr_name2id(m_pHeader, a_rVcfRecord.m_chrName.c_str());
+    a_pRecord->rid = bcf_hdr_name2id(m_pHeader, a_rChrName.c_str());
     
     //Set start position
-    m_pRecord->pos = a_rVcfRecord.m_nPosition;
+    a_pRecord->pos = a_nPosition;
     
     //Set Quality
-    if(a_rVcfRecord.m_fQuality != 0.0f)
-        m_pRecord->qual = a_rVcfRecord.m_fQuality;
+    if(a_fQuality != 0.0f)
+        a_pRecord->qual = a_fQuality;
     
-    //Set alleles
-    success = bcf_update_alleles_str(m_pHeader, m_pRecord, a_rVcfRecord.m_alleles.c_str());
-    if(success < 0)
-        std::cerr << "Failed to update Alleles string for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
-    
-    //Write Info tags to the vcf record
-    WriteInfoColumns(a_rVcfRecord.m_pInfo);
+    //ID column is always missing
+    bcf_enc_size(&a_pRecord->shared, 0, BCF_BT_CHAR);
     
-    //Set Decision
-    int decArray = atoi(a_rVcfRecord.m_mendelianDecision.c_str());
-    success = bcf_update_info_int32(m_pHeader, m_pRecord, "MD", &decArray, 1);
-                                    
-    if(success < 0)
-        std::cerr << "Failed to update MD INFO for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    //Set alleles. Comma separated allele string is encoded without splitting into new strings
+    const char* pAlleles = a_rAlleles.c_str();
+    int alleleCount = 0;
+    while(true)
+    {
+        const char* pEnd = strchr(pAlleles, ',');
+        int length = pEnd == NULL ? static_cast<int>(strlen(pAlleles)) : static_cast<int>(pEnd - pAlleles);
+        
+        if(alleleCount == 0)
+            a_pRecord->rlen = length;
+        bcf_enc_vchar(&a_pRecord->shared, length, pAlleles);
+        alleleCount++;
+        
+        if(pEnd == NULL)
+            break;
+        pAlleles = pEnd + 1;
+    }
+    a_pRecord->n_allele = alleleCount;
     
     //Set filter
-    if(a_rVcfRecord.m_aFilterString.size() != 0)
+    int filterCount = static_cast<int>(a_rFilters.size());
+    a_rBuffer.resize(filterCount > 0 ? filterCount : 1);
+    for(int k = 0; k < filterCount; k++)
+    {
+        a_rBuffer[k] = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, a_rFilters[k].c_str());
+        if(a_rBuffer[k] < 0)
+            std::cerr << "Failed to update Filter for Record: " << "Chr" << a_rChrName << " Position: " << a_nPosition << std::endl;
+    }
+    bcf_enc_vint(&a_pRecord->shared, filterCount, a_rBuffer.data(), -1);
+}
+
+void CVcfWriter::EncodeGenotypes(bcf1_t* a_pRecord, const SPerSampleData* a_pSamples, int a_nSampleCount, std::vector<int32_t>& a_rBuffer) const
+{
+    if(m_nGenotypeKey < 0)
     {
-        int32_t* tmpi = new int[a_rVcfRecord.m_aFilterString.size()];
-        for(int k = 0; k < (int)a_rVcfRecord.m_aFilterString.size(); k++)
-            tmpi[k] = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, a_rVcfRecord.m_aFilterString[k].c_str());
-        bcf_update_filter(m_pHeader, m_pRecord, tmpi, static_cast<int>(a_rVcfRecord.m_aFilterString.size()));
+        std::cerr << "Failed to update Genotypes for Record. GT is not defined in the header" << std::endl;
+        return;
     }
     
-    //==Set Per Sample Data==
+    //Two values per sample. Samples which are not given are written as missing
+    int headerSampleCount = bcf_hdr_nsamples(m_pHeader);
+    a_rBuffer.resize(2 * (headerSampleCount > 0 ? headerSampleCount : 1));
     
-    //1.Genotype Set (GT)
-    int* genotypes = new int[bcf_hdr_nsamples(m_pHeader)*2];
-    int genotypeItr = 0;
-    for(int k = 0; k < (int)a_rVcfRecord.m_aSampleData.size(); k++)
+    for(int k = 0; k < headerSampleCount; k++)
     {
-        for(int p = 0; p < a_rVcfRecord.m_aSampleData[k].m_nHaplotypeCount; p++)
+        if(k >= a_nSampleCount)
         {
-            if(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p] == -1 || a_rVcfRecord.m_aSampleData[k].m_bIsNoCallVariant)
-                genotypes[genotypeItr++] = bcf_gt_missing;
-            else if(a_rVcfRecord.m_aSampleData[k].m_bIsPhased)
-                genotypes[genotypeItr++] = bcf_gt_phased(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p]);
-            else
-                genotypes[genotypeItr++] = bcf_gt_unphased(a_rVcfRecord.m_aSampleData[k].m_aGenotype[p]);
+            a_rBuffer[2*k] = bcf_gt_missing;
+            a_rBuffer[2*k+1] = bcf_gt_missing;
+            continue;
         }
         
-        if(a_rVcfRecord.m_aSampleData[k].m_nHaplotypeCount == 1)
-            genotypes[genotypeItr++] = bcf_int32_vector_end;
-    }
-
-    if(m_nSampleCount != (int)a_rVcfRecord.m_aSampleData.size())
-    {
-        for(int k = static_cast<int>(a_rVcfRecord.m_aSampleData.size()); k < m_nSampleCount; k++)
+        const SPerSampleData& rSample = a_pSamples[k];
+        for(int p = 0; p < 2; p++)
         {
-            genotypes[genotypeItr++] = bcf_gt_missing;
-            genotypes[genotypeItr++] = bcf_gt_missing;
+            if(p >= rSample.m_nHaplotypeCount)
+                a_rBuffer[2*k+p] = bcf_int32_vector_end;
+            else if(rSample.m_aGenotype[p] == -1 || rSample.m_bIsNoCallVariant)
+                a_rBuffer[2*k+p] = bcf_gt_missing;
+            else if(rSample.m_bIsPhased)
+                a_rBuffer[2*k+p] = bcf_gt_phased(rSample.m_aGenotype[p]);
+            else
+                a_rBuffer[2*k+p] = bcf_gt_unphased(rSample.m_aGenotype[p]);
         }
     }
     
-    success = bcf_update_genotypes(m_pHeader, m_pRecord, genotypes, genotypeItr);
-    if(success < 0)
-        std::cerr << "Failed to update Genotypes for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    bcf_enc_int1(&a_pRecord->indiv, m_nGenotypeKey);
+    bcf_enc_vint(&a_pRecord->indiv, 2 * headerSampleCount, a_rBuffer.data(), 2);
+    a_pRecord->n_fmt++;
+}
 
+void CVcfWriter::EncodeFormatString(bcf1_t* a_pRecord,
+                                    int a_nKey,
+                                    std::string SPerSampleData::* a_pField,
+                                    const std::vector<SPerSampleData>& a_rSamples) const
+{
+    if(a_nKey < 0)
+    {
+        std::cerr << "Failed to update FORMAT string for Record. Tag is not defined in the header" << std::endl;
+        return;
+    }
     
-    //Write record to created VCF File
-    success = bcf_write1(m_pHtsFile, m_pHeader, m_pRecord);
-    if(success < 0)
-        std::cerr << "Failed to write Record to the file: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    int headerSampleCount = bcf_hdr_nsamples(m_pHeader);
     
+    //Each sample occupies the length of the longest string. Samples which are not given are written as missing
+    int maxLength = 1;
+    for(const SPerSampleData& rSample : a_rSamples)
+        maxLength = std::max(maxLength, static_cast<int>((rSample.*a_pField).size()));
+    
+    bcf_enc_int1(&a_pRecord->indiv, a_nKey);
+    bcf_enc_size(&a_pRecord->indiv, maxLength, BCF_BT_CHAR);
+    
+    for(int k = 0; k < headerSampleCount; k++)
+    {
+        int length = 0;
+        if(k < static_cast<int>(a_rSamples.size()))
+        {
+            const std::string& rValue = a_rSamples[k].*a_pField;
+            length = static_cast<int>(rValue.size());
+            kputsn(rValue.c_str(), length, &a_pRecord->indiv);
+        }
+        else
+        {
+            kputc(bcf_str_missing, &a_pRecord->indiv);
+            length = 1;
+        }
+        
+        for(; length < maxLength; length++)
+            kputc('\0', &a_pRecord->indiv);
+    }
     
-    //Garbage Collection
-    delete[] genotypes;
+    a_pRecord->n_fmt++;
 }
 
 std::string CVcfWriter::GetTime()
@@ -355,23 +547,42 @@ void CVcfWriter::AddRawRecord(bcf1_t* a_rRecord)
     bcf_write1(m_pHtsFile, m_pHeader, a_rRecord);
 }
 
-void CVcfWriter::WriteInfoColumns(const SInfo* pInfo)
+void CVcfWriter::WriteInfoColumns(const SInfo* pInfo, bcf1_t* a_pRecord) const
 {
-    int success;
-    
-    if(pInfo == NULL)
+    if(pInfo == NULL || pInfo->IsEmpty())
         return;
-    else
+    
+    const char* pSlice = &(*pInfo->m_pArena)[pInfo->m_nOffset];
+    unsigned int offset = 0;
+    
+    while(offset < pInfo->m_nLength)
     {
-        for(int k = 0; k < (int)pInfo->m_infoArray.size(); k++)
+        SInfoEntry entry;
+        memcpy(&entry, pSlice + offset, sizeof(SInfoEntry));
+        offset += sizeof(SInfoEntry);
+        
+        const std::string& key = (*pInfo->m_pKeys)[entry.m_nKeyIndex];
+        const char* pValues = pSlice + offset;
+        offset += entry.m_nByteSize;
+        
+        int keyId = bcf_hdr_id2int(m_pHeader, BCF_DT_ID, key.c_str());
+        if(keyId < 0)
         {
-            success = bcf_update_info(m_pHeader, m_pRecord, pInfo->m_infoArray[k].key.c_str(), pInfo->m_infoArray[k].values, pInfo->m_infoArray[k].n, pInfo->m_infoArray[k].type);
-            if(success < 0)
-            {
-                std::cout << "INFO update is failed : " << pInfo->m_infoArray[k].key << std::endl;
-            }
+            std::cout << "INFO update is failed : " << key << std::endl;
+            continue;
         }
+        
+        //Values are encoded directly from the arena
+        bcf_enc_int1(&a_pRecord->shared, keyId);
+        if(entry.m_nType == BCF_HT_INT)
+            bcf_enc_vint(&a_pRecord->shared, entry.m_nCount, (int32_t*)pValues, -1);
+        else if(entry.m_nType == BCF_HT_REAL)
+            bcf_enc_vfloat(&a_pRecord->shared, entry.m_nCount, (float*)pValues);
+        else if(entry.m_nType == BCF_HT_STR && entry.m_nByteSize > 0)
+            bcf_enc_vchar(&a_pRecord->shared, static_cast<int>(strlen(pValues)), pValues);
+        else
+            bcf_enc_size(&a_pRecord->shared, 0, BCF_BT_NULL);
+        
+        a_pRecord->n_info++;
     }
 }
-
-
@@ -26,6 +26,7 @@
 #include <iostream>
 #include "CVcfAnalyzer.h"
 #include "CMendelianAnalyzer.h"
+#include "CMendelianBatchAnalyzer.h"
 #include "Constants.h"
 
 int main (int argc, char** argv)
@@ -44,6 +45,7 @@ int main (int argc, char** argv)
         std::cerr << "You have not entered an input.Please try either following:" << std::endl;
         std::cerr << "./vbt varcomp [PARAMETERS]" << std::endl;
         std::cerr << "./vbt mendelian [PARAMETERS]" << std::endl;
+        std::cerr << "./vbt mendelian-batch [PARAMETERS]" << std::endl;
         std::cerr << "Please type ./vbt <select_feature> --help for short info about the parameter structure." << std::endl;
         return -1;
     }
@@ -54,6 +56,12 @@ int main (int argc, char** argv)
         successNo = analyzer.run(argc, argv);
     }
     
+    else if(strcmp(argv[1], "mendelian-batch") == 0)
+    {
+        mendelian::CMendelianBatchAnalyzer analyzer;
+        successNo = analyzer.run(argc, argv);
+    }
+    
     else if(strcmp(argv[1], "varcomp") == 0)
     {
        duocomparison::CVcfAnalyzer analyzer;
@@ -65,6 +73,7 @@ int main (int argc, char** argv)
         std::cerr << "Invalid feature name.Please try either following:" << std::endl;
         std::cerr << "./vbt varcomp [PARAMETERS]" << std::endl;
         std::cerr << "./vbt mendelian [PARAMETERS]" << std::endl;
+        std::cerr << "./vbt mendelian-batch [PARAMETERS]" << std::endl;
         std::cerr << "Please type ./vbt <select_feature> --help for short info about the parameter structure." << std::endl;
         return -1;
     }
@@ -395,84 +395,123 @@ void CViolationValidator::SetInputFiles(const std::string& a_rTrioPathVBT,
 }
 
 
+void CViolationValidator::MergeContigIntervals(const std::string& a_rChrName,
+                                               const SSyncInterval* a_pMotherIntervals,
+                                               unsigned int a_nMotherCount,
+                                               const SSyncInterval* a_pFatherIntervals,
+                                               unsigned int a_nFatherCount)
+{
+    std::vector<SInterval>& mergedIntervals = m_intervalsListMap[a_rChrName];
+    
+    unsigned int motherItr = 0;
+    unsigned int fatherItr = 0;
+    
+    while(motherItr < a_nMotherCount && fatherItr < a_nFatherCount)
+    {
+        SInterval tmpInterval;
+        tmpInterval.m_nStart = a_pFatherIntervals[fatherItr].m_nStartPosition;
+        
+        //sync points are differ, iterate over mother and father until a common sync point will be found
+        while(motherItr < a_nMotherCount && fatherItr < a_nFatherCount && a_pMotherIntervals[motherItr].m_nEndPosition != a_pFatherIntervals[fatherItr].m_nEndPosition)
+        {
+            if(a_pMotherIntervals[motherItr].m_nEndPosition < a_pFatherIntervals[fatherItr].m_nEndPosition)
+                motherItr++;
+            else
+                fatherItr++;
+        }
+        
+        //Parsed until end of chromosome and no common sync point found, end searching
+        if(motherItr == a_nMotherCount || fatherItr == a_nFatherCount)
+            break;
+        
+        //Find a common sync point, add it to the merged interval list
+        tmpInterval.m_nEnd = a_pFatherIntervals[fatherItr].m_nEndPosition;
+        mergedIntervals.push_back(tmpInterval);
+        motherItr++;
+        fatherItr++;
+    }
+}
+
+bool CViolationValidator::ReadTextIntervals(const std::string& a_rFilePath,
+                                            std::vector<std::string>& a_rContigNames,
+                                            std::unordered_map<std::string, std::vector<SSyncInterval>>& a_rIntervals)
+{
+    std::ifstream intervalFile(a_rFilePath.c_str());
+    if(!intervalFile.good())
+        return false;
+    
+    std::string chrName;
+    SSyncInterval interval;
+    interval.m_nBaseFirstId = interval.m_nBaseLastId = -1;
+    interval.m_nCalledFirstId = interval.m_nCalledLastId = -1;
+    
+    while(intervalFile >> chrName >> interval.m_nStartPosition >> interval.m_nEndPosition)
+    {
+        if(a_rContigNames.empty() || a_rContigNames.back() != chrName)
+            a_rContigNames.push_back(chrName);
+        a_rIntervals[chrName].push_back(interval);
+    }
+    
+    return true;
+}
+
 void CViolationValidator::MergeIntervals(const std::string& a_rMotherChildIntervalsPath, const std::string& a_rFatherChildIntervalsPath)
 {
+    //Binary interval files are memory mapped and accessed per contig. Text files (--sync-point-text export) are parsed
+    CSyncIntervalFile motherFile;
+    CSyncIntervalFile fatherFile;
+    std::vector<std::string> motherContigs;
+    std::vector<std::string> fatherContigs;
+    std::unordered_map<std::string, std::vector<SSyncInterval>> motherTextIntervals;
+    std::unordered_map<std::string, std::vector<SSyncInterval>> fatherTextIntervals;
     
-    std::ifstream motherIntervalFile;
-    std::ifstream fatherIntervalFile;
+    bool bIsMotherBinary = CSyncIntervalFile::IsSyncIntervalFile(a_rMotherChildIntervalsPath);
+    bool bIsFatherBinary = CSyncIntervalFile::IsSyncIntervalFile(a_rFatherChildIntervalsPath);
     
-    motherIntervalFile.open(a_rMotherChildIntervalsPath.c_str());
-    fatherIntervalFile.open(a_rFatherChildIntervalsPath.c_str());
+    bool bIsSuccess = bIsMotherBinary ? motherFile.Open(a_rMotherChildIntervalsPath) : ReadTextIntervals(a_rMotherChildIntervalsPath, motherContigs, motherTextIntervals);
+    bIsSuccess = (bIsFatherBinary ? fatherFile.Open(a_rFatherChildIntervalsPath) : ReadTextIntervals(a_rFatherChildIntervalsPath, fatherContigs, fatherTextIntervals)) && bIsSuccess;
     
-    SInterval nextMotherInterval;
-    std::string chrMother;
-    SInterval nextFatherInterval;
-    std::string chrFather;
+    if(!bIsSuccess)
+    {
+        std::cerr << "[stderr] Unable to read interval files" << std::endl;
+        return;
+    }
     
-    //initialize father and mother chromosomes and first intervals
-    fatherIntervalFile >> chrFather >> nextFatherInterval.m_nStart >> nextFatherInterval.m_nEnd;
-    motherIntervalFile >> chrMother >> nextMotherInterval.m_nStart >> nextMotherInterval.m_nEnd;
+    if(bIsMotherBinary)
+        motherContigs = motherFile.GetContigNames();
     
-    while(!motherIntervalFile.eof() && !fatherIntervalFile.eof())
+    for(const std::string& chrName : motherContigs)
     {
-        if(chrFather == chrMother)
+        const SSyncInterval* pMotherIntervals = NULL;
+        const SSyncInterval* pFatherIntervals = NULL;
+        unsigned int motherCount = 0;
+        unsigned int fatherCount = 0;
+        
+        if(bIsMotherBinary)
+            motherFile.GetIntervals(chrName, pMotherIntervals, motherCount);
+        else
         {
-            if(nextFatherInterval.m_nEnd == nextMotherInterval.m_nEnd)
-            {
-                //father and mother sync point is equal, push it to the merged interval list
-                m_intervalsListMap[chrFather].push_back(nextFatherInterval);
-                fatherIntervalFile >> chrFather >> nextFatherInterval.m_nStart >> nextFatherInterval.m_nEnd;
-                motherIntervalFile >> chrMother >> nextMotherInterval.m_nStart >> nextMotherInterval.m_nEnd;
-            }
-            else
-            {
-                //sync points are differ, iterate over mother and father until a common sync point will be found
-                SInterval tmpInterval;
-                tmpInterval.m_nStart = nextFatherInterval.m_nStart;
-                
-                while(true)
-                {
-                    while(!motherIntervalFile.eof() && chrFather == chrMother && nextMotherInterval.m_nEnd < nextFatherInterval.m_nEnd)
-                        motherIntervalFile >> chrMother >> nextMotherInterval.m_nStart >> nextMotherInterval.m_nEnd;
-                    
-                    while(!fatherIntervalFile.eof() && chrFather == chrMother && nextFatherInterval.m_nEnd < nextMotherInterval.m_nEnd)
-                        fatherIntervalFile >> chrFather >> nextFatherInterval.m_nStart >> nextFatherInterval.m_nEnd;
-                    
-                    //Parsed until end of chromosome and no common sync point found, end searching
-                    if(chrFather != chrMother)
-                        break;
-                    
-                    //Find a common sync point, add it to the merged interval list
-                    if(nextFatherInterval.m_nEnd == nextMotherInterval.m_nEnd)
-                    {
-                        tmpInterval.m_nEnd = nextFatherInterval.m_nEnd;
-                        m_intervalsListMap[chrFather].push_back(tmpInterval);
-                        fatherIntervalFile >> chrFather >> nextFatherInterval.m_nStart >> nextFatherInterval.m_nEnd;
-                        motherIntervalFile >> chrMother >> nextMotherInterval.m_nStart >> nextMotherInterval.m_nEnd;
-                        break;
-                    }
-                }
-            }
+            pMotherIntervals = motherTextIntervals[chrName].data();
+            motherCount = static_cast<unsigned int>(motherTextIntervals[chrName].size());
         }
         
-        else if(std::stoi(chrFather) > std::stoi(chrMother))
+        //Contigs which are not in both files have no common sync point
+        if(bIsFatherBinary)
         {
-            //There are more sync points in mother side, iterate over them until we advance to the next chromosome
-            while(!motherIntervalFile.eof() && chrFather != chrMother)
-                motherIntervalFile >> chrMother >> nextMotherInterval.m_nStart >> nextMotherInterval.m_nEnd;
+            if(!fatherFile.GetIntervals(chrName, pFatherIntervals, fatherCount))
+                continue;
         }
-        
         else
         {
-            //There are more sync points in father side, iterate over them until we advance to the next chromosome
-            while(!fatherIntervalFile.eof() && chrFather != chrMother)
-                fatherIntervalFile >> chrFather >> nextFatherInterval.m_nStart >> nextFatherInterval.m_nEnd;
+            std::unordered_map<std::string, std::vector<SSyncInterval>>::const_iterator it = fatherTextIntervals.find(chrName);
+            if(it == fatherTextIntervals.end())
+                continue;
+            pFatherIntervals = it->second.data();
+            fatherCount = static_cast<unsigned int>(it->second.size());
         }
         
+        MergeContigIntervals(chrName, pMotherIntervals, motherCount, pFatherIntervals, fatherCount);
     }
-    
-    motherIntervalFile.close();
-    fatherIntervalFile.close();
 }
 
 
@@ -27,6 +27,7 @@
 #include "CIntervalValidator.h"
 #include "CVariantProvider.h"
 #include "CFastaParser.h"
+#include "CSyncIntervalFile.h"
 #include <unordered_map>
 
 namespace vbtvalidator
@@ -58,6 +59,18 @@ private:
     void SetIntervalFiles(const std::string& a_rMotherChildIntervalsPath, const std::string& a_rFatherChildIntervalsPath);
     void MergeIntervals(const std::string& a_rMotherChildIntervalsPath, const std::string& a_rFatherChildIntervalsPath);
     
+    //Merge the mother-child and father-child intervals of a single contig
+    void MergeContigIntervals(const std::string& a_rChrName,
+                              const SSyncInterval* a_pMotherIntervals,
+                              unsigned int a_nMotherCount,
+                              const SSyncInterval* a_pFatherIntervals,
+                              unsigned int a_nFatherCount);
+    
+    //Reads the intervals of a text sync point file (chromosome, start, end per line) per contig
+    bool ReadTextIntervals(const std::string& a_rFilePath,
+                           std::vector<std::string>& a_rContigNames,
+                           std::unordered_map<std::string, std::vector<SSyncInterval>>& a_rIntervals);
+    
     //Merged Interval List Map
     std::unordered_map<std::string, std::vector<SInterval>> m_intervalsListMap;
     